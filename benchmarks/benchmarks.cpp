@@ -0,0 +1,413 @@
+/**
+ * @file benchmarks.cpp
+ * @brief Micro and macro benchmarks for geometry evaluation, partitioning and export.
+ *
+ * Each benchmark repeats its workload until a minimum wall time has elapsed and reports
+ * the mean time per repetition. Results are printed as JSON (to stdout or to the file
+ * given with `--output`) so that runs of different releases can be compared by scripts.
+ *
+ * Usage: benchmarks [--quick] [--min-time seconds] [--output file.json]
+ */
+
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+#include "IndexedUnion.hpp"
+#include "CompiledGeometry.hpp"
+#include "csg_optimizer.h"
+#include "scene_loader.h"
+#include "quadtree_helper.h"
+#include "quadtree_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace implicit;
+
+/**
+ * @struct Result
+ * @brief Measurement of a single benchmark.
+ */
+struct Result
+{
+    std::string name;        ///< Benchmark group
+    std::string variant;     ///< Parameter description within the group
+    double seconds;          ///< Mean wall time per repetition
+    std::size_t iterations;  ///< Number of timed repetitions
+    double throughput;       ///< Work items per second
+    std::string unit;        ///< Unit of the work items
+};
+
+/// Prevents the compiler from discarding benchmark results
+volatile std::size_t sink = 0;
+
+/**
+ * @brief Times a workload until the minimum time has elapsed.
+ *
+ * The workload runs once untimed to warm up caches and allocators.
+ *
+ * @param workload Function performing one repetition
+ * @param minTime Minimum total wall time in seconds
+ * @param iterations Output number of timed repetitions
+ * @return Mean wall time per repetition in seconds
+ */
+double measure(const std::function<void()> &workload, double minTime, std::size_t &iterations)
+{
+    using Clock = std::chrono::steady_clock;
+
+    workload();
+
+    iterations = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+
+    do
+    {
+        workload();
+        ++iterations;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    while (elapsed < minTime);
+
+    return elapsed / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Generates uniformly distributed points in a square.
+ */
+void randomPoints(std::size_t n, double extent, std::vector<double> &x, std::vector<double> &y)
+{
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> distribution(-extent, extent);
+
+    x.resize(n);
+    y.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        x[i] = distribution(generator);
+        y[i] = distribution(generator);
+    }
+}
+
+/**
+ * @brief Creates the composite geometry used by the driver.
+ */
+ImplicitGeometryPtr createDriverGeometry()
+{
+    auto circle1 = std::make_shared<Circle>(0.0, 0.0, 1.06);
+    auto rectangle1 = std::make_shared<Rectangle>(-1.0, -1.0, 1.0, 1.0);
+    auto intersection = std::make_shared<Intersection>(circle1, rectangle1);
+    auto rectangle2 = std::make_shared<Rectangle>(-0.1, -1.5, 0.1, 1.5);
+    auto union1 = std::make_shared<Union>(intersection, rectangle2);
+    auto circle2 = std::make_shared<Circle>(0.0, 0.0, 0.65);
+    return std::make_shared<Difference>(union1, circle2);
+}
+
+/**
+ * @brief Creates a balanced union of circles placed on a ring.
+ */
+ImplicitGeometryPtr createWideGeometry(std::size_t width)
+{
+    std::vector<ImplicitGeometryPtr> nodes;
+    for (std::size_t i = 0; i < width; ++i)
+    {
+        double angle = 6.283185307179586 * static_cast<double>(i) / static_cast<double>(width);
+        nodes.push_back(std::make_shared<Circle>(std::cos(angle), std::sin(angle), 0.3));
+    }
+
+    while (nodes.size() > 1)
+    {
+        std::vector<ImplicitGeometryPtr> next;
+        for (std::size_t i = 0; i + 1 < nodes.size(); i += 2)
+            next.push_back(std::make_shared<Union>(nodes[i], nodes[i + 1]));
+        if (nodes.size() % 2)
+            next.push_back(nodes.back());
+        nodes.swap(next);
+    }
+
+    return nodes.front();
+}
+
+/**
+ * @brief Creates a left-deep chain of differences cutting nested slots out of a disk.
+ *
+ * Every slot is a thin vertical rectangle on the y-axis reaching to the top of the disk,
+ * and each one starts higher than the previous one, so it lies inside all earlier slots.
+ */
+ImplicitGeometryPtr createDeepGeometry(std::size_t depth)
+{
+    ImplicitGeometryPtr geometry = std::make_shared<Circle>(0.0, 0.0, 1.5);
+    for (std::size_t i = 1; i <= depth; ++i)
+    {
+        auto slot = std::make_shared<Rectangle>(-0.02, -1.5 + 0.1 * i, 0.02, 1.5);
+        geometry = std::make_shared<Difference>(geometry, slot);
+    }
+    return geometry;
+}
+
+/**
+ * @brief Creates randomly placed small circles, e.g. the pores of a microstructure.
+ */
+std::vector<ImplicitGeometryPtr> createPores(std::size_t count)
+{
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> position(-1.5, 1.5);
+    double radius = 0.5 / std::sqrt(static_cast<double>(count));
+
+    std::vector<ImplicitGeometryPtr> pores;
+    for (std::size_t i = 0; i < count; ++i)
+        pores.push_back(std::make_shared<Circle>(position(generator), position(generator), radius));
+    return pores;
+}
+
+/**
+ * @brief Measures scalar and batched point queries on a geometry.
+ */
+void benchmarkEvaluation(const std::string &name, const std::string &variant,
+                         const AbsImplicitGeometry &geometry, const std::vector<double> &x,
+                         const std::vector<double> &y, double minTime, std::vector<Result> &results)
+{
+    std::size_t n = x.size();
+    std::size_t iterations;
+
+    double seconds = measure([&]()
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            count += geometry.inside(x[i], y[i]);
+        sink = sink + count;
+    }, minTime, iterations);
+
+    results.push_back({ name, variant + ", inside", seconds, iterations, n / seconds, "points" });
+
+    seconds = measure([&]()
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; i += maxBatchSize)
+            count += geometry.insideBatch(x.data() + i, y.data() + i, std::min(maxBatchSize, n - i)) & 1;
+        sink = sink + count;
+    }, minTime, iterations);
+
+    results.push_back({ name, variant + ", insideBatch", seconds, iterations, n / seconds, "points" });
+}
+
+/**
+ * @brief Writes the results as a JSON document.
+ */
+void writeJson(std::ostream &out, const std::vector<Result> &results)
+{
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &result = results[i];
+        out << "    { \"name\": \"" << result.name << "\", \"variant\": \"" << result.variant
+            << "\", \"seconds\": " << result.seconds << ", \"iterations\": " << result.iterations
+            << ", \"throughput\": " << result.throughput << ", \"unit\": \"" << result.unit << "/s\" }"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    double minTime = 0.2;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--quick")
+            quick = true;
+        else if (argument == "--min-time" && i + 1 < argc)
+            minTime = std::atof(argv[++i]);
+        else if (argument == "--output" && i + 1 < argc)
+            output = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--min-time seconds] [--output file.json]\n";
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    std::vector<double> x, y;
+    randomPoints(quick ? 1 << 14 : 1 << 18, 2.0, x, y);
+
+    // Primitive throughput
+    Circle circle(0.1, -0.2, 1.2);
+    Rectangle rectangle(-0.7, -1.1, 0.9, 0.8);
+
+    benchmarkEvaluation("primitive", "Circle", circle, x, y, minTime, results);
+    benchmarkEvaluation("primitive", "Rectangle", rectangle, x, y, minTime, results);
+
+    // CSG scaling with tree width and depth, interpreted, optimized and compiled
+    for (std::size_t size : { 2, 8, 32 })
+    {
+        auto wide = createWideGeometry(size);
+        CompiledGeometry compiledWide(wide);
+        benchmarkEvaluation("csg_width", "width " + std::to_string(size), *wide, x, y, minTime, results);
+        benchmarkEvaluation("csg_width", "width " + std::to_string(size) + ", compiled", compiledWide, x, y,
+                            minTime, results);
+        benchmarkEvaluation("csg_width", "width " + std::to_string(size) + ", optimized",
+                            *optimizeGeometry(wide), x, y, minTime, results);
+
+        auto deep = createDeepGeometry(size);
+        CompiledGeometry compiledDeep(deep);
+        benchmarkEvaluation("csg_depth", "depth " + std::to_string(size), *deep, x, y, minTime, results);
+        benchmarkEvaluation("csg_depth", "depth " + std::to_string(size) + ", compiled", compiledDeep, x, y,
+                            minTime, results);
+        benchmarkEvaluation("csg_depth", "depth " + std::to_string(size) + ", optimized",
+                            *optimizeGeometry(deep), x, y, minTime, results);
+    }
+
+    // Unions of many primitives, with and without the grid index
+    std::vector<double> xPores(x.begin(), x.begin() + (1 << 12)), yPores(y.begin(), y.begin() + (1 << 12));
+    for (std::size_t count : { 1000, 10000 })
+    {
+        auto pores = createPores(count);
+        NaryUnion plain(pores);
+        IndexedUnion indexed(pores);
+
+        benchmarkEvaluation("bulk_union", std::to_string(count) + " circles", plain, xPores, yPores, minTime, results);
+        benchmarkEvaluation("bulk_union", std::to_string(count) + " circles, indexed", indexed, xPores, yPores,
+                            minTime, results);
+
+        std::size_t iterations, leaves = 0;
+        double seconds = measure([&]()
+        {
+            detail::QuadTreeNode root({ Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } }, 0);
+            root.partition(indexed, 9);
+            leaves = root.getLeafCells().first.size();
+        }, minTime, iterations);
+
+        results.push_back({ "bulk_union", std::to_string(count) + " circles, indexed, partition depth 9", seconds,
+                            iterations, leaves / seconds, "leaves" });
+    }
+
+    // Parsing of a text scene with a union chain of circles
+    {
+        std::size_t count = quick ? 100000 : 1000000;
+        std::string scene = "circle 0 0 0.01\n";
+        for (std::size_t i = 1; i < count; ++i)
+            scene += "circle " + std::to_string(x[i % x.size()]) + " " + std::to_string(y[i % y.size()]) + " 0.01 union\n";
+
+        std::size_t iterations;
+        double seconds = measure([&]()
+        {
+            sink = sink + parseScene(scene)->instructions().size();
+        }, minTime, iterations);
+
+        results.push_back({ "scene", "parse " + std::to_string(count) + " circles", seconds, iterations,
+                            count / seconds, "primitives" });
+    }
+
+    // Partitioning of the driver geometry
+    auto geometry = createDriverGeometry();
+    CompiledGeometry compiledGeometry(geometry);
+    Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+    int maxDepth = quick ? 10 : 14;
+    for (int depth = 6; depth <= maxDepth; depth += 2)
+    {
+        std::size_t iterations, leaves = 0;
+        double seconds = measure([&]()
+        {
+            detail::QuadTreeNode root(boundingBox, 0);
+            root.partition(compiledGeometry, depth);
+            leaves = root.getLeafCells().first.size();
+        }, minTime, iterations);
+
+        results.push_back({ "partition", "depth " + std::to_string(depth), seconds, iterations,
+                            leaves / seconds, "leaves" });
+
+        PartitionOptions singleOptions;
+        singleOptions.singlePrecision = true;
+        seconds = measure([&]()
+        {
+            detail::QuadTreeNode root(boundingBox, 0);
+            root.partition(compiledGeometry, depth, singleOptions);
+            leaves = root.getLeafCells().first.size();
+        }, minTime, iterations);
+
+        results.push_back({ "partition", "depth " + std::to_string(depth) + ", single precision", seconds,
+                            iterations, leaves / seconds, "leaves" });
+    }
+
+    // VTK export bandwidth
+    detail::QuadTreeNode root(boundingBox, 0);
+    root.partition(compiledGeometry, quick ? 9 : 12);
+    auto leaves = root.getLeafCells();
+
+    const std::string filename = "benchmark_export.vtk";
+    for (auto format : { VtkFormat::Ascii, VtkFormat::Binary })
+    {
+        std::size_t iterations;
+        double seconds = measure([&]()
+        {
+            if (format == VtkFormat::Binary)
+                detail::writeCellsToBinaryVtkFile(leaves, filename);
+            else
+                detail::writeCellsToVtkFile(leaves, filename);
+        }, minTime, iterations);
+
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        double bytes = static_cast<double>(file.tellg());
+
+        results.push_back({ "export", format == VtkFormat::Binary ? "binary" : "ascii", seconds, iterations,
+                            bytes / seconds, "bytes" });
+    }
+
+    // Compact quadtree file: writing, and mapping plus one pass over the leaves
+    {
+        detail::LinearQuadTree tree(boundingBox);
+        tree.partition(compiledGeometry, quick ? 9 : 12);
+
+        const std::string treeFilename = "benchmark_export.qtree";
+        std::size_t iterations;
+        double seconds = measure([&]() { detail::writeQuadTreeFile(tree, treeFilename); }, minTime, iterations);
+
+        results.push_back({ "export", "quadtree file", seconds, iterations, tree.size() / seconds, "leaves" });
+
+        seconds = measure([&]()
+        {
+            detail::MappedQuadTree mapped(treeFilename);
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < mapped.size(); ++i)
+                sum += mapped.level(i);
+            sink = sink + sum;
+        }, minTime, iterations);
+
+        results.push_back({ "export", "quadtree file, reload", seconds, iterations, tree.size() / seconds, "leaves" });
+        std::remove(treeFilename.c_str());
+    }
+    std::remove(filename.c_str());
+
+    if (output.empty())
+    {
+        writeJson(std::cout, results);
+    }
+    else
+    {
+        std::ofstream file(output);
+        writeJson(file, results);
+    }
+
+    return 0;
+}
@@ -4,6 +4,12 @@
  *
  * Demonstrates the use of basic CSG operations (union, intersection, difference)
  * and adaptive spatial subdivision using a quadtree. Outputs result as VTK.
+ *
+ * Usage: main [scene file [max depth [output file]]]
+ *
+ * Without a scene file, the built-in demo geometry is used. Scene files are text or
+ * binary scenes as described in scene_loader.h; the quadtree domain is then the
+ * bounding box of the scene with a small margin.
  */
 
 #include "Circle.hpp"
@@ -11,10 +17,19 @@
 #include "Intersection.hpp"
 #include "Union.hpp"
 #include "Difference.hpp"
+#include "CompiledGeometry.hpp"
 #include "quadtree.h"
+#include "scene_loader.h"
+#include "bounding_box_helper.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <chrono>
+#include <exception>
+#include <string>
 
 /**
  * @brief ASCII visualization of the implicit geometry in terminal.
@@ -47,10 +62,11 @@ void visualize(const implicit::ImplicitGeometryPtr object)
     }
 }
 
-int main()
+/**
+ * @brief Builds the demo geometry: (circle ∩ rectangle + bar) \ inner circle.
+ */
+implicit::ImplicitGeometryPtr createDemoGeometry()
 {
-    auto start_time = std::chrono::high_resolution_clock::now();
-
     // Define basic geometries
     auto circle1 = std::make_shared<implicit::Circle>(0.0, 0.0, 1.06);
     auto rectangle1 = std::make_shared<implicit::Rectangle>(-1.0, -1.0, 1.0, 1.0);
@@ -62,10 +78,56 @@ int main()
     auto circle2 = std::make_shared<implicit::Circle>(0.0, 0.0, 0.65);
 
     // Final composite geometry using CSG: (circle ∩ rectangle + bar) \ inner circle
-    auto geometry = std::make_shared<implicit::Difference>(union1, circle2);
+    return std::make_shared<implicit::Difference>(union1, circle2);
+}
+
+/**
+ * @brief Prints the command line syntax to the error stream.
+ */
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [scene file [max depth [output file]]]" << std::endl;
+}
+
+/**
+ * @brief Parses a non-negative depth, rejecting trailing characters.
+ *
+ * @param text Command line argument
+ * @param depth Output depth, only set on success
+ * @return true if the whole argument is a non-negative integer
+ */
+bool parseDepth(const char *text, int &depth)
+{
+    const char *end = text + std::strlen(text);
+    int value = 0;
+    auto [next, error] = std::from_chars(text, end, value);
+    if (error != std::errc() || next != end || next == text || value < 0)
+        return false;
+    depth = value;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 4)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    int maxDepth = 7;
+    if (argc > 2 && !parseDepth(argv[2], maxDepth))
+    {
+        std::cerr << "Invalid max depth: " << argv[2] << " (expected a non-negative integer)" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string filename = argc > 3 ? argv[3] : "quadtree.vtk";
 
-    // Optional: ASCII visualization
-    visualize(geometry);
+    std::shared_ptr<implicit::CompiledGeometry> compiledGeometry;
 
     // Define the bounding box for the quadtree
     implicit::Cell2D boundingBox {
@@ -73,8 +135,61 @@ int main()
             implicit::Bounds { -1.58, 1.58 }
     };
 
+    if (argc > 1)
+    {
+        try
+        {
+            compiledGeometry = implicit::loadScene(argv[1]);
+        }
+        catch (const std::exception &error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+
+        // Domain of the scene with a margin of 5% of its larger extent
+        boundingBox = compiledGeometry->boundingBox();
+
+        bool finite = std::all_of(boundingBox.begin(), boundingBox.end(), [](const implicit::Bounds &bounds)
+        {
+            return std::isfinite(bounds[0]) && std::isfinite(bounds[1]);
+        });
+
+        if (implicit::detail::isEmptyBox(boundingBox) || !finite ||
+            (boundingBox[0][0] == boundingBox[0][1] && boundingBox[1][0] == boundingBox[1][1]))
+        {
+            std::cerr << "Scene " << argv[1] << " has no finite, non-empty bounding box to partition" << std::endl;
+            return 1;
+        }
+
+        double margin = 0.05 * std::max(boundingBox[0][1] - boundingBox[0][0], boundingBox[1][1] - boundingBox[1][0]);
+        for (auto &bounds : boundingBox)
+        {
+            bounds[0] -= margin;
+            bounds[1] += margin;
+        }
+    }
+    else
+    {
+        auto geometry = createDemoGeometry();
+
+        // Optional: ASCII visualization
+        visualize(geometry);
+
+        // Compile the CSG tree into a flat program for faster evaluation
+        compiledGeometry = std::make_shared<implicit::CompiledGeometry>(geometry);
+    }
+
     // Generate adaptive quadtree and write to VTK file
-    implicit::generateQuadTree(*geometry, boundingBox, 7, "quadtree.vtk");
+    try
+    {
+        implicit::generateQuadTree(*compiledGeometry, boundingBox, maxDepth, filename);
+    }
+    catch (const std::exception &error)
+    {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
 
     // Measure and report execution time
     auto end_time = std::chrono::high_resolution_clock::now();
@@ -5,9 +5,21 @@
  * @brief Defines the abstract base class for all 2D implicit geometries.
  */
 
+#include "Cell2D.hpp"
+#include "stats_helper.h"
+
+#include <cstddef>
+#include <cstdint>
+
 namespace implicit
 {
 
+/// Bit mask holding one inside flag per point of a batch (bit i belongs to point i)
+using PointMask = std::uint64_t;
+
+/// Maximum number of points that can be classified by a single batch query
+constexpr std::size_t maxBatchSize = 64;
+
 /**
  * @class AbsImplicitGeometry
  * @brief Abstract base class for representing implicit 2D geometries.
@@ -32,6 +44,79 @@ public:
      * @return true if the point is inside the geometry, false otherwise
      */
     virtual bool inside(double x, double y) const = 0;
+
+    /**
+     * @brief Checks a batch of points against the geometry in a single call.
+     *
+     * The default implementation calls `inside` for every point. Derived classes
+     * override it with vectorized kernels so that one virtual dispatch covers
+     * the whole batch.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside the geometry
+     */
+    virtual PointMask insideBatch(const double *x, const double *y, std::size_t n) const;
+
+    /**
+     * @brief Checks a batch of single precision points against the geometry.
+     *
+     * Single precision doubles the number of vector lanes, but the geometry parameters are
+     * rounded to float as well, so points closer to the boundary than the float resolution
+     * of their coordinates may be classified differently than in double precision. The
+     * default implementation converts the points and calls the double precision overload.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside the geometry
+     */
+    virtual PointMask insideBatch(const float *x, const float *y, std::size_t n) const;
+
+    /**
+     * @brief Classifies a whole cell as inside, outside or cut by the boundary.
+     *
+     * The result must be conservative: a cell containing points on both sides of the
+     * boundary must never be reported as Inside or Outside. The default implementation
+     * has no knowledge about the geometry and always returns Cut.
+     *
+     * @param cell Cell to classify
+     * @return Classification of the cell
+     */
+    virtual CellClassification classify(Cell2D cell) const;
+
+    /**
+     * @brief Computes a conservative signed distance from the point to the boundary.
+     *
+     * The result is negative inside and positive outside the geometry, and its magnitude
+     * never exceeds the true distance to the boundary. The default implementation has no
+     * knowledge about the geometry and returns 0, which never excludes a boundary.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance bound
+     */
+    virtual double distance(double x, double y) const;
+
+    /**
+     * @brief Returns an axis-aligned box containing all inside points of the geometry.
+     *
+     * Used to find the cells affected by an edit of the geometry. The box may be larger
+     * than necessary and is empty if the geometry has no inside points. The default
+     * implementation returns the infinite box.
+     *
+     * @return Bounding box of the inside region
+     */
+    virtual Cell2D boundingBox() const;
+
+#ifdef IMPLICIT_ENABLE_STATS
+    /// Number of points evaluated by `inside` and `insideBatch` of this node so far
+    std::size_t numberOfEvaluations() const { return evaluations_.value(); }
+
+protected:
+    detail::EvaluationCounter evaluations_;  ///< Point evaluations of this node
+#endif
 };
 
 } // namespace implicit
@@ -0,0 +1,47 @@
+#pragma once
+
+/**
+ * @file AbsNaryOperation.hpp
+ * @brief Defines an abstract base class for boolean operations with any number of operands.
+ */
+
+#include "AbsOperation.hpp"
+
+#include <vector>
+
+namespace implicit
+{
+
+/**
+ * @class AbsNaryOperation
+ * @brief Abstract base class for associative operations (CSG) on a list of geometries.
+ *
+ * A chain of nested binary unions or intersections recurses once per operand on every
+ * query. The n-ary form evaluates the operands in a flat loop in the given order and
+ * stops as soon as the result is decided, so cheap and decisive operands belong first.
+ */
+class AbsNaryOperation : public AbsImplicitGeometry
+{
+public:
+    /**
+     * @brief Constructs an operation on the given operands.
+     *
+     * @param operands Input geometries in evaluation order
+     * @throws std::invalid_argument if the list is empty or contains a null pointer
+     */
+    explicit AbsNaryOperation(std::vector<ImplicitGeometryPtr> operands);
+
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~AbsNaryOperation();
+
+    /// Operands of the operation in evaluation order
+    const std::vector<ImplicitGeometryPtr> &operands() const { return operands_; }
+
+protected:
+    /// Operands of the operation in evaluation order
+    std::vector<ImplicitGeometryPtr> operands_;
+};
+
+} // namespace implicit
@@ -5,8 +5,10 @@
  * @brief Defines an abstract base class for boolean operations on implicit geometries.
  */
 
+#include <atomic>
 #include <memory>
 #include "AbsImplicitGeometry.hpp"
+#include "operand_profile.h"
 
 namespace implicit
 {
@@ -21,6 +23,10 @@ using ImplicitGeometryPtr = std::shared_ptr<AbsImplicitGeometry>;
  * This class represents a generic boolean operation (such as union, intersection, difference)
  * between two shapes. It stores two operands as shared pointers and is intended to be inherited
  * by specific operation classes.
+ *
+ * Point queries evaluate the operands one after the other and skip the second one if the first
+ * already decides the result. By default operand1 is evaluated first; the order can be set
+ * explicitly or chosen from a runtime profile (see OperandProfiler).
  */
 class AbsOperation : public AbsImplicitGeometry
 {
@@ -38,12 +44,114 @@ public:
      */
     virtual ~AbsOperation();
 
+    /// First operand of the operation
+    const ImplicitGeometryPtr &operand1() const { return operand1_; }
+
+    /// Second operand of the operation
+    const ImplicitGeometryPtr &operand2() const { return operand2_; }
+
+    /// Whether point queries evaluate operand2 before operand1
+    bool operand2First() const { return operand2First_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the evaluation order of point queries; the result does not depend on it.
+     *
+     * The order is stored atomically, so it may change while other threads evaluate the geometry.
+     *
+     * @param operand2First Whether operand2 is evaluated before operand1
+     */
+    void setOperand2First(bool operand2First) { operand2First_.store(operand2First, std::memory_order_relaxed); }
+
 protected:
+    /**
+     * @brief Evaluates the operands in the configured order with short-circuiting.
+     *
+     * If the first evaluated operand decides the result, the other one is skipped; the
+     * result is then `combine(value, value)`, which must equal the decided result. While
+     * a profiler is active on the calling thread, the evaluations are counted in its slot
+     * of this operation.
+     *
+     * @param evaluate Callable evaluating an operand, `(const AbsImplicitGeometry &) -> T`
+     * @param decides Callable telling whether a value of operand 0 or 1 decides the result
+     * @param combine Callable combining the values of operand1 and operand2
+     * @return Result of the operation
+     */
+    template<typename Evaluate, typename Decides, typename Combine>
+    auto evaluateOperands(Evaluate evaluate, Decides decides, Combine combine) const
+    {
+        detail::OperandProfiler *profiler = detail::OperandProfiler::active();
+        if (!profiler)
+        {
+            int first = operand2First() ? 1 : 0;
+            const AbsImplicitGeometry *operands[2] = { operand1_.get(), operand2_.get() };
+
+            auto value = evaluate(*operands[first]);
+            if (decides(first, value))
+                return combine(value, value);
+
+            auto other = evaluate(*operands[1 - first]);
+            return first == 0 ? combine(value, other) : combine(other, value);
+        }
+
+        return evaluateProfiled(*profiler, evaluate, decides, combine);
+    }
+
     /// First operand of the operation
     ImplicitGeometryPtr operand1_;
 
     /// Second operand of the operation
     ImplicitGeometryPtr operand2_;
+
+private:
+    friend class detail::OperandProfiler;
+
+    /**
+     * @brief Profiled variant of evaluateOperands, kept apart from the unprofiled path.
+     *
+     * @param profiler Profiler recording on the calling thread
+     * @param evaluate Callable evaluating an operand
+     * @param decides Callable telling whether a value of operand 0 or 1 decides the result
+     * @param combine Callable combining the values of operand1 and operand2
+     * @return Result of the operation
+     */
+    template<typename Evaluate, typename Decides, typename Combine>
+    auto evaluateProfiled(detail::OperandProfiler &profiler, Evaluate evaluate, Decides decides,
+                          Combine combine) const
+    {
+        int first = operand2First() ? 1 : 0;
+        const AbsImplicitGeometry *operands[2] = { operand1_.get(), operand2_.get() };
+        detail::OperandCounters *counters = profiler.counters(this);
+
+        // Operations outside the profile still count the nodes they visit
+        auto measure = [&](int operand)
+        {
+            std::uint64_t before = profiler.evaluations();
+            profiler.addEvaluations(1);
+            auto value = evaluate(*operands[operand]);
+            if (counters)
+            {
+                counters->evaluations[operand] += 1;
+                counters->cost[operand] += profiler.evaluations() - before;
+            }
+            return value;
+        };
+
+        auto value = measure(first);
+        if (decides(first, value))
+        {
+            if (counters)
+                counters->decisions[first] += 1;
+            return combine(value, value);
+        }
+
+        auto other = measure(1 - first);
+        if (counters)
+            counters->decisions[1 - first] += decides(1 - first, other);
+        return first == 0 ? combine(value, other) : combine(other, value);
+    }
+
+    // Evaluation strategy only, so the profiler may change it on const geometries
+    mutable std::atomic<bool> operand2First_ { false };  ///< Whether point queries evaluate operand2 first
 };
 
 } // namespace implicit
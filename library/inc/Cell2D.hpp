@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * @file Cell2D.hpp
+ * @brief Defines the 2D cell types shared by the implicit geometries and the quadtree.
+ */
+
+#include <array>
+
+namespace implicit
+{
+
+/// Represents a 1D range [min, max]
+using Bounds = std::array<double, 2>;
+
+/// Represents a 2D rectangular cell as {x-bounds, y-bounds}
+using Cell2D = std::array<Bounds, 2>;
+
+/**
+ * @brief Position of a whole cell relative to an implicit geometry.
+ */
+enum class CellClassification
+{
+    Inside,   ///< All points of the cell are inside the geometry
+    Outside,  ///< All points of the cell are outside the geometry
+    Cut       ///< The cell may contain points on both sides of the boundary
+};
+
+} // namespace implicit
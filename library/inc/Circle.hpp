@@ -42,6 +42,59 @@ public:
      * @return true if the point is inside, false otherwise
      */
     bool inside(double x, double y) const override;
+
+    /// X-coordinate of the center
+    double centerX() const { return x_; }
+
+    /// Y-coordinate of the center
+    double centerY() const { return y_; }
+
+    /// Radius of the circle
+    double radius() const { return r_; }
+
+    /**
+     * @brief Checks a batch of points against the circle using SIMD kernels.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override;
+
+    /**
+     * @brief Checks a batch of single precision points against the circle using SIMD kernels.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const float *x, const float *y, std::size_t n) const override;
+
+    /**
+     * @brief Classifies a whole cell against the circle using the nearest and farthest cell points.
+     *
+     * @param cell Cell to classify
+     * @return Inside, Outside or Cut
+     */
+    CellClassification classify(Cell2D cell) const override;
+
+    /**
+     * @brief Computes the exact signed distance to the circle.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance (negative inside)
+     */
+    double distance(double x, double y) const override;
+
+    /**
+     * @brief Returns the square enclosing the circle.
+     *
+     * @return Bounding box of the inside region
+     */
+    Cell2D boundingBox() const override;
 };
 
 } // namespace implicit
@@ -0,0 +1,176 @@
+#pragma once
+
+/**
+ * @file CompiledGeometry.hpp
+ * @brief Defines a flat, dispatch-free representation of a CSG tree.
+ */
+
+#include "AbsOperation.hpp"
+#include "AbsNaryOperation.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace implicit
+{
+
+/**
+ * @class CompiledGeometry
+ * @brief Evaluates a CSG tree compiled into a compact postfix program.
+ *
+ * The constructor walks an `ImplicitGeometryPtr` tree once and emits one instruction per
+ * node in postfix order. Primitive parameters are packed contiguously in program order, so
+ * evaluation is a single linear pass over two arrays without pointer chasing or virtual calls.
+ *
+ * Operands are emitted in Sethi-Ullman order (the operand needing the larger stack first),
+ * which bounds the evaluation stack by log2 of the number of primitives. The stack is then
+ * kept in a single machine word for scalar queries.
+ *
+ * Single precision batches run the same program on a copy of the parameters rounded to float.
+ *
+ * NaryUnion and NaryIntersection nodes are emitted as chains of the binary instructions.
+ * Geometries other than Circle, Rectangle, the unions, the intersections and Difference are
+ * kept as external references and evaluated through their virtual interface; so is
+ * IndexedUnion, whose grid would be lost in a chain.
+ */
+class CompiledGeometry : public AbsImplicitGeometry
+{
+public:
+    /// Instruction set of the postfix program
+    enum class OpCode : unsigned char
+    {
+        Circle,            ///< Push circle test, consumes 3 parameters (x, y, r)
+        Rectangle,         ///< Push rectangle test, consumes 4 parameters (x1, y1, x2, y2)
+        External,          ///< Push result of the next external geometry
+        Union,             ///< Pop b, a and push a OR b
+        Intersection,      ///< Pop b, a and push a AND b
+        Difference,        ///< Pop b, a and push a AND NOT b
+        ReverseDifference  ///< Pop b, a and push b AND NOT a
+    };
+
+    /// Maximum evaluation stack depth supported by the interpreter
+    static constexpr std::size_t maxStackDepth = 64;
+
+    /**
+     * @brief Compiles the given geometry tree into a postfix program.
+     *
+     * @param geometry Root of the CSG tree
+     */
+    explicit CompiledGeometry(const ImplicitGeometryPtr &geometry);
+
+    /**
+     * @brief Adopts a postfix program without external geometries, e.g. one read from a scene file.
+     *
+     * The program is checked before it is used: every operation needs two operands on the
+     * stack, the parameters must match the primitives and exactly one value must remain.
+     *
+     * @param instructions Postfix instruction stream
+     * @param parameters Primitive parameters in program order
+     * @throws std::invalid_argument if the program is malformed or contains External instructions
+     * @throws std::length_error if the program needs more than maxStackDepth stack slots
+     */
+    CompiledGeometry(std::vector<OpCode> instructions, std::vector<double> parameters);
+
+    /**
+     * @brief Checks if the given point lies inside the compiled geometry.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return true if the point is inside the geometry, false otherwise
+     */
+    bool inside(double x, double y) const override;
+
+    /**
+     * @brief Checks a batch of points by running the program on whole point masks.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override;
+
+    /**
+     * @brief Checks a batch of single precision points with the parameters rounded to float.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const float *x, const float *y, std::size_t n) const override;
+
+    /**
+     * @brief Classifies a whole cell by running the program on cell classifications.
+     *
+     * @param cell Cell to classify
+     * @return Inside, Outside or Cut
+     */
+    CellClassification classify(Cell2D cell) const override;
+
+    /**
+     * @brief Computes a signed distance bound by running the program on distances.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance bound
+     */
+    double distance(double x, double y) const override;
+
+    /**
+     * @brief Returns the bounding box of the source tree computed at compile time.
+     *
+     * @return Bounding box of the inside region
+     */
+    Cell2D boundingBox() const override;
+
+    /// Instructions of the program in postfix order
+    const std::vector<OpCode> &instructions() const { return code_; }
+
+    /// Packed primitive parameters in program order
+    const std::vector<double> &parameters() const { return parameters_; }
+
+    /// Number of stack slots needed to evaluate the program
+    std::size_t stackDepth() const { return stackDepth_; }
+
+private:
+    /// Stack depth needed by each node of the source tree
+    using DepthMap = std::unordered_map<const AbsImplicitGeometry *, std::size_t>;
+
+    /**
+     * @brief Recursively computes the stack depth needed by every subtree.
+     *
+     * @param geometry Root of the subtree
+     * @param depths Output map from node to stack depth
+     * @return Stack depth needed by the subtree
+     */
+    static std::size_t computeDepths(const ImplicitGeometryPtr &geometry, DepthMap &depths);
+
+    /**
+     * @brief Recursively emits the instructions of a subtree.
+     *
+     * @param geometry Root of the subtree
+     * @param depths Precomputed stack depth of every subtree
+     */
+    void emit(const ImplicitGeometryPtr &geometry, const DepthMap &depths);
+
+    /**
+     * @brief Batch interpreter shared by both precisions.
+     *
+     * @param parameters Primitive parameters in the precision of the points
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     */
+    template<typename Real>
+    PointMask evaluateBatch(const Real *parameters, const Real *x, const Real *y, std::size_t n) const;
+
+    std::vector<OpCode> code_;                ///< Postfix instruction stream
+    std::vector<double> parameters_;          ///< Primitive parameters in program order
+    std::vector<float> singleParameters_;     ///< Parameters rounded to float for single precision batches
+    std::vector<ImplicitGeometryPtr> externals_;  ///< Geometries evaluated via virtual calls
+    std::size_t stackDepth_;                  ///< Maximum stack depth of the program
+    Cell2D boundingBox_;                      ///< Bounding box of the source tree
+};
+
+} // namespace implicit
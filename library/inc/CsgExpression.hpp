@@ -0,0 +1,290 @@
+#pragma once
+
+/**
+ * @file CsgExpression.hpp
+ * @brief Defines header-only CSG expression templates for geometries known at compile time.
+ *
+ * The types in `implicit::csg` mirror the runtime geometry classes, but compose by value
+ * instead of through shared pointers. The whole expression is a single concrete type, so
+ * `inside` is resolved statically and can be fully inlined, e.g.
+ *
+ *     csg::Union<csg::Circle, csg::Difference<csg::Rectangle, csg::Circle>>
+ */
+
+#include "AbsImplicitGeometry.hpp"
+#include "classification_helper.h"
+#include "distance_helper.h"
+
+namespace implicit::csg
+{
+
+/**
+ * @struct Circle
+ * @brief Circle primitive with center `(x, y)` and radius `r`.
+ */
+struct Circle
+{
+    double x;  ///< X-coordinate of the center
+    double y;  ///< Y-coordinate of the center
+    double r;  ///< Radius of the circle
+
+    /**
+     * @brief Checks if a point lies inside or on the circle.
+     */
+    bool inside(double px, double py) const
+    {
+        double dx = px - x;
+        double dy = py - y;
+        return (dx * dx + dy * dy) <= (r * r);
+    }
+
+    /**
+     * @brief Classifies a whole cell against the circle.
+     */
+    CellClassification classify(const Cell2D &cell) const
+    {
+        return detail::classifyCircle(x, y, r, cell);
+    }
+
+    /**
+     * @brief Computes the exact signed distance to the circle.
+     */
+    double distance(double px, double py) const
+    {
+        return detail::circleDistance(x, y, r, px, py);
+    }
+};
+
+/**
+ * @struct Rectangle
+ * @brief Axis-aligned rectangle primitive with corners `(x1, y1)` and `(x2, y2)`.
+ */
+struct Rectangle
+{
+    double x1;  ///< Lower x-bound (left)
+    double y1;  ///< Lower y-bound (bottom)
+    double x2;  ///< Upper x-bound (right)
+    double y2;  ///< Upper y-bound (top)
+
+    /**
+     * @brief Checks if a point lies inside or on the rectangle.
+     */
+    bool inside(double px, double py) const
+    {
+        return (px >= x1) & (px <= x2) & (py >= y1) & (py <= y2);
+    }
+
+    /**
+     * @brief Classifies a whole cell against the rectangle.
+     */
+    CellClassification classify(const Cell2D &cell) const
+    {
+        return detail::classifyRectangle(x1, y1, x2, y2, cell);
+    }
+
+    /**
+     * @brief Computes the exact signed distance to the rectangle.
+     */
+    double distance(double px, double py) const
+    {
+        return detail::rectangleDistance(x1, y1, x2, y2, px, py);
+    }
+};
+
+/**
+ * @struct Union
+ * @brief Union of two static geometries.
+ *
+ * Both operands are always evaluated (no short-circuit) so that loops over
+ * many points stay branch-free and can be vectorized.
+ */
+template<typename Operand1, typename Operand2>
+struct Union
+{
+    Operand1 operand1;  ///< First operand
+    Operand2 operand2;  ///< Second operand
+
+    /**
+     * @brief Checks if a point lies inside at least one operand.
+     */
+    bool inside(double x, double y) const
+    {
+        return operand1.inside(x, y) | operand2.inside(x, y);
+    }
+
+    /**
+     * @brief Classifies a whole cell by combining the operand classifications.
+     */
+    CellClassification classify(const Cell2D &cell) const
+    {
+        return detail::uniteClassifications(operand1.classify(cell), operand2.classify(cell));
+    }
+
+    /**
+     * @brief Computes a signed distance bound from the operand distances.
+     */
+    double distance(double x, double y) const
+    {
+        return std::min(operand1.distance(x, y), operand2.distance(x, y));
+    }
+};
+
+/**
+ * @struct Intersection
+ * @brief Intersection of two static geometries.
+ */
+template<typename Operand1, typename Operand2>
+struct Intersection
+{
+    Operand1 operand1;  ///< First operand
+    Operand2 operand2;  ///< Second operand
+
+    /**
+     * @brief Checks if a point lies inside both operands.
+     */
+    bool inside(double x, double y) const
+    {
+        return operand1.inside(x, y) & operand2.inside(x, y);
+    }
+
+    /**
+     * @brief Classifies a whole cell by combining the operand classifications.
+     */
+    CellClassification classify(const Cell2D &cell) const
+    {
+        return detail::intersectClassifications(operand1.classify(cell), operand2.classify(cell));
+    }
+
+    /**
+     * @brief Computes a signed distance bound from the operand distances.
+     */
+    double distance(double x, double y) const
+    {
+        return std::max(operand1.distance(x, y), operand2.distance(x, y));
+    }
+};
+
+/**
+ * @struct Difference
+ * @brief Set difference (A \ B) of two static geometries.
+ */
+template<typename Operand1, typename Operand2>
+struct Difference
+{
+    Operand1 operand1;  ///< Minuend
+    Operand2 operand2;  ///< Subtrahend
+
+    /**
+     * @brief Checks if a point lies inside operand1 and not inside operand2.
+     */
+    bool inside(double x, double y) const
+    {
+        return operand1.inside(x, y) & !operand2.inside(x, y);
+    }
+
+    /**
+     * @brief Classifies a whole cell by combining the operand classifications.
+     */
+    CellClassification classify(const Cell2D &cell) const
+    {
+        return detail::subtractClassifications(operand1.classify(cell), operand2.classify(cell));
+    }
+
+    /**
+     * @brief Computes a signed distance bound from the operand distances.
+     */
+    double distance(double x, double y) const
+    {
+        return std::max(operand1.distance(x, y), -operand2.distance(x, y));
+    }
+};
+
+/// Creates the union of two static geometries
+template<typename Operand1, typename Operand2>
+Union<Operand1, Operand2> makeUnion(Operand1 operand1, Operand2 operand2)
+{
+    return { operand1, operand2 };
+}
+
+/// Creates the intersection of two static geometries
+template<typename Operand1, typename Operand2>
+Intersection<Operand1, Operand2> makeIntersection(Operand1 operand1, Operand2 operand2)
+{
+    return { operand1, operand2 };
+}
+
+/// Creates the difference of two static geometries
+template<typename Operand1, typename Operand2>
+Difference<Operand1, Operand2> makeDifference(Operand1 operand1, Operand2 operand2)
+{
+    return { operand1, operand2 };
+}
+
+/**
+ * @class Geometry
+ * @brief Adapter exposing a static expression through the AbsImplicitGeometry interface.
+ *
+ * Useful when a static expression has to be combined with runtime geometries or passed
+ * to functions that only accept the virtual interface.
+ */
+template<typename Expression>
+class Geometry : public AbsImplicitGeometry
+{
+public:
+    /**
+     * @brief Wraps the given expression.
+     *
+     * @param expression Static CSG expression
+     */
+    explicit Geometry(Expression expression)
+            : expression_(expression)
+    { }
+
+    /**
+     * @brief Checks if the given point lies inside the wrapped expression.
+     */
+    bool inside(double x, double y) const override
+    {
+        IMPLICIT_STATS(this->evaluations_.add(1));
+        return expression_.inside(x, y);
+    }
+
+    /// Single precision batches are converted by the default implementation
+    using AbsImplicitGeometry::insideBatch;
+
+    /**
+     * @brief Checks a batch of points with a single virtual call.
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override
+    {
+        IMPLICIT_STATS(this->evaluations_.add(n));
+        PointMask mask = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            mask |= PointMask(expression_.inside(x[i], y[i])) << i;
+        return mask;
+    }
+
+    /**
+     * @brief Classifies a whole cell against the wrapped expression.
+     */
+    CellClassification classify(Cell2D cell) const override
+    {
+        return expression_.classify(cell);
+    }
+
+    /**
+     * @brief Computes the signed distance bound of the wrapped expression.
+     */
+    double distance(double x, double y) const override
+    {
+        return expression_.distance(x, y);
+    }
+
+    /// Wrapped static expression
+    const Expression &expression() const { return expression_; }
+
+private:
+    Expression expression_;  ///< Wrapped static expression
+};
+
+} // namespace implicit::csg
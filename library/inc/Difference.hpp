@@ -37,6 +37,57 @@ public:
      * @return true if the point is inside the first operand and not in the second
      */
     bool inside(double x, double y) const override;
+
+    /**
+     * @brief Checks a batch of points against the difference by masking out the second operand.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override;
+
+    /**
+     * @brief Checks a batch of single precision points in the same way as the double overload.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const float *x, const float *y, std::size_t n) const override;
+
+    /**
+     * @brief Classifies a whole cell against the difference of the operands.
+     *
+     * @param cell Cell to classify
+     * @return Inside, Outside or Cut
+     */
+    CellClassification classify(Cell2D cell) const override;
+
+    /**
+     * @brief Computes a signed distance bound as max(d1, -d2).
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance bound
+     */
+    double distance(double x, double y) const override;
+
+    /**
+     * @brief Returns the box of the first operand.
+     *
+     * @return Bounding box of the inside region
+     */
+    Cell2D boundingBox() const override;
+
+private:
+    /**
+     * @brief Batch query shared by both precisions.
+     */
+    template<typename Real>
+    PointMask evaluateBatch(const Real *x, const Real *y, std::size_t n) const;
 };
 
 } // namespace implicit
@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+ * @file IndexedUnion.hpp
+ * @brief Defines a union of many implicit geometries with a uniform grid over their bounding boxes.
+ */
+
+#include "NaryUnion.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace implicit
+{
+
+/**
+ * @class IndexedUnion
+ * @brief Represents the union of a large list of implicit geometries, e.g. the pores of a microstructure.
+ *
+ * A plain union evaluates its operands one after the other, so every query costs O(n).
+ * This union sorts the operand bounding boxes into a uniform grid with about one cell
+ * per operand and answers point and cell queries by visiting only the operands whose
+ * boxes overlap the query. Operands with an unbounded box or a box covering many grid
+ * cells are kept in a separate list that every query visits.
+ *
+ * Point queries agree with NaryUnion. Cell classifications and distances only take the
+ * operands near the query into account, so they may be tighter, but remain conservative.
+ * CompiledGeometry and the CSG optimizer keep an indexed union as a single node.
+ */
+class IndexedUnion : public NaryUnion
+{
+public:
+    /**
+     * @brief Constructs the union and builds the grid over the operand boxes.
+     *
+     * @param operands Input geometries
+     * @throws std::invalid_argument if the list is empty or contains a null pointer
+     */
+    explicit IndexedUnion(std::vector<ImplicitGeometryPtr> operands);
+
+    /**
+     * @brief Checks whether a point lies inside an operand whose box contains it.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return true if the point is inside at least one of the operands
+     */
+    bool inside(double x, double y) const override;
+
+    /**
+     * @brief Checks a batch of points against the operands overlapping the box of the batch.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override;
+
+    /**
+     * @brief Checks a batch of single precision points in the same way as the double overload.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const float *x, const float *y, std::size_t n) const override;
+
+    /**
+     * @brief Classifies a cell against the operands overlapping it.
+     *
+     * @param cell Cell to classify
+     * @return Inside, Outside or Cut
+     */
+    CellClassification classify(Cell2D cell) const override;
+
+    /**
+     * @brief Computes a signed distance bound by searching the grid outward from the point.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance bound
+     */
+    double distance(double x, double y) const override;
+
+    /**
+     * @brief Returns the smallest box containing all of the operand boxes.
+     *
+     * @return Bounding box of the inside region
+     */
+    Cell2D boundingBox() const override;
+
+    /// Number of grid cells in x and y direction
+    std::array<int, 2> gridSize() const { return { nx_, ny_ }; }
+
+    /// Indices of the operands that are visited by every query
+    const std::vector<std::uint32_t> &unindexedOperands() const { return unindexed_; }
+
+private:
+    /**
+     * @brief Batch query shared by both precisions.
+     */
+    template<typename Real>
+    PointMask evaluateBatch(const Real *x, const Real *y, std::size_t n) const;
+
+    /**
+     * @brief Checks a point against the operands whose boxes contain it, in the given precision.
+     */
+    template<typename Real>
+    bool insidePoint(Real x, Real y) const;
+
+    /**
+     * @brief Returns the grid column of an x-coordinate, clamped to the grid.
+     */
+    int column(double x) const;
+
+    /**
+     * @brief Returns the grid row of a y-coordinate, clamped to the grid.
+     */
+    int row(double y) const;
+
+    /**
+     * @brief Calls a function once for every indexed operand whose box overlaps the query box.
+     *
+     * Stops as soon as the function returns true.
+     *
+     * @param query Box of the query
+     * @param visit Callable `(std::uint32_t operand) -> bool`
+     */
+    template<typename Visit>
+    void forEachOverlapping(const Cell2D &query, Visit visit) const;
+
+    Cell2D domain_;              ///< Box covered by the grid
+    int nx_ = 0;                 ///< Number of grid columns
+    int ny_ = 0;                 ///< Number of grid rows
+    double inverseWidth_ = 0.0;  ///< Reciprocal of the grid cell width
+    double inverseHeight_ = 0.0; ///< Reciprocal of the grid cell height
+    Cell2D boundingBox_;         ///< Merged box of all operands
+
+    std::vector<Cell2D> boxes_;                ///< Bounding box per operand
+    std::vector<std::uint32_t> cellStart_;     ///< Offset of each grid cell in cellOperands_ (row-major, plus end)
+    std::vector<std::uint32_t> cellOperands_;  ///< Operand indices of all grid cells
+    std::vector<std::uint32_t> unindexed_;     ///< Operands visited by every query
+};
+
+} // namespace implicit
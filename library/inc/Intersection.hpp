@@ -36,6 +36,57 @@ public:
      * @return true if the point is inside both operands, false otherwise
      */
     bool inside(double x, double y) const override;
+
+    /**
+     * @brief Checks a batch of points against the intersection by AND-combining the operand masks.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override;
+
+    /**
+     * @brief Checks a batch of single precision points in the same way as the double overload.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const float *x, const float *y, std::size_t n) const override;
+
+    /**
+     * @brief Classifies a whole cell against the intersection of the operands.
+     *
+     * @param cell Cell to classify
+     * @return Inside, Outside or Cut
+     */
+    CellClassification classify(Cell2D cell) const override;
+
+    /**
+     * @brief Computes a signed distance bound as the maximum of the operand distances.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance bound
+     */
+    double distance(double x, double y) const override;
+
+    /**
+     * @brief Returns the overlap of the operand boxes.
+     *
+     * @return Bounding box of the inside region
+     */
+    Cell2D boundingBox() const override;
+
+private:
+    /**
+     * @brief Batch query shared by both precisions.
+     */
+    template<typename Real>
+    PointMask evaluateBatch(const Real *x, const Real *y, std::size_t n) const;
 };
 
 } // namespace implicit
@@ -0,0 +1,91 @@
+#pragma once
+
+/**
+ * @file NaryUnion.hpp
+ * @brief Defines the CSG union of any number of implicit geometries.
+ */
+
+#include "AbsNaryOperation.hpp"
+
+namespace implicit
+{
+
+/**
+ * @class NaryUnion
+ * @brief Represents the union of a list of implicit geometries.
+ *
+ * A point is considered inside if it lies in **at least one** of the operands. Operands are
+ * evaluated in order until one of them contains the point.
+ */
+class NaryUnion : public AbsNaryOperation
+{
+public:
+    /**
+     * @brief Constructs the union of the given geometries.
+     *
+     * @param operands Input geometries in evaluation order
+     */
+    explicit NaryUnion(std::vector<ImplicitGeometryPtr> operands);
+
+    /**
+     * @brief Checks whether a point lies inside the union of the operands.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return true if the point is inside at least one of the operands
+     */
+    bool inside(double x, double y) const override;
+
+    /**
+     * @brief Checks a batch of points by OR-combining the operand masks.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override;
+
+    /**
+     * @brief Checks a batch of single precision points in the same way as the double overload.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const float *x, const float *y, std::size_t n) const override;
+
+    /**
+     * @brief Classifies a whole cell against the union of the operands.
+     *
+     * @param cell Cell to classify
+     * @return Inside, Outside or Cut
+     */
+    CellClassification classify(Cell2D cell) const override;
+
+    /**
+     * @brief Computes a signed distance bound as the minimum of the operand distances.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance bound
+     */
+    double distance(double x, double y) const override;
+
+    /**
+     * @brief Returns the smallest box containing all of the operand boxes.
+     *
+     * @return Bounding box of the inside region
+     */
+    Cell2D boundingBox() const override;
+
+private:
+    /**
+     * @brief Batch query shared by both precisions.
+     */
+    template<typename Real>
+    PointMask evaluateBatch(const Real *x, const Real *y, std::size_t n) const;
+};
+
+} // namespace implicit
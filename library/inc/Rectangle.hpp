@@ -44,6 +44,62 @@ public:
      * @return true if the point is inside, false otherwise
      */
     bool inside(double x, double y) const override;
+
+    /// Lower x-bound (left)
+    double xMin() const { return x1_; }
+
+    /// Upper x-bound (right)
+    double xMax() const { return x2_; }
+
+    /// Lower y-bound (bottom)
+    double yMin() const { return y1_; }
+
+    /// Upper y-bound (top)
+    double yMax() const { return y2_; }
+
+    /**
+     * @brief Checks a batch of points against the rectangle using SIMD kernels.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const double *x, const double *y, std::size_t n) const override;
+
+    /**
+     * @brief Checks a batch of single precision points against the rectangle using SIMD kernels.
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points (at most maxBatchSize)
+     * @return Mask with bit i set if point i is inside
+     */
+    PointMask insideBatch(const float *x, const float *y, std::size_t n) const override;
+
+    /**
+     * @brief Classifies a whole cell against the rectangle by comparing the bounds.
+     *
+     * @param cell Cell to classify
+     * @return Inside, Outside or Cut
+     */
+    CellClassification classify(Cell2D cell) const override;
+
+    /**
+     * @brief Computes the exact signed distance to the rectangle.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Signed distance (negative inside)
+     */
+    double distance(double x, double y) const override;
+
+    /**
+     * @brief Returns the rectangle itself.
+     *
+     * @return Bounding box of the inside region
+     */
+    Cell2D boundingBox() const override;
 };
 
 } // namespace implicit
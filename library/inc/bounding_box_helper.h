@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * @file bounding_box_helper.h
+ * @brief Provides set operations on axis-aligned bounding boxes.
+ *
+ * A box whose lower bound exceeds its upper bound in any direction is empty. The
+ * infinite box is used by geometries that cannot bound their inside region.
+ */
+
+#include "Cell2D.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Returns the box covering the whole plane.
+ */
+inline Cell2D infiniteBox()
+{
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    return { Bounds { -inf, inf }, Bounds { -inf, inf } };
+}
+
+/**
+ * @brief Checks whether a box contains no points.
+ */
+inline bool isEmptyBox(const Cell2D &box)
+{
+    return !(box[0][0] <= box[0][1] && box[1][0] <= box[1][1]);
+}
+
+/**
+ * @brief Returns the smallest box containing both boxes.
+ */
+inline Cell2D mergeBoxes(const Cell2D &a, const Cell2D &b)
+{
+    if (isEmptyBox(a)) return b;
+    if (isEmptyBox(b)) return a;
+
+    return { Bounds { std::min(a[0][0], b[0][0]), std::max(a[0][1], b[0][1]) },
+             Bounds { std::min(a[1][0], b[1][0]), std::max(a[1][1], b[1][1]) } };
+}
+
+/**
+ * @brief Returns the overlap of two boxes, which may be empty.
+ */
+inline Cell2D intersectBoxes(const Cell2D &a, const Cell2D &b)
+{
+    return { Bounds { std::max(a[0][0], b[0][0]), std::min(a[0][1], b[0][1]) },
+             Bounds { std::max(a[1][0], b[1][0]), std::min(a[1][1], b[1][1]) } };
+}
+
+/**
+ * @brief Checks whether two closed boxes share at least one point.
+ */
+inline bool boxesOverlap(const Cell2D &a, const Cell2D &b)
+{
+    return !isEmptyBox(intersectBoxes(a, b));
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,100 @@
+#pragma once
+
+/**
+ * @file classification_helper.h
+ * @brief Provides interval (box) classification kernels for primitives and CSG operators.
+ *
+ * A primitive is classified against a whole cell by bounding its implicit function over
+ * the cell. CSG operators combine the classifications of their operands; the result is
+ * conservative, i.e. a uniform cell may be reported as Cut, but a cell containing the
+ * boundary is never reported as Inside or Outside.
+ */
+
+#include "Cell2D.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Classifies a cell against a circle using the nearest and farthest cell points.
+ *
+ * @param cx X-coordinate of the circle center
+ * @param cy Y-coordinate of the circle center
+ * @param r Radius of the circle
+ * @param cell Cell to classify
+ * @return Classification of the cell
+ */
+inline CellClassification classifyCircle(double cx, double cy, double r, const Cell2D &cell)
+{
+    double nearX = std::max({ cell[0][0] - cx, 0.0, cx - cell[0][1] });
+    double nearY = std::max({ cell[1][0] - cy, 0.0, cy - cell[1][1] });
+    double farX = std::max(std::abs(cell[0][0] - cx), std::abs(cell[0][1] - cx));
+    double farY = std::max(std::abs(cell[1][0] - cy), std::abs(cell[1][1] - cy));
+
+    double r2 = r * r;
+    if (farX * farX + farY * farY <= r2)
+        return CellClassification::Inside;
+    if (nearX * nearX + nearY * nearY > r2)
+        return CellClassification::Outside;
+    return CellClassification::Cut;
+}
+
+/**
+ * @brief Classifies a cell against an axis-aligned rectangle.
+ *
+ * @param x1 Left boundary (min x)
+ * @param y1 Bottom boundary (min y)
+ * @param x2 Right boundary (max x)
+ * @param y2 Top boundary (max y)
+ * @param cell Cell to classify
+ * @return Classification of the cell
+ */
+inline CellClassification classifyRectangle(double x1, double y1, double x2, double y2, const Cell2D &cell)
+{
+    if (cell[0][0] >= x1 && cell[0][1] <= x2 && cell[1][0] >= y1 && cell[1][1] <= y2)
+        return CellClassification::Inside;
+    if (cell[0][1] < x1 || cell[0][0] > x2 || cell[1][1] < y1 || cell[1][0] > y2)
+        return CellClassification::Outside;
+    return CellClassification::Cut;
+}
+
+/**
+ * @brief Combines operand classifications for a union.
+ */
+inline CellClassification uniteClassifications(CellClassification a, CellClassification b)
+{
+    if (a == CellClassification::Inside || b == CellClassification::Inside)
+        return CellClassification::Inside;
+    if (a == CellClassification::Outside && b == CellClassification::Outside)
+        return CellClassification::Outside;
+    return CellClassification::Cut;
+}
+
+/**
+ * @brief Combines operand classifications for an intersection.
+ */
+inline CellClassification intersectClassifications(CellClassification a, CellClassification b)
+{
+    if (a == CellClassification::Outside || b == CellClassification::Outside)
+        return CellClassification::Outside;
+    if (a == CellClassification::Inside && b == CellClassification::Inside)
+        return CellClassification::Inside;
+    return CellClassification::Cut;
+}
+
+/**
+ * @brief Combines operand classifications for a difference (a \ b).
+ */
+inline CellClassification subtractClassifications(CellClassification a, CellClassification b)
+{
+    if (a == CellClassification::Outside || b == CellClassification::Inside)
+        return CellClassification::Outside;
+    if (a == CellClassification::Inside && b == CellClassification::Outside)
+        return CellClassification::Inside;
+    return CellClassification::Cut;
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,52 @@
+#pragma once
+
+/**
+ * @file csg_optimizer.h
+ * @brief Provides a rewriting pass that simplifies CSG trees before evaluation.
+ *
+ * The binary operations turn a union of n primitives into a chain of depth n that is
+ * recursed on every query. The optimizer rewrites such trees into an equivalent
+ * geometry that is cheaper to evaluate:
+ *
+ * - nested unions and intersections are flattened into NaryUnion and NaryIntersection
+ *   nodes, and chained differences (a \ b) \ c become a \ (b ∪ c);
+ * - structurally identical subtrees are merged into one shared node (hash-consing), and
+ *   duplicate operands of a union or intersection are dropped;
+ * - the operands of n-ary nodes are ordered so that cheap operands that most likely
+ *   decide the result are evaluated first.
+ *
+ * The likelihood that an operand contains a query point is estimated from the area of
+ * its bounding box relative to the boxes of all operands of the node. Geometries other
+ * than the built-in primitives and operations are kept as they are.
+ */
+
+#include "AbsOperation.hpp"
+
+namespace implicit
+{
+
+/**
+ * @struct OptimizerOptions
+ * @brief Selects the rewrites performed by optimizeGeometry.
+ */
+struct OptimizerOptions
+{
+    bool flatten = true;      ///< Merge nested unions, intersections and differences
+    bool deduplicate = true;  ///< Share identical subtrees and drop duplicate operands
+    bool reorder = true;      ///< Order operands by estimated cost and selectivity
+};
+
+/**
+ * @brief Rewrites a CSG tree into an equivalent, cheaper to evaluate geometry.
+ *
+ * The input tree is not modified; unchanged subtrees may be shared with the result.
+ *
+ * @param geometry Root of the CSG tree
+ * @param options Rewrites to perform
+ * @return Optimized geometry with the same inside region
+ * @throws std::invalid_argument if the geometry is null
+ */
+ImplicitGeometryPtr optimizeGeometry(const ImplicitGeometryPtr &geometry,
+                                     const OptimizerOptions &options = {});
+
+} // namespace implicit
@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @file distance_helper.h
+ * @brief Provides signed distance kernels for the primitive geometries.
+ *
+ * Distances are negative inside, positive outside and zero on the boundary.
+ * CSG operators combine them with min/max, which yields a conservative bound:
+ * its magnitude never exceeds the true distance to the boundary of the result.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Exact signed distance from a point to a circle.
+ *
+ * @param cx X-coordinate of the circle center
+ * @param cy Y-coordinate of the circle center
+ * @param r Radius of the circle
+ * @param x X-coordinate of the point
+ * @param y Y-coordinate of the point
+ * @return Signed distance to the circle boundary
+ */
+inline double circleDistance(double cx, double cy, double r, double x, double y)
+{
+    return std::hypot(x - cx, y - cy) - r;
+}
+
+/**
+ * @brief Exact signed distance from a point to an axis-aligned rectangle.
+ *
+ * @param x1 Left boundary (min x)
+ * @param y1 Bottom boundary (min y)
+ * @param x2 Right boundary (max x)
+ * @param y2 Top boundary (max y)
+ * @param x X-coordinate of the point
+ * @param y Y-coordinate of the point
+ * @return Signed distance to the rectangle boundary
+ */
+inline double rectangleDistance(double x1, double y1, double x2, double y2, double x, double y)
+{
+    double qx = std::max(x1 - x, x - x2);
+    double qy = std::max(y1 - y, y - y2);
+
+    double outside = std::hypot(std::max(qx, 0.0), std::max(qy, 0.0));
+    double inside = std::min(std::max(qx, qy), 0.0);
+
+    return outside + inside;
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,132 @@
+#pragma once
+
+/**
+ * @file lazy_quadtree.h
+ * @brief Provides a quadtree that is refined on demand by region and point queries.
+ *
+ * Only the nodes touched by a query are tested against the geometry and subdivided, so
+ * construction is free and the tree grows with the area that is actually looked at.
+ * Refined subtrees are kept for later queries. With a memory budget, the subtrees that
+ * were least recently touched are collapsed again once the budget is exceeded.
+ */
+
+#include "quadtree_helper.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace implicit::detail
+{
+
+/**
+ * @class LazyQuadTree
+ * @brief Quadtree refined lazily inside query windows with LRU eviction of cold subtrees.
+ *
+ * The geometry is referenced, not copied, and must outlive the tree. A fully refined
+ * window yields the same leaves as an eager partition with the same options.
+ */
+class LazyQuadTree
+{
+public:
+    /**
+     * @brief Constructs a tree consisting of the unrefined root cell.
+     *
+     * @param geometry Implicit geometry used for boundary detection
+     * @param rootCell Bounding box of the quadtree domain
+     * @param maxDepth Maximum allowed subdivision depth
+     * @param options Partitioning parameters (the seed cache and threads are not used)
+     * @param memoryBudget Maximum memory used by the nodes in bytes (0 for no limit)
+     */
+    LazyQuadTree(const AbsImplicitGeometry &geometry, Cell2D rootCell, int maxDepth,
+                 const PartitionOptions &options = {}, std::size_t memoryBudget = 0);
+
+    /**
+     * @brief Refines all nodes overlapping the window and returns the leaves touching it.
+     *
+     * @param window Region of interest
+     * @return Leaves overlapping the window with their levels, in depth-first order
+     */
+    CellsAndLevels query(Cell2D window);
+
+    /**
+     * @brief Refines the path to the point and returns the leaf containing it.
+     *
+     * Points on an edge shared by two children belong to the child with the larger
+     * coordinates.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @param cell Output bounds of the leaf
+     * @param level Output level of the leaf
+     * @return false if the point lies outside the root cell
+     */
+    bool locate(double x, double y, Cell2D &cell, unsigned int &level);
+
+    /// Number of nodes currently allocated
+    std::size_t numberOfNodes() const { return numberOfNodes_; }
+
+    /// Memory currently used by the nodes in bytes
+    std::size_t memoryUsage() const { return numberOfNodes_ * sizeof(Node); }
+
+    /// Number of cut tests performed so far
+    std::size_t numberOfEvaluations() const { return numberOfEvaluations_; }
+
+private:
+    /// Result of the cut test of a node
+    enum class Refinement : std::uint8_t
+    {
+        Unknown,  ///< Not tested yet
+        Leaf,     ///< Not cut or at the maximum depth
+        Cut       ///< Cut; the children may have been evicted
+    };
+
+    /// Node of the lazy tree
+    struct Node
+    {
+        Cell2D cell;                   ///< Bounding box of the node
+        std::vector<Node> children;    ///< Children (empty if not refined or evicted)
+        std::uint64_t lastAccess = 0;  ///< Query counter value of the last visit
+        int level = 0;                 ///< Level in the quadtree hierarchy
+        Refinement refinement = Refinement::Unknown;  ///< Result of the cut test
+    };
+
+    /**
+     * @brief Performs the cut test of a node if needed and creates its children if cut.
+     *
+     * @return true if the node has children after the call
+     */
+    bool expand(Node &node);
+
+    /**
+     * @brief Recursively refines the nodes overlapping the window and collects leaves.
+     */
+    void queryRecursive(Node &node, const Cell2D &window, CellsAndLevels &data);
+
+    /**
+     * @brief Collapses least recently used subtrees until the low-water mark is reached.
+     *
+     * Subtrees visited by the current query are never evicted.
+     */
+    void evict();
+
+    /**
+     * @brief Collects all nodes with children that were not visited by the current query.
+     */
+    void collectExpanded(Node &node, std::vector<Node *> &nodes) const;
+
+    /**
+     * @brief Counts the nodes below a node.
+     */
+    static std::size_t countDescendants(const Node &node);
+
+    const AbsImplicitGeometry &geometry_;  ///< Geometry used for boundary detection
+    PartitionOptions options_;             ///< Partitioning parameters
+    int maxDepth_;                         ///< Maximum allowed subdivision depth
+    std::size_t memoryBudget_;             ///< Node memory limit in bytes (0 for none)
+    Node root_;                            ///< Root node
+    std::size_t numberOfNodes_;            ///< Number of allocated nodes
+    std::size_t numberOfEvaluations_;      ///< Number of cut tests
+    std::uint64_t accessCounter_;          ///< Incremented for every query
+};
+
+} // namespace implicit::detail
@@ -0,0 +1,149 @@
+#pragma once
+
+/**
+ * @file leaf_sink.h
+ * @brief Provides consumers for quadtree leaves emitted during streaming partitioning.
+ *
+ * `streamQuadTree` visits the cells depth-first and hands finished leaves to a sink in
+ * bounded chunks, without materializing the tree. Peak memory is then proportional to
+ * the tree depth and the chunk size instead of the number of leaves; for this reason
+ * streaming never uses the seed point cache.
+ */
+
+#include "quadtree.h"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+namespace implicit
+{
+
+/// Maximum number of leaves passed to LeafSink::consume at once
+constexpr std::size_t leafChunkSize = 4096;
+
+/**
+ * @class LeafSink
+ * @brief Abstract consumer of quadtree leaves.
+ */
+class LeafSink
+{
+public:
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~LeafSink();
+
+    /**
+     * @brief Consumes a chunk of leaves in depth-first order.
+     *
+     * @param cells Leaf cells of the chunk
+     * @param levels Levels of the leaves
+     * @param n Number of leaves in the chunk
+     */
+    virtual void consume(const Cell2D *cells, const unsigned int *levels, std::size_t n) = 0;
+
+    /**
+     * @brief Called once after the last chunk has been consumed.
+     */
+    virtual void finish();
+};
+
+/**
+ * @class LeafBuffer
+ * @brief Sink collecting all leaves in memory.
+ */
+class LeafBuffer : public LeafSink
+{
+public:
+    /**
+     * @brief Appends the chunk to the collected leaves.
+     */
+    void consume(const Cell2D *cells, const unsigned int *levels, std::size_t n) override;
+
+    /// Collected leaf cells
+    const std::vector<Cell2D> &cells() const { return cells_; }
+
+    /// Levels of the collected leaves
+    const std::vector<unsigned int> &levels() const { return levels_; }
+
+private:
+    std::vector<Cell2D> cells_;         ///< Collected leaf cells
+    std::vector<unsigned int> levels_;  ///< Levels of the collected leaves
+};
+
+/**
+ * @class LeafCallback
+ * @brief Sink forwarding every chunk to a user function.
+ */
+class LeafCallback : public LeafSink
+{
+public:
+    /// Signature of the chunk callback
+    using Function = std::function<void(const Cell2D *, const unsigned int *, std::size_t)>;
+
+    /**
+     * @brief Constructs a sink calling the given function for each chunk.
+     *
+     * @param function Chunk callback
+     */
+    explicit LeafCallback(Function function);
+
+    /**
+     * @brief Forwards the chunk to the callback.
+     */
+    void consume(const Cell2D *cells, const unsigned int *levels, std::size_t n) override;
+
+private:
+    Function function_;  ///< Chunk callback
+};
+
+/**
+ * @class VtkStreamWriter
+ * @brief Sink writing leaves to a legacy VTK file while they are produced.
+ *
+ * Points are written to the file immediately; the point count in the header is
+ * reserved as a fixed-width field and patched in `finish`. The levels are spooled to
+ * a temporary file and appended after the generated connectivity. The binary format
+ * writes four points per cell, since sharing corners would require all leaves in memory.
+ */
+class VtkStreamWriter : public LeafSink
+{
+public:
+    /**
+     * @brief Opens the output file and writes the header.
+     *
+     * @param filename Output file path (should end with .vtk)
+     * @param format ASCII or binary encoding
+     * @throws std::runtime_error if the output or the temporary file cannot be opened
+     */
+    VtkStreamWriter(const std::string &filename, VtkFormat format = VtkFormat::Ascii);
+
+    /**
+     * @brief Closes the temporary file.
+     */
+    ~VtkStreamWriter() override;
+
+    /**
+     * @brief Writes the corner points of the chunk and spools the levels.
+     */
+    void consume(const Cell2D *cells, const unsigned int *levels, std::size_t n) override;
+
+    /**
+     * @brief Writes connectivity, cell types and levels and patches the point count.
+     */
+    void finish() override;
+
+    /// Number of leaves written so far
+    std::size_t numberOfCells() const { return numberOfCells_; }
+
+private:
+    std::ofstream file_;               ///< Output file
+    std::FILE *levels_;                ///< Temporary file with one byte per level
+    VtkFormat format_;                 ///< Output encoding
+    std::streampos pointCountOffset_;  ///< Position of the point count field
+    std::size_t numberOfCells_;        ///< Number of leaves written so far
+};
+
+} // namespace implicit
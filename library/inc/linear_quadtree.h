@@ -0,0 +1,241 @@
+#pragma once
+
+/**
+ * @file linear_quadtree.h
+ * @brief Provides a pointerless quadtree storing only its leaves as sorted Morton codes.
+ *
+ * A linear quadtree keeps one (Morton code, level) pair per leaf, i.e. 9 bytes per leaf,
+ * and no internal nodes at all. Leaves are sorted by code, which is the depth-first order
+ * of the equivalent QuadTreeNode tree, so traversal is a linear scan. Cell bounds are
+ * derived on demand from the root cell.
+ *
+ * Besides the depth-limited partition, the leaves can be produced by best-first refinement
+ * within a leaf or time budget, which bounds the output size independently of the geometry.
+ *
+ * Point location maps a point to its code on the finest lattice and finds the last leaf
+ * code not greater than it by binary search. Batched queries are sorted by code first, so
+ * consecutive lookups touch neighbouring leaves.
+ */
+
+#include "quadtree_helper.h"
+#include "morton.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace implicit::detail
+{
+
+/**
+ * @class LinearQuadTree
+ * @brief Quadtree represented as a sorted array of leaf Morton codes and levels.
+ */
+class LinearQuadTree
+{
+public:
+    /// Leaf index returned for points outside the root cell
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief Constructs a tree consisting of the root cell as single leaf.
+     *
+     * @param rootCell Bounding box of the quadtree domain
+     */
+    explicit LinearQuadTree(Cell2D rootCell);
+
+    /**
+     * @brief Partitions the domain based on the geometry boundary until max depth.
+     *
+     * Uses the same cut test and options as QuadTreeNode::partition and produces the
+     * same leaves in the same order.
+     *
+     * @param geometry Implicit geometry used for boundary detection
+     * @param maxDepth Maximum allowed subdivision depth (at most maxMortonLevel)
+     * @param options Partitioning parameters
+     */
+    void partition(const AbsImplicitGeometry &geometry, int maxDepth,
+                   const PartitionOptions &options = {});
+
+    /**
+     * @brief Replaces the leaves by a best-first refinement of the root cell within a budget.
+     *
+     * Each new cell is tested once with the same cut test as partition. Cut cells wait
+     * in a priority queue ordered by the error indicator of the budget (ties are split in
+     * Morton order), and the top cell is split as long as the budget allows. Cells still
+     * queued at the end remain as cut leaves above the maximum depth, see truncated().
+     * The refinement runs on the calling thread.
+     *
+     * With RefinementPriority::BoundaryLength and CutCriterion::SeedPoints, the cut test
+     * samples the whole seed grid and the error indicator is derived from the same
+     * samples. The seed point cache is only used with a leaf budget, and holds at most
+     * (numberOfSeedPoints - 1)^2 lattice points per leaf of the budget.
+     *
+     * @param geometry Implicit geometry used for boundary detection
+     * @param budget Leaf, time and depth limits (maxDepth at most maxMortonLevel)
+     * @param options Partitioning parameters
+     */
+    void refine(const AbsImplicitGeometry &geometry, const RefinementBudget &budget,
+                const PartitionOptions &options = {});
+
+    /// Whether the last refinement stopped at its budget with cut cells left to split
+    bool truncated() const { return truncated_; }
+
+    /// Maximum depth of the last partition or refinement
+    int maxDepth() const { return maxDepth_; }
+
+    /**
+     * @brief Refines leaves until face-adjacent leaves differ by at most one level.
+     *
+     * See balanceLeaves. Leaf states computed before are discarded.
+     */
+    void balance();
+
+    /**
+     * @brief Retrieves all leaf cells with their levels.
+     *
+     * @return A pair of cell data and their corresponding levels
+     */
+    CellsAndLevels getLeafCells() const;
+
+    /// Number of leaves
+    std::size_t size() const { return codes_.size(); }
+
+    /**
+     * @brief Derives the bounds of a leaf from its Morton code.
+     *
+     * @param index Index of the leaf
+     * @return Bounding box of the leaf
+     */
+    Cell2D cell(std::size_t index) const;
+
+    /// Level of the leaf with the given index
+    unsigned int level(std::size_t index) const { return levels_[index]; }
+
+    /// Morton codes of all leaves in ascending order
+    const std::vector<MortonCode> &codes() const { return codes_; }
+
+    /// Levels of all leaves
+    const std::vector<std::uint8_t> &levels() const { return levels_; }
+
+    /// Bounding box of the quadtree domain
+    Cell2D rootCell() const { return rootCell_; }
+
+    /**
+     * @brief Determines whether each leaf is inside, outside or cut by the geometry.
+     *
+     * Leaves above the maximum depth were not cut when partitioning, so they are
+     * classified by their center. Leaves at the maximum depth, and all leaves of a
+     * truncated refinement, are tested for a cut with the same criterion as the
+     * partition. Runs on `options.numberOfThreads` threads.
+     *
+     * @param geometry Implicit geometry the tree was partitioned with
+     * @param options Partitioning parameters used for the cut test
+     */
+    void classifyLeaves(const AbsImplicitGeometry &geometry, const PartitionOptions &options = {});
+
+    /// Whether classifyLeaves has been called since the last partition
+    bool hasStates() const { return !states_.empty(); }
+
+    /// Classification of the leaf with the given index (requires classifyLeaves)
+    CellClassification state(std::size_t index) const { return states_[index]; }
+
+    /**
+     * @brief Finds the leaf containing a point.
+     *
+     * Points on an edge shared by two leaves belong to the leaf with the larger coordinates.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Index of the leaf, or npos if the point lies outside the root cell
+     */
+    std::size_t locate(double x, double y) const;
+
+    /**
+     * @brief Finds the leaves containing a batch of points.
+     *
+     * The points are sorted by Morton code and resolved in contiguous ranges, which are
+     * distributed over the given number of threads (0 selects the hardware concurrency).
+     *
+     * @param x X-coordinates of the points
+     * @param y Y-coordinates of the points
+     * @param n Number of points
+     * @param numberOfThreads Number of threads used for the lookup
+     * @return Leaf index of every point in input order, npos for points outside
+     */
+    std::vector<std::size_t> locate(const double *x, const double *y, std::size_t n,
+                                    unsigned numberOfThreads = 1) const;
+
+    /**
+     * @brief Derives the bounds of a cell from its Morton code and level.
+     *
+     * The cell is obtained by replaying the subdivision path from the root, so the
+     * bounds are bitwise identical to those produced by subdivideCell.
+     *
+     * @param rootCell Bounding box of the quadtree domain
+     * @param code Morton code of the cell
+     * @param level Level of the cell
+     * @return Bounding box of the cell
+     */
+    static Cell2D cellFromCode(Cell2D rootCell, MortonCode code, int level);
+
+private:
+    friend class MappedQuadTree;
+
+    /**
+     * @brief Maps a point to the code of its finest lattice cell.
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @param code Output code, only set if the point lies inside the root cell
+     * @return true if the point lies inside the root cell
+     */
+    bool pointCode(double x, double y, MortonCode &code) const;
+
+    /**
+     * @brief Returns the index of the last leaf whose code is not greater than the given one.
+     *
+     * @param code Code of a point inside the root cell
+     * @param first Index of a leaf known to start at or before the code
+     */
+    std::size_t leafIndex(MortonCode code, std::size_t first = 0) const;
+
+    /// Leaf codes and levels produced by a (sub)partition
+    struct Leaves
+    {
+        std::vector<MortonCode> codes;
+        std::vector<std::uint8_t> levels;
+    };
+
+    /**
+     * @brief Recursively partitions a cell and appends its leaves in Morton order.
+     */
+    static void partitionRecursive(const AbsImplicitGeometry &geometry, Cell2D cell,
+                                   MortonCode code, int level, int maxDepth,
+                                   const PartitionOptions &options, SeedPointCache *cache,
+                                   Leaves &leaves);
+
+    /**
+     * @brief Partitions a cell on the calling thread with an optional seed point cache.
+     */
+    void partitionSerial(const AbsImplicitGeometry &geometry, Cell2D cell,
+                         MortonCode code, int level, int maxDepth,
+                         const PartitionOptions &options, Leaves &leaves) const;
+
+    /**
+     * @brief Partitions a cell, spawning a task per child above the task granularity.
+     */
+    void partitionParallel(const AbsImplicitGeometry &geometry, Cell2D cell,
+                           MortonCode code, int level, int maxDepth,
+                           const PartitionOptions &options, ThreadPool &pool,
+                           Leaves &leaves) const;
+
+    Cell2D rootCell_;                   ///< Bounding box of the quadtree domain
+    std::vector<MortonCode> codes_;     ///< Sorted Morton codes of the leaves
+    std::vector<std::uint8_t> levels_;  ///< Levels of the leaves
+    std::vector<CellClassification> states_;  ///< Leaf classifications (empty until computed)
+    int maxDepth_;                      ///< Maximum depth of the last partition
+    bool truncated_;                    ///< Whether cut leaves may lie above the maximum depth
+};
+
+} // namespace implicit::detail
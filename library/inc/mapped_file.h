@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * @file mapped_file.h
+ * @brief Provides read-only memory mapping of files.
+ *
+ * Binary inputs are mapped instead of read, so loading costs no copy through the stream
+ * buffers and pages are only faulted in when they are touched.
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace implicit::detail
+{
+
+/**
+ * @class MappedFile
+ * @brief Owns a read-only, private mapping of a whole file.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Maps the given file.
+     *
+     * @param filename Path of the file
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string &filename);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// First byte of the file (nullptr for an empty file)
+    const char *data() const { return data_; }
+
+    /// Size of the file in bytes
+    std::size_t size() const { return size_; }
+
+private:
+    const char *data_ = nullptr;  ///< Start of the mapping
+    std::size_t size_ = 0;        ///< Length of the mapping
+};
+
+} // namespace implicit::detail
@@ -0,0 +1,146 @@
+#pragma once
+
+/**
+ * @file morton.h
+ * @brief Provides Morton (Z-order) code arithmetic for quadtree cells.
+ *
+ * A cell is identified by the integer coordinates of its lower-left corner on the lattice
+ * of the finest representable level (2^maxMortonLevel intervals per axis). The code
+ * interleaves the bits of both coordinates with the y-bit in the lower position, so the
+ * children of a cell appear in the same order as returned by `subdivideCell`
+ * (x0y0, x0y1, x1y0, x1y1) and sorting leaves by code yields depth-first order.
+ */
+
+#include <cstdint>
+
+namespace implicit::detail
+{
+
+/// Finest level representable by a Morton code (31 bits per axis)
+constexpr int maxMortonLevel = 31;
+
+/// Morton code of the lower-left corner of a cell on the finest lattice
+using MortonCode = std::uint64_t;
+
+/// Mask selecting the y-bits of a Morton code
+constexpr MortonCode mortonYMask = 0x5555555555555555ull;
+
+/// Mask selecting the x-bits of a Morton code
+constexpr MortonCode mortonXMask = 0xAAAAAAAAAAAAAAAAull;
+
+/**
+ * @brief Inserts a zero bit between all bits of a 32-bit value.
+ */
+inline std::uint64_t spreadBits(std::uint32_t value)
+{
+    std::uint64_t v = value;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    v = (v | (v << 2)) & 0x3333333333333333ull;
+    v = (v | (v << 1)) & 0x5555555555555555ull;
+    return v;
+}
+
+/**
+ * @brief Removes every second bit of a value (inverse of spreadBits).
+ */
+inline std::uint32_t compactBits(std::uint64_t value)
+{
+    std::uint64_t v = value & 0x5555555555555555ull;
+    v = (v | (v >> 1)) & 0x3333333333333333ull;
+    v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    v = (v | (v >> 4)) & 0x00FF00FF00FF00FFull;
+    v = (v | (v >> 8)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v >> 16)) & 0x00000000FFFFFFFFull;
+    return static_cast<std::uint32_t>(v);
+}
+
+/**
+ * @brief Interleaves lattice coordinates into a Morton code.
+ *
+ * @param ix X-coordinate on the finest lattice
+ * @param iy Y-coordinate on the finest lattice
+ * @return Morton code
+ */
+inline MortonCode encodeMorton(std::uint32_t ix, std::uint32_t iy)
+{
+    return (spreadBits(ix) << 1) | spreadBits(iy);
+}
+
+/// Extracts the x lattice coordinate from a Morton code
+inline std::uint32_t mortonX(MortonCode code)
+{
+    return compactBits(code >> 1);
+}
+
+/// Extracts the y lattice coordinate from a Morton code
+inline std::uint32_t mortonY(MortonCode code)
+{
+    return compactBits(code);
+}
+
+/**
+ * @brief Number of finest-lattice intervals covered by a cell edge at the given level.
+ */
+inline std::uint32_t cellExtent(int level)
+{
+    return std::uint32_t(1) << (maxMortonLevel - level);
+}
+
+/**
+ * @brief Returns the code range [code, code + mortonSpan(level)) covered by a cell.
+ */
+inline MortonCode mortonSpan(int level)
+{
+    return MortonCode(1) << (2 * (maxMortonLevel - level));
+}
+
+/**
+ * @brief Returns the Morton code of a child cell.
+ *
+ * @param code Morton code of the parent
+ * @param level Level of the parent
+ * @param child Child index in subdivideCell order (0 to 3)
+ * @return Morton code of the child
+ */
+inline MortonCode childCode(MortonCode code, int level, int child)
+{
+    return code | (MortonCode(child) << (2 * (maxMortonLevel - level - 1)));
+}
+
+/**
+ * @brief Returns the child index (0 to 3) of the ancestor path of a cell at a given level.
+ *
+ * @param code Morton code of the cell
+ * @param level Level whose child index is requested (1 for the children of the root)
+ */
+inline int childIndex(MortonCode code, int level)
+{
+    return static_cast<int>((code >> (2 * (maxMortonLevel - level))) & 3);
+}
+
+/**
+ * @brief Adds two Morton codes coordinate-wise without decoding them.
+ *
+ * Uses dilated integer arithmetic: the bits of the other coordinate are filled with
+ * ones so that carries propagate across them.
+ */
+inline MortonCode addMorton(MortonCode a, MortonCode b)
+{
+    MortonCode x = ((a | mortonYMask) + (b & mortonXMask)) & mortonXMask;
+    MortonCode y = ((a | mortonXMask) + (b & mortonYMask)) & mortonYMask;
+    return x | y;
+}
+
+/**
+ * @brief Subtracts two Morton codes coordinate-wise without decoding them.
+ */
+inline MortonCode subtractMorton(MortonCode a, MortonCode b)
+{
+    MortonCode x = ((a & mortonXMask) - (b & mortonXMask)) & mortonXMask;
+    MortonCode y = ((a & mortonYMask) - (b & mortonYMask)) & mortonYMask;
+    return x | y;
+}
+
+} // namespace implicit::detail
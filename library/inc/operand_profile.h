@@ -0,0 +1,138 @@
+#pragma once
+
+/**
+ * @file operand_profile.h
+ * @brief Provides the runtime profile used to reorder the operands of CSG operations.
+ *
+ * Binary operations evaluate one operand and skip the other if the first one already
+ * decides the result. While an OperandProfiler is active on the calling thread, every
+ * operation records per operand how often it was evaluated, how often its result was
+ * decisive and how many geometry nodes its evaluation visited. All counters belong to
+ * the profiler, so profiles on different threads are independent of each other. When
+ * the profiler finishes, each operation evaluates first the operand with the smaller
+ * expected cost per decided query.
+ *
+ * The active profiler is looked up in thread-local storage, which costs a function call
+ * per evaluation in a shared library. A global count of recording profilers is checked
+ * first, so evaluations skip the lookup while no profiler records on any thread.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace implicit
+{
+class AbsImplicitGeometry;
+class AbsOperation;
+}
+
+namespace implicit::detail
+{
+
+/**
+ * @struct OperandCounters
+ * @brief Profile counters of one operation, indexed by operand (0 or 1).
+ */
+struct OperandCounters
+{
+    std::uint64_t evaluations[2] = { 0, 0 };  ///< Evaluations of the operand
+    std::uint64_t decisions[2] = { 0, 0 };    ///< Evaluations that decided the result on their own
+    std::uint64_t cost[2] = { 0, 0 };         ///< Geometry nodes visited by the evaluations (including the operand)
+};
+
+/**
+ * @class OperandProfiler
+ * @brief Collects an operand profile of a geometry tree for its lifetime.
+ *
+ * The constructor assigns a profile slot to every binary operation of the tree and
+ * activates the profiler on the calling thread. Only evaluations on that thread are
+ * recorded, until finish() is called or the profiler is destroyed; both must happen on
+ * the same thread. Profilers on other threads, also of the same geometry, do not
+ * interfere, and a profiler constructed while another one is active on the thread
+ * takes over until it is finished.
+ *
+ * The cost of an operand evaluation is the number of geometry nodes it visits: every
+ * operand evaluated by a binary or n-ary operation counts once, and a compiled program
+ * counts its instructions.
+ */
+class OperandProfiler
+{
+public:
+    /**
+     * @brief Starts profiling all binary operations of the tree on the calling thread.
+     *
+     * @param geometry Root of the geometry tree
+     */
+    explicit OperandProfiler(const AbsImplicitGeometry &geometry);
+
+    /**
+     * @brief Stops profiling without changing the operand order if finish was not called.
+     */
+    ~OperandProfiler();
+
+    OperandProfiler(const OperandProfiler &) = delete;
+    OperandProfiler &operator=(const OperandProfiler &) = delete;
+
+    /**
+     * @brief Stops profiling and reorders the operands according to the counters.
+     *
+     * An operand with mean cost c that decides a fraction p of its evaluations is
+     * evaluated first if c / p is smaller than for the other operand, where p is
+     * estimated as (decisions + 1) / (evaluations + 2). Operations whose operands were
+     * not both evaluated keep their order. The order is stored atomically, so other
+     * threads may evaluate the geometry meanwhile.
+     *
+     * @return Counters by slot (operations in preorder)
+     */
+    std::vector<OperandCounters> finish();
+
+    /// Profiler recording on the calling thread, or nullptr
+    static OperandProfiler *active()
+    {
+        return recordingProfilers_.load(std::memory_order_relaxed) == 0 ? nullptr : current_;
+    }
+
+    /**
+     * @brief Returns the counters of an operation, or nullptr if it is not part of the profile.
+     *
+     * @param operation Evaluated operation
+     */
+    OperandCounters *counters(const AbsOperation *operation);
+
+    /// Geometry nodes visited since the profiler was started
+    std::uint64_t evaluations() const { return evaluations_; }
+
+    /// Counts visited geometry nodes
+    void addEvaluations(std::uint64_t count) { evaluations_ += count; }
+
+private:
+    /**
+     * @brief Deactivates the profiler and restores the previously active one.
+     */
+    void detach();
+
+    static inline thread_local OperandProfiler *current_ = nullptr;  ///< Profiler of the calling thread
+    static inline std::atomic<std::size_t> recordingProfilers_ { 0 };  ///< Profilers recording on any thread
+
+    std::vector<const AbsOperation *> operations_;                 ///< Profiled operations by slot
+    std::unordered_map<const AbsOperation *, std::size_t> slots_;  ///< Slot of every profiled operation
+    std::vector<OperandCounters> counters_;                        ///< Counters by slot
+    std::uint64_t evaluations_ = 0;                                ///< Geometry nodes visited so far
+    OperandProfiler *previous_;                                    ///< Profiler active before this one
+    bool recording_;                                               ///< Whether the profile is still recording
+};
+
+/**
+ * @brief Counts operand evaluations of an n-ary operation or a compiled program in the active profile.
+ *
+ * @param count Number of geometry nodes visited
+ */
+inline void countProfiledEvaluations(std::uint64_t count)
+{
+    if (OperandProfiler *profiler = OperandProfiler::active())
+        profiler->addEvaluations(count);
+}
+
+} // namespace implicit::detail
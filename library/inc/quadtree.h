@@ -8,34 +8,222 @@
  * for spatial subdivision of 2D implicit geometries.
  */
 
+#include "Cell2D.hpp"
+
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace implicit
 {
 
-/// Represents a 1D range [min, max]
-using Bounds = std::array<double, 2>;
+class AbsImplicitGeometry;
+class LeafSink;
 
-/// Represents a 2D rectangular cell as {x-bounds, y-bounds}
-using Cell2D = std::array<Bounds, 2>;
+/// Default number of seed points per axis used to probe a cell during partitioning
+constexpr int defaultNumberOfSeedPoints = 7;
 
-class AbsImplicitGeometry;
+/**
+ * @brief Strategy used to decide whether a cell is cut by the geometry boundary.
+ */
+enum class CutCriterion
+{
+    SeedPoints,  ///< Sample a regular grid of seed points (fast, may miss thin features)
+    Interval     ///< Conservative box classification via AbsImplicitGeometry::classify
+};
+
+/**
+ * @brief File format of the VTK output.
+ */
+enum class VtkFormat
+{
+    Ascii,  ///< Legacy ASCII VTK with four separate points per cell
+    Binary  ///< Legacy binary VTK with corner points shared between cells
+};
+
+/**
+ * @struct GeometryNodeStats
+ * @brief Evaluation count of a single node of a geometry tree.
+ */
+struct GeometryNodeStats
+{
+    const AbsImplicitGeometry *geometry;  ///< Node of the geometry tree
+    std::string type;                     ///< Class name of the node
+    int depth;                            ///< Depth of the node below the root geometry
+    std::size_t pointEvaluations;         ///< Points evaluated by inside and insideBatch
+};
+
+/**
+ * @struct QuadTreeStats
+ * @brief Counters and phase timings collected during quadtree generation.
+ *
+ * Only filled if the library is compiled with IMPLICIT_ENABLE_STATS; otherwise all
+ * values stay zero and no instrumentation code is generated. Cell counters may be
+ * updated concurrently by the partitioning threads.
+ */
+struct QuadTreeStats
+{
+    /// Number of levels with cell counters
+    static constexpr int maxLevels = 32;
+
+    std::array<std::atomic<std::size_t>, maxLevels> cellsPerLevel {};     ///< Cells tested for a cut
+    std::array<std::atomic<std::size_t>, maxLevels> cutCellsPerLevel {};  ///< Cells found to be cut
+    std::vector<GeometryNodeStats> geometryNodes;  ///< Evaluations per geometry node in preorder
+    double partitionSeconds = 0.0;  ///< Wall time of the partitioning
+    double collectSeconds = 0.0;    ///< Wall time of the leaf collection
+    double writeSeconds = 0.0;      ///< Wall time of the file output
+
+    /**
+     * @brief Returns the fraction of tested cells that were cut on a level.
+     *
+     * @param level Level of the cells
+     * @return Cut cells divided by tested cells, or 0 if no cell was tested
+     */
+    double cutRatio(int level) const;
+
+    /**
+     * @brief Resets all counters and timings to zero.
+     */
+    void reset();
+};
+
+/**
+ * @struct PartitionOptions
+ * @brief Tuning parameters for the quadtree partitioning.
+ *
+ * Since coarse cells are more likely to hide thin features between their seed points,
+ * `seedPointsPerLevel` allows denser sampling near the root, e.g. { 17, 13, 9 } followed
+ * by `numberOfSeedPoints` on all finer levels. The seed point cache requires a uniform
+ * count and is not used when `seedPointsPerLevel` is set.
+ *
+ * With `cacheSeedPoints`, seed coordinates are derived from their lattice index over the
+ * root cell instead of from the bounds of the sampled cell. Both can differ in the last
+ * bit, so a seed lying exactly on the boundary may be classified differently and the
+ * leaves can differ slightly from an uncached partition.
+ *
+ * With `profileDepth` > 0, the domain is first partitioned down to that depth while the
+ * operand evaluations of all binary CSG operations are profiled; each operation then
+ * evaluates first the operand that is cheaper per decided query (see OperandProfiler).
+ * The profiling pass runs on the calling thread. Profiling mutates the geometry even
+ * though it is passed as const: the order persists on the shared operation nodes and
+ * applies to every later evaluation, also by other partitions and threads using the
+ * same nodes. The order is stored atomically and never changes the leaves.
+ *
+ * With `singlePrecision`, seed points are classified in float, which doubles the vector
+ * width of the primitive kernels. Cells whose seed spacing approaches the float resolution
+ * of their coordinates fall back to double, see detail::useSinglePrecision. Points within
+ * a float rounding error of the boundary may be classified differently, so the leaves can
+ * differ slightly from a double precision partition.
+ */
+struct PartitionOptions
+{
+    CutCriterion cutCriterion = CutCriterion::SeedPoints;  ///< How cut cells are detected
+    bool distanceCulling = true;  ///< Skip cells whose center distance exceeds the half-diagonal
+    int numberOfSeedPoints = defaultNumberOfSeedPoints;  ///< Seed points per axis and cell
+    std::vector<int> seedPointsPerLevel;  ///< Seed points per axis by cell level (overrides numberOfSeedPoints where given)
+    bool earlyExit = true;        ///< Sample corners and center first and stop at the first disagreement
+    bool cacheSeedPoints = false; ///< Memoize seed evaluations on a lattice shared by all cells
+    unsigned numberOfThreads = 1; ///< Threads used for partitioning (0 selects the hardware concurrency)
+    int taskGranularity = 4;      ///< Subtrees with at most this many levels left run as one task
+    int profileDepth = 0;         ///< Levels of a profiling pass that reorders the CSG operands first (0 disables it)
+    bool singlePrecision = false; ///< Sample seed points in float down to the levels where float no longer resolves them
+    QuadTreeStats *stats = nullptr; ///< Receives statistics if compiled with IMPLICIT_ENABLE_STATS
+};
+
+/**
+ * @brief Error indicator ranking the cut cells during budgeted refinement.
+ */
+enum class RefinementPriority
+{
+    CellSize,       ///< Split the largest cut cell first
+    BoundaryLength  ///< Split the cut cell with the largest estimated boundary length times width first
+};
+
+/**
+ * @struct RefinementBudget
+ * @brief Limits of a best-first refinement.
+ *
+ * Instead of refining every cut cell down to a fixed depth, the cut cells are kept in a
+ * priority queue and the one with the largest error indicator is split next. Refinement
+ * stops when splitting would exceed the leaf budget, when the time budget is used up, or
+ * when no cut cell above `maxDepth` is left. Without limits, the leaves are the same as
+ * those of a depth-limited partition with the same options and without the seed point
+ * cache.
+ */
+struct RefinementBudget
+{
+    std::size_t maxLeaves = 0;  ///< Maximum number of leaves (0 for no limit)
+    double maxSeconds = 0.0;    ///< Maximum wall time of the refinement in seconds (0 for no limit)
+    int maxDepth = 16;          ///< Cells on this level are never split
+    RefinementPriority priority = RefinementPriority::CellSize;  ///< Order in which cut cells are split
+};
+
+/**
+ * @brief Partitions the domain depth-first and streams the leaves to a sink.
+ *
+ * No tree is built: finished leaves are collected in chunks of at most `leafChunkSize`
+ * and handed to the sink in depth-first order, so the memory use is bounded by the
+ * recursion depth and the chunk size. `sink.finish()` is called at the end. The
+ * partitioning runs on the calling thread; `numberOfThreads` is ignored. The seed
+ * point cache would grow with the number of leaves, so `cacheSeedPoints` is ignored too.
+ *
+ * @param geometry Implicit geometry used for subdivision criteria
+ * @param boundingBox Initial 2D bounding box of the quadtree domain
+ * @param maxDepth Maximum subdivision depth (controls resolution)
+ * @param sink Consumer of the leaves
+ * @param options Partitioning parameters
+ */
+void streamQuadTree(const AbsImplicitGeometry &geometry,
+                    Cell2D boundingBox,
+                    int maxDepth,
+                    LeafSink &sink,
+                    const PartitionOptions &options = {});
 
 /**
  * @brief Generates a quadtree over the given bounding box and geometry.
  *
  * The function performs recursive spatial subdivision up to a given depth and
  * exports the resulting cells as a `.vtk` file for visualization (e.g., with ParaView).
+ * Single-threaded ASCII output without the seed point cache is streamed without
+ * building the tree. All output paths report an output file that cannot be opened
+ * in the same way.
  *
  * @param geometry Implicit geometry used for subdivision criteria
  * @param boundingBox Initial 2D bounding box of the quadtree domain
  * @param maxDepth Maximum subdivision depth (controls resolution)
  * @param filename Output file path (should end with .vtk)
+ * @param options Partitioning parameters
+ * @param format File format of the VTK output
+ * @throws std::runtime_error if the output file cannot be opened
  */
 void generateQuadTree(const AbsImplicitGeometry &geometry,
                       Cell2D boundingBox,
                       int maxDepth,
-                      const std::string &filename);
+                      const std::string &filename,
+                      const PartitionOptions &options = {},
+                      VtkFormat format = VtkFormat::Ascii);
+
+/**
+ * @brief Generates a quadtree by best-first refinement within a budget and writes it to a VTK file.
+ *
+ * The output size is bounded by `budget.maxLeaves` rather than by a depth. See
+ * RefinementBudget. The refinement runs on the calling thread.
+ *
+ * @param geometry Implicit geometry used for subdivision criteria
+ * @param boundingBox Initial 2D bounding box of the quadtree domain
+ * @param budget Leaf, time and depth limits of the refinement
+ * @param filename Output file path (should end with .vtk)
+ * @param options Partitioning parameters
+ * @param format File format of the VTK output
+ * @throws std::runtime_error if the output file cannot be opened
+ */
+void generateQuadTree(const AbsImplicitGeometry &geometry,
+                      Cell2D boundingBox,
+                      const RefinementBudget &budget,
+                      const std::string &filename,
+                      const PartitionOptions &options = {},
+                      VtkFormat format = VtkFormat::Ascii);
 
 } // namespace implicit
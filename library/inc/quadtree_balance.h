@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @file quadtree_balance.h
+ * @brief Provides 2:1 balancing and face-neighbour tables for linear quadtrees.
+ *
+ * Both operate on leaves sorted by Morton code. Neighbour cells are found by adding or
+ * subtracting the cell extent directly on the codes and locating the result with a
+ * binary search, so no pairwise comparison of leaves is needed.
+ */
+
+#include "morton.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace implicit::detail
+{
+
+class LinearQuadTree;
+
+/**
+ * @brief Face of a cell shared with a neighbour.
+ */
+enum class Face : std::uint8_t
+{
+    Left,    ///< Neighbour with smaller x
+    Right,   ///< Neighbour with larger x
+    Bottom,  ///< Neighbour with smaller y
+    Top      ///< Neighbour with larger y
+};
+
+/**
+ * @struct NeighbourTable
+ * @brief Face neighbours of all leaves in compressed row storage.
+ *
+ * The neighbours of leaf i are `neighbours[offsets[i]]` to `neighbours[offsets[i + 1] - 1]`,
+ * grouped by face in the order of the Face enum. `faces` holds the shared face of every
+ * entry as seen from leaf i.
+ */
+struct NeighbourTable
+{
+    std::vector<std::size_t> offsets;     ///< Start of the neighbours of each leaf (size n + 1)
+    std::vector<std::size_t> neighbours;  ///< Leaf indices of the neighbours
+    std::vector<Face> faces;              ///< Shared face of each entry
+};
+
+/**
+ * @brief Refines leaves until face-adjacent leaves differ by at most one level.
+ *
+ * Levels are processed from the finest to the coarsest. For every leaf at level L, the
+ * face neighbours of its parent must be covered by leaves of at least level L - 1;
+ * coarser leaves are split down to that level. New leaves are always coarser than L, so
+ * a single pass per level suffices and the total cost is O(n log n) per level.
+ *
+ * @param codes Sorted Morton codes of leaves covering the domain (modified in place)
+ * @param levels Levels of the leaves (modified in place)
+ */
+void balanceLeaves(std::vector<MortonCode> &codes, std::vector<std::uint8_t> &levels);
+
+/**
+ * @brief Builds the face-neighbour table of a set of leaves covering the domain.
+ *
+ * @param codes Sorted Morton codes of the leaves
+ * @param levels Levels of the leaves
+ * @return Neighbours of every leaf in compressed row storage
+ */
+NeighbourTable buildNeighbourTable(const std::vector<MortonCode> &codes,
+                                   const std::vector<std::uint8_t> &levels);
+
+/**
+ * @brief Builds the face-neighbour table of a linear quadtree.
+ *
+ * @param tree Partitioned tree
+ * @return Neighbours of every leaf in compressed row storage
+ */
+NeighbourTable buildNeighbourTable(const LinearQuadTree &tree);
+
+} // namespace implicit::detail
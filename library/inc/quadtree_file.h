@@ -0,0 +1,126 @@
+#pragma once
+
+/**
+ * @file quadtree_file.h
+ * @brief Provides a compact binary file format for linear quadtrees and a memory-mapped reader.
+ *
+ * The file stores the leaves of a LinearQuadTree exactly as they are held in memory, so a
+ * reader can map the file and access the leaves in place:
+ *
+ * | Offset      | Content                                                        |
+ * |-------------|----------------------------------------------------------------|
+ * | 0           | Magic bytes `IMPQTREE`                                         |
+ * | 8           | Format version (uint32, currently 1)                           |
+ * | 12          | Byte order mark 0x01020304 (uint32)                            |
+ * | 16          | Root cell xmin, xmax, ymin, ymax (4 doubles)                   |
+ * | 48          | Number of leaves n (uint64)                                    |
+ * | 56          | Flags (uint32): bit 0 leaf states, bit 1 truncated refinement  |
+ * | 60          | Maximum depth of the partition (uint32)                        |
+ * | 64          | n Morton codes (uint64)                                        |
+ * | 64 + 8n     | n levels (uint8), zero-padded to a multiple of 8               |
+ * | ...         | n leaf states (uint8: 0 inside, 1 outside, 2 cut), if flagged  |
+ *
+ * All numbers are in the byte order of the writing machine. With 9 bytes per leaf (10 with
+ * states), the file is a fraction of the size of a VTK export and needs no parsing.
+ */
+
+#include "linear_quadtree.h"
+#include "mapped_file.h"
+
+#include <string>
+
+namespace implicit::detail
+{
+
+/// Version of the quadtree file format written by writeQuadTreeFile
+constexpr std::uint32_t quadTreeFileVersion = 1;
+
+/**
+ * @brief Writes the leaves of a linear quadtree, with their states if they were classified.
+ *
+ * @param tree Tree to write
+ * @param filename Path of the output file
+ * @throws std::runtime_error if the file cannot be written
+ */
+void writeQuadTreeFile(const LinearQuadTree &tree, const std::string &filename);
+
+/**
+ * @class MappedQuadTree
+ * @brief Read-only view of a quadtree file mapped into memory.
+ *
+ * Opening the file checks the header and the file size and validates the level and
+ * state of every leaf in a single pass, so corrupt files are rejected before any leaf is
+ * used. Codes and levels are accessed in place, without copying.
+ */
+class MappedQuadTree
+{
+public:
+    /**
+     * @brief Maps a quadtree file and checks its header, size, leaf levels and leaf states.
+     *
+     * @param filename Path of the quadtree file
+     * @throws std::runtime_error if the file cannot be mapped or is not a valid quadtree file
+     */
+    explicit MappedQuadTree(const std::string &filename);
+
+    /// Bounding box of the quadtree domain
+    Cell2D rootCell() const { return rootCell_; }
+
+    /// Number of leaves
+    std::size_t size() const { return size_; }
+
+    /// Maximum depth of the partition the leaves were written from
+    int maxDepth() const { return maxDepth_; }
+
+    /// Whether the leaves come from a refinement that stopped at its budget
+    bool truncated() const { return truncated_; }
+
+    /// Whether the file contains leaf states
+    bool hasStates() const { return states_ != nullptr; }
+
+    /// Morton codes of all leaves in ascending order (size() entries, inside the mapping)
+    const MortonCode *codes() const { return codes_; }
+
+    /// Levels of all leaves (size() entries, inside the mapping)
+    const std::uint8_t *levels() const { return levels_; }
+
+    /// Level of the leaf with the given index
+    unsigned int level(std::size_t index) const { return levels_[index]; }
+
+    /// Classification of the leaf with the given index (requires hasStates)
+    CellClassification state(std::size_t index) const { return static_cast<CellClassification>(states_[index]); }
+
+    /**
+     * @brief Derives the bounds of a leaf from its Morton code.
+     *
+     * @param index Index of the leaf
+     * @return Bounding box of the leaf, bitwise identical to that of the written tree
+     */
+    Cell2D cell(std::size_t index) const;
+
+    /**
+     * @brief Retrieves all leaf cells with their levels, e.g. for a VTK export.
+     *
+     * @return A pair of cell data and their corresponding levels
+     */
+    CellsAndLevels getLeafCells() const;
+
+    /**
+     * @brief Copies the leaves into a linear quadtree, e.g. for point location.
+     *
+     * @return Tree with the leaves, states, maximum depth and truncation flag of the file
+     */
+    LinearQuadTree toLinearQuadTree() const;
+
+private:
+    MappedFile file_;                      ///< Mapping of the whole file
+    Cell2D rootCell_;                      ///< Bounding box of the quadtree domain
+    std::size_t size_ = 0;                 ///< Number of leaves
+    int maxDepth_ = 0;                     ///< Maximum depth of the partition
+    bool truncated_ = false;               ///< Whether the refinement was truncated
+    const MortonCode *codes_ = nullptr;    ///< Leaf codes inside the mapping
+    const std::uint8_t *levels_ = nullptr; ///< Leaf levels inside the mapping
+    const std::uint8_t *states_ = nullptr; ///< Leaf states inside the mapping (nullptr if absent)
+};
+
+} // namespace implicit::detail
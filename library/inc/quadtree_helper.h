@@ -9,15 +9,28 @@
  */
 
 #include "quadtree.h"
+#include "AbsImplicitGeometry.hpp"
 #include <vector>
 #include <tuple>
+#include <type_traits>
+
+#ifdef IMPLICIT_ENABLE_STATS
+#include <chrono>
+#endif
 
 namespace implicit::detail
 {
 
+class SeedPointCache;
+class ThreadPool;
+
 /// A pair of quadtree leaf cells and their corresponding refinement levels
 using CellsAndLevels = std::pair<std::vector<Cell2D>, std::vector<unsigned int>>;
 
+/// Enables an overload only for static geometries (not derived from AbsImplicitGeometry)
+template<typename Geometry>
+using EnableIfStaticGeometry = std::enable_if_t<!std::is_base_of_v<AbsImplicitGeometry, Geometry>, int>;
+
 /**
  * @brief Subdivides a 2D rectangular cell into four quadrants.
  *
@@ -30,15 +43,375 @@ std::array<Cell2D, 4> subdivideCell(Cell2D cell);
  * @brief Determines whether the given cell intersects the boundary of an implicit geometry.
  *
  * Uses a number of seed points to probe inside the cell and detect boundary crossing.
+ * With early exit, the corners and the center are evaluated first, since they are most
+ * likely to disagree, and sampling stops as soon as inside and outside seeds were seen.
+ * The result does not depend on the order.
  *
  * @param cell Cell to check
  * @param geometry Implicit geometry for boundary check
  * @param numberOfSeedPoints Number of sample points along each axis
+ * @param earlyExit Whether to stop at the first disagreement
  * @return true if the boundary cuts through the cell, false otherwise
  */
 bool isCutByBoundary(Cell2D cell,
                      const AbsImplicitGeometry &geometry,
-                     int numberOfSeedPoints);
+                     int numberOfSeedPoints,
+                     bool earlyExit = false);
+
+/**
+ * @brief Determines whether the given cell intersects the boundary, sampling in the given precision.
+ *
+ * Same as the overload above, but the seed points are rounded to `Real` and evaluated with
+ * the matching insideBatch overload. Instantiated for float and double; the double version
+ * gives the same result as the overload above.
+ *
+ * @tparam Real Floating point type of the seed points (float or double)
+ * @param cell Cell to check
+ * @param geometry Implicit geometry for boundary check
+ * @param numberOfSeedPoints Number of sample points along each axis
+ * @param earlyExit Whether to stop at the first disagreement
+ * @return true if the boundary cuts through the cell, false otherwise
+ */
+template<typename Real>
+bool isCutByBoundary(Cell2D cell,
+                     const AbsImplicitGeometry &geometry,
+                     int numberOfSeedPoints,
+                     bool earlyExit = false);
+
+/// Smallest seed spacing, in float epsilons of the largest cell coordinate, sampled in single precision
+constexpr double minSinglePrecisionSpacing = 1024.0;
+
+/**
+ * @brief Checks whether the seed points of a cell are resolved well enough in single precision.
+ *
+ * Rounding a coordinate to float moves it by up to half a float epsilon relative to its
+ * magnitude. Far above that scale, the rounded seeds keep their spacing and order, so
+ * sampling in float only differs from double for seeds extremely close to the boundary.
+ * Cells whose seed spacing falls below minSinglePrecisionSpacing epsilons are sampled in double.
+ *
+ * @param cell Cell to sample
+ * @param numberOfSeedPoints Number of sample points along each axis
+ * @return true if the seed spacing is at least minSinglePrecisionSpacing float epsilons of the coordinates
+ */
+bool useSinglePrecision(Cell2D cell, int numberOfSeedPoints);
+
+/**
+ * @brief Checks whether the boundary cannot reach the cell by the signed distance at its center.
+ *
+ * @param cell Cell to check
+ * @param geometry Implicit geometry whose boundary is tested
+ * @return true if the distance magnitude exceeds the half-diagonal of the cell
+ */
+bool isFarFromBoundary(Cell2D cell, const AbsImplicitGeometry &geometry);
+
+/**
+ * @brief Determines whether the given cell intersects the boundary using the configured criterion.
+ *
+ * If distance culling is enabled, the signed distance at the cell center is evaluated first:
+ * when its magnitude exceeds the half-diagonal, the boundary cannot reach the cell.
+ * Otherwise, with CutCriterion::SeedPoints the seed grid of the cell level is sampled, and with
+ * CutCriterion::Interval the cell is classified as a whole, which never misses features
+ * smaller than the seed spacing.
+ *
+ * With `options.singlePrecision`, the seeds are sampled in float wherever useSinglePrecision
+ * allows it and in double on the finer levels. The seed point cache always samples in double.
+ *
+ * @param cell Cell to check
+ * @param geometry Implicit geometry for boundary check
+ * @param options Partitioning parameters selecting the criterion
+ * @param level Level of the cell, selecting the number of seed points
+ * @param cache Optional seed point cache used instead of direct sampling
+ * @return true if the boundary (possibly) cuts through the cell, false otherwise
+ */
+bool isCutByBoundary(Cell2D cell,
+                     const AbsImplicitGeometry &geometry,
+                     const PartitionOptions &options,
+                     int level = 0,
+                     SeedPointCache *cache = nullptr);
+
+/**
+ * @brief Estimates the length of the geometry boundary inside a cell.
+ *
+ * Counts the inside/outside changes along the rows and columns of the seed grid and
+ * applies the Cauchy-Crofton formula, i.e. a boundary of length L crosses a family of
+ * parallel lines with spacing h about 2L / (pi h) times.
+ *
+ * @param cell Cell to sample
+ * @param geometry Implicit geometry whose boundary is measured
+ * @param numberOfSeedPoints Number of sample points along each axis
+ * @return Estimated boundary length (0 if no seeds disagree)
+ */
+double estimateBoundaryLength(Cell2D cell,
+                              const AbsImplicitGeometry &geometry,
+                              int numberOfSeedPoints);
+
+/**
+ * @brief Estimates the boundary length inside a cell, sampling in the given precision.
+ *
+ * Same as the overload above, but the seed points are rounded to `Real` like in the
+ * matching isCutByBoundary instantiation. Instantiated for float and double.
+ *
+ * @tparam Real Floating point type of the seed points (float or double)
+ * @param cell Cell to sample
+ * @param geometry Implicit geometry whose boundary is measured
+ * @param numberOfSeedPoints Number of sample points along each axis
+ * @return Estimated boundary length (0 if no seeds disagree)
+ */
+template<typename Real>
+double estimateBoundaryLength(Cell2D cell,
+                              const AbsImplicitGeometry &geometry,
+                              int numberOfSeedPoints);
+
+/**
+ * @brief Estimates the boundary length inside a cell from the seeds of the cut test.
+ *
+ * Samples the same seeds as isCutByBoundary with CutCriterion::SeedPoints and the same
+ * options, but always the whole grid. The seed grid is connected, so the estimate is
+ * positive exactly if that cut test reports a cut, and one call serves as both the cut
+ * test and the error indicator. Cells culled by their distance have length 0.
+ *
+ * @param cell Cell to sample
+ * @param geometry Implicit geometry whose boundary is measured
+ * @param options Partitioning parameters selecting culling, seeds and precision
+ * @param level Level of the cell, selecting the number of seed points
+ * @return Estimated boundary length (0 if the cell is not cut)
+ */
+double estimateBoundaryLength(Cell2D cell,
+                              const AbsImplicitGeometry &geometry,
+                              const PartitionOptions &options,
+                              int level);
+
+/**
+ * @brief Returns the number of seed points per axis for cells of the given level.
+ */
+inline int seedPointsAtLevel(const PartitionOptions &options, int level)
+{
+    if (level >= 0 && static_cast<std::size_t>(level) < options.seedPointsPerLevel.size())
+        return options.seedPointsPerLevel[level];
+    return options.numberOfSeedPoints;
+}
+
+/**
+ * @brief Checks whether a seed point cache can serve a partition with the given options.
+ *
+ * @param options Partitioning parameters
+ * @param levels Number of levels below the root of the partition
+ */
+bool useSeedPointCache(const PartitionOptions &options, int levels);
+
+/**
+ * @brief Reorders the operands of the geometry by a profiled coarse partition of the cell.
+ *
+ * Does nothing if `options.profileDepth` is not positive. The profiling pass uses the
+ * remaining options, but runs on the calling thread and collects no statistics. The new
+ * order is stored on the (shared) geometry.
+ *
+ * @param geometry Implicit geometry whose binary operations are reordered
+ * @param cell Domain of the profiling pass
+ * @param options Partitioning parameters
+ */
+void profileOperandOrder(const AbsImplicitGeometry &geometry, Cell2D cell, const PartitionOptions &options);
+
+/**
+ * @brief Determines whether the given cell intersects the boundary of a static geometry.
+ *
+ * Overload for compile-time geometries (e.g. csg::Union<csg::Circle, csg::Rectangle>).
+ * The geometry type only needs a const `inside(double, double)` member, which is
+ * resolved statically and inlined into the seed point loop. Early exit visits the seeds
+ * in the same order as for dynamic geometries.
+ *
+ * @param cell Cell to check
+ * @param geometry Static implicit geometry for boundary check
+ * @param numberOfSeedPoints Number of sample points along each axis
+ * @param earlyExit Whether to stop at the first disagreement
+ * @return true if the boundary cuts through the cell, false otherwise
+ */
+template<typename Geometry, EnableIfStaticGeometry<Geometry> = 0>
+bool isCutByBoundary(Cell2D cell,
+                     const Geometry &geometry,
+                     int numberOfSeedPoints,
+                     bool earlyExit = false)
+{
+    double xmin = cell[0][0], xmax = cell[0][1];
+    double ymin = cell[1][0], ymax = cell[1][1];
+
+    int count = 0;
+    int evaluated = 0;
+
+    // Evaluates one seed and reports whether the seeds disagree so far
+    auto visit = [&](int i, int j)
+    {
+        double x = i / (numberOfSeedPoints - 1.0) * (xmax - xmin) + xmin;
+        double y = j / (numberOfSeedPoints - 1.0) * (ymax - ymin) + ymin;
+        count += geometry.inside(x, y);
+        ++evaluated;
+        return earlyExit && count != 0 && count != evaluated;
+    };
+
+    int last = numberOfSeedPoints - 1;
+    int center = numberOfSeedPoints % 2 ? last / 2 : -1;
+
+    auto isPriority = [&](int i, int j)
+    {
+        return earlyExit && (((i == 0 || i == last) && (j == 0 || j == last)) || (i == center && j == center));
+    };
+
+    if (earlyExit)
+    {
+        for (int i : { 0, last })
+            for (int j : { 0, last })
+                if (visit(i, j))
+                    return true;
+
+        if (center >= 0 && visit(center, center))
+            return true;
+    }
+
+    for (int i = 0; i < numberOfSeedPoints; ++i)
+        for (int j = 0; j < numberOfSeedPoints; ++j)
+            if (!isPriority(i, j) && visit(i, j))
+                return true;
+
+    return count != 0 && count != evaluated;
+}
+
+/**
+ * @brief Writes cells and their levels to a legacy ASCII VTK file.
+ *
+ * Every cell is written with its own four corner points.
+ *
+ * @param data Cells and their levels
+ * @param filename Output file path (should end with .vtk)
+ * @throws std::runtime_error if the output file cannot be opened
+ */
+void writeCellsToVtkFile(const CellsAndLevels &data, const std::string &filename);
+
+/**
+ * @brief Writes cells and their levels to a legacy binary VTK file.
+ *
+ * Corner points shared by adjacent cells are written once. The cells are expected to
+ * be leaves of a quadtree, so that all corners lie on the lattice of the finest level.
+ * Levels above 62 cannot be mapped to that lattice and are rejected.
+ *
+ * @param data Cells and their levels
+ * @param filename Output file path (should end with .vtk)
+ * @throws std::invalid_argument if a cell level exceeds 62
+ * @throws std::runtime_error if the output file cannot be opened
+ */
+void writeCellsToBinaryVtkFile(const CellsAndLevels &data, const std::string &filename);
+
+/**
+ * @brief Returns the region in which an edit of a primitive can change the geometry.
+ *
+ * Points outside both bounding boxes are outside the primitive before and after the
+ * edit, so CSG expressions containing it are unchanged there.
+ *
+ * @param before Primitive before the edit
+ * @param after Primitive after the edit
+ * @return Smallest box containing both bounding boxes
+ */
+Cell2D changedRegion(const AbsImplicitGeometry &before, const AbsImplicitGeometry &after);
+
+/**
+ * @brief Passes the result of a cut test through, counting it in the statistics if enabled.
+ *
+ * @param options Partitioning parameters holding the statistics
+ * @param level Level of the tested cell
+ * @param cut Result of the cut test
+ * @return The unchanged result of the cut test
+ */
+inline bool recordCut(const PartitionOptions &options, int level, bool cut)
+{
+#ifdef IMPLICIT_ENABLE_STATS
+    if (options.stats && level < QuadTreeStats::maxLevels)
+    {
+        options.stats->cellsPerLevel[level].fetch_add(1, std::memory_order_relaxed);
+        options.stats->cutCellsPerLevel[level].fetch_add(cut, std::memory_order_relaxed);
+    }
+#else
+    (void) options;
+    (void) level;
+#endif
+    return cut;
+}
+
+#ifdef IMPLICIT_ENABLE_STATS
+/**
+ * @class StatsScope
+ * @brief Measures the phases of a quadtree generation and the evaluations of the geometry.
+ *
+ * Evaluation counts of all geometry nodes are taken when the scope starts and the
+ * differences are stored in the statistics when it ends. All functions do nothing if
+ * no statistics are given.
+ */
+class StatsScope
+{
+public:
+    /**
+     * @brief Starts the first phase and records the current evaluation counts.
+     *
+     * @param geometry Root of the geometry tree
+     * @param stats Statistics to fill, or nullptr
+     */
+    StatsScope(const AbsImplicitGeometry &geometry, QuadTreeStats *stats);
+
+    /**
+     * @brief Stores the evaluations performed during the scope.
+     */
+    ~StatsScope();
+
+    /**
+     * @brief Ends the current phase and adds its duration to the given timing.
+     *
+     * Write time accumulated by a streaming sink during the phase is excluded.
+     *
+     * @param phase Timing member of QuadTreeStats receiving the duration
+     */
+    void lap(double QuadTreeStats::*phase);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const AbsImplicitGeometry &geometry_;        ///< Root of the geometry tree
+    QuadTreeStats *stats_;                       ///< Statistics to fill
+    std::vector<GeometryNodeStats> startNodes_;  ///< Evaluation counts at the start
+    Clock::time_point lastLap_;                  ///< End of the previous phase
+    double writeSecondsAtLastLap_;               ///< Write time at the end of the previous phase
+};
+
+/**
+ * @class WriteTimer
+ * @brief Adds the lifetime of the object to the write time of the statistics.
+ */
+class WriteTimer
+{
+public:
+    explicit WriteTimer(QuadTreeStats *stats)
+            : stats_(stats), start_(std::chrono::steady_clock::now())
+    { }
+
+    ~WriteTimer()
+    {
+        if (stats_)
+            stats_->writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    QuadTreeStats *stats_;                          ///< Statistics to fill, or nullptr
+    std::chrono::steady_clock::time_point start_;   ///< Creation time
+};
+
+/**
+ * @brief Lists all nodes of a geometry tree in preorder with their evaluation counts.
+ *
+ * Operations are descended into via AbsOperation and AbsNaryOperation; all other
+ * geometries are leaves.
+ *
+ * @param geometry Root of the geometry tree
+ * @param nodes Output list of nodes
+ */
+void collectGeometryNodes(const AbsImplicitGeometry &geometry, std::vector<GeometryNodeStats> &nodes);
+#endif
 
 /**
  * @class QuadTreeNode
@@ -61,10 +434,47 @@ public:
     /**
      * @brief Recursively partitions the node based on geometry boundary until max depth.
      *
+     * With more than one thread in the options, subtrees are partitioned in parallel on a
+     * work-stealing thread pool. The resulting tree is identical to the serial one.
+     *
      * @param geometry Implicit geometry used for boundary detection
      * @param maxDepth Maximum allowed subdivision depth
+     * @param options Partitioning parameters
+     */
+    void partition(const AbsImplicitGeometry &geometry, int maxDepth,
+                   const PartitionOptions &options = {});
+
+    /**
+     * @brief Recursively partitions the node based on a static geometry until max depth.
+     *
+     * Overload for compile-time geometries; see isCutByBoundary for the requirements.
+     * Static geometries only provide point queries, so the cells are always tested with
+     * seed points: `numberOfSeedPoints`, `seedPointsPerLevel`, `earlyExit` and `stats`
+     * are used, all other options are ignored and the partition runs on the calling thread.
+     *
+     * @param geometry Static implicit geometry used for boundary detection
+     * @param maxDepth Maximum allowed subdivision depth
+     * @param options Partitioning parameters
      */
-    void partition(const AbsImplicitGeometry &geometry, int maxDepth);
+    template<typename Geometry, EnableIfStaticGeometry<Geometry> = 0>
+    void partition(const Geometry &geometry, int maxDepth, const PartitionOptions &options = {});
+
+    /**
+     * @brief Re-partitions only the part of an existing tree overlapping a dirty region.
+     *
+     * Nodes whose cell does not touch the dirty region are kept as they are. Inside the
+     * region, cells are re-classified: leaves that became cut are refined and subtrees
+     * that are no longer cut are collapsed. If the geometry only changed inside the
+     * region, the result equals a fresh partition with the same options. The update
+     * runs on the calling thread.
+     *
+     * @param geometry Edited implicit geometry
+     * @param dirtyRegion Box containing all points whose inside state may have changed
+     * @param maxDepth Maximum allowed subdivision depth
+     * @param options Partitioning parameters
+     */
+    void update(const AbsImplicitGeometry &geometry, Cell2D dirtyRegion, int maxDepth,
+                const PartitionOptions &options = {});
 
     /**
      * @brief Retrieves all leaf cells (i.e., non-subdivided terminal nodes).
@@ -73,7 +483,63 @@ public:
      */
     CellsAndLevels getLeafCells() const;
 
+    /**
+     * @brief Finds the leaf containing a point by descending from this node.
+     *
+     * Points on an edge shared by two children belong to the child with the larger
+     * coordinates. The lookup costs O(depth).
+     *
+     * @param x X-coordinate of the point
+     * @param y Y-coordinate of the point
+     * @return Leaf containing the point, or nullptr if it lies outside the node
+     */
+    const QuadTreeNode *findLeaf(double x, double y) const;
+
+    /// Bounding box of the node
+    Cell2D cell() const { return cell_; }
+
+    /// Level of the node in the quadtree hierarchy
+    int level() const { return level_; }
+
+    /// Whether the node has no children
+    bool isLeaf() const { return children_.empty(); }
+
 private:
+    /**
+     * @brief Partitions the subtree on the calling thread.
+     *
+     * @param geometry Implicit geometry used for boundary detection
+     * @param maxDepth Maximum allowed subdivision depth
+     * @param options Partitioning parameters
+     */
+    void partitionSerial(const AbsImplicitGeometry &geometry, int maxDepth,
+                         const PartitionOptions &options);
+
+    /**
+     * @brief Partitions the subtree, spawning a task per child above the task granularity.
+     *
+     * The children of a node are created before any task starts, so the leaf order is
+     * the same as for the serial partition.
+     *
+     * @param geometry Implicit geometry used for boundary detection
+     * @param maxDepth Maximum allowed subdivision depth
+     * @param options Partitioning parameters
+     * @param pool Thread pool executing the subtree tasks
+     */
+    void partitionParallel(const AbsImplicitGeometry &geometry, int maxDepth,
+                           const PartitionOptions &options, ThreadPool &pool);
+
+    /**
+     * @brief Recursive implementation of partition sharing one seed point cache.
+     *
+     * @param geometry Implicit geometry used for boundary detection
+     * @param maxDepth Maximum allowed subdivision depth
+     * @param options Partitioning parameters
+     * @param cache Seed point cache, or nullptr to sample directly
+     */
+    void partitionRecursive(const AbsImplicitGeometry &geometry, int maxDepth,
+                            const PartitionOptions &options, SeedPointCache *cache);
+
     /**
      * @brief Helper function for recursively collecting leaf cells.
      *
@@ -86,4 +552,25 @@ private:
     int level_;                           ///< Level of this node in the tree
 };
 
+/**
+ * @brief Recursively partitions the node based on a static geometry.
+ */
+template<typename Geometry, EnableIfStaticGeometry<Geometry>>
+void QuadTreeNode::partition(const Geometry &geometry, int maxDepth, const PartitionOptions &options)
+{
+    if (level_ < maxDepth &&
+        recordCut(options, level_, isCutByBoundary(cell_, geometry, seedPointsAtLevel(options, level_),
+                                                   options.earlyExit)))
+    {
+        auto subCells = subdivideCell(cell_);
+        children_.reserve(4);
+
+        for (const auto &sub : subCells)
+        {
+            children_.emplace_back(sub, level_ + 1);
+            children_.back().partition(geometry, maxDepth, options);
+        }
+    }
+}
+
 } // namespace implicit::detail
@@ -0,0 +1,111 @@
+#pragma once
+
+/**
+ * @file quadtree_integration.h
+ * @brief Provides area, centroid and second moment integration over quadtree leaves.
+ *
+ * The inside region of the geometry is integrated leaf by leaf, as needed for finite-cell
+ * quadrature. Leaves classified as uniformly inside or outside are integrated exactly;
+ * cut leaves are divided into a regular grid of sub-cells whose centers are classified
+ * in batches, and every inside sub-cell contributes its exact moments.
+ */
+
+#include "Cell2D.hpp"
+
+#include <array>
+#include <vector>
+
+namespace implicit
+{
+class AbsImplicitGeometry;
+}
+
+namespace implicit::detail
+{
+
+/**
+ * @struct Moments
+ * @brief Integrals of 1, x, y, x², xy and y² over a region.
+ */
+struct Moments
+{
+    double area = 0.0;  ///< Integral of 1
+    double x = 0.0;     ///< Integral of x
+    double y = 0.0;     ///< Integral of y
+    double xx = 0.0;    ///< Integral of x²
+    double xy = 0.0;    ///< Integral of xy
+    double yy = 0.0;    ///< Integral of y²
+
+    /**
+     * @brief Adds the moments of a disjoint region.
+     */
+    Moments &operator+=(const Moments &other);
+
+    /**
+     * @brief Returns the centroid of the region.
+     *
+     * @return Centroid (x, y), or (0, 0) for an empty region
+     */
+    std::array<double, 2> centroid() const;
+
+    /**
+     * @brief Returns the second moments about the centroid.
+     *
+     * @return Central moments (xx, xy, yy), or zeros for an empty region
+     */
+    std::array<double, 3> centralSecondMoments() const;
+};
+
+/**
+ * @brief Computes the exact moments of an axis-aligned rectangle.
+ *
+ * @param cell Rectangle to integrate over
+ * @return Moments of the rectangle
+ */
+Moments cellMoments(Cell2D cell);
+
+/**
+ * @struct IntegrationOptions
+ * @brief Parameters of the leaf integration.
+ */
+struct IntegrationOptions
+{
+    int samplesPerAxis = 8;        ///< Sub-cells per axis of a cut leaf
+    unsigned numberOfThreads = 1;  ///< Threads used for the leaves (0 selects the hardware concurrency)
+};
+
+/**
+ * @struct IntegrationResult
+ * @brief Moments of the inside region per leaf and in total.
+ */
+struct IntegrationResult
+{
+    std::vector<Moments> leaves;  ///< Moments of the inside part of each leaf
+    Moments total;                ///< Sum over all leaves
+
+    /**
+     * @brief Returns the fraction of a leaf covered by the inside region.
+     *
+     * @param cells Leaves passed to integrateLeaves
+     * @param index Index of the leaf
+     */
+    double areaFraction(const std::vector<Cell2D> &cells, std::size_t index) const;
+};
+
+/**
+ * @brief Integrates the inside region of a geometry over a set of disjoint leaves.
+ *
+ * Each leaf is first classified with AbsImplicitGeometry::classify. The leaves are split
+ * into contiguous ranges that are processed on `options.numberOfThreads` threads; the
+ * total is summed in leaf order, so it does not depend on the number of threads.
+ *
+ * @param geometry Implicit geometry whose inside region is integrated
+ * @param cells Leaves, e.g. the first part of QuadTreeNode::getLeafCells
+ * @param options Integration parameters
+ * @return Moments per leaf and in total
+ */
+IntegrationResult integrateLeaves(const AbsImplicitGeometry &geometry,
+                                  const std::vector<Cell2D> &cells,
+                                  const IntegrationOptions &options = {});
+
+} // namespace implicit::detail
@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * @file scene_loader.h
+ * @brief Provides loading of CSG scenes from text and binary files.
+ *
+ * A text scene lists the CSG tree in postfix order, one token sequence per node:
+ *
+ *     # (circle ∩ rectangle) \ inner circle
+ *     circle 0 0 1.06
+ *     rectangle -1 -1 1 1
+ *     intersection
+ *     circle 0 0 0.65
+ *     difference
+ *
+ * `circle x y r` and `rectangle x1 y1 x2 y2` push a primitive, `union`, `intersection`
+ * and `difference` pop two operands and push their combination. Tokens are separated by
+ * whitespace, and `#` starts a comment that extends to the end of the line. The parser
+ * appends instructions and parameters directly to a CompiledGeometry program, so it
+ * allocates no memory per primitive; text files are mapped and parsed in place.
+ *
+ * The binary format stores such a program as it is held in memory:
+ *
+ * | Offset | Content                                                       |
+ * |--------|---------------------------------------------------------------|
+ * | 0      | Magic bytes `IMPSCENE`                                        |
+ * | 8      | Format version (uint32, currently 1)                          |
+ * | 12     | Byte order mark 0x01020304 (uint32)                           |
+ * | 16     | Number of instructions n (uint64)                             |
+ * | 24     | Number of parameters m (uint64)                               |
+ * | 32     | n instructions (one byte each), zero-padded to a multiple of 8 |
+ * | ...    | m parameters (double)                                          |
+ *
+ * All numbers are in the byte order of the writing machine. A CompiledGeometry owns its
+ * instruction and parameter vectors, so binary scenes are read straight into them rather
+ * than mapped: evaluating from a mapping would save this one copy, but would tie every
+ * geometry to the lifetime of its file mapping.
+ */
+
+#include "CompiledGeometry.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace implicit
+{
+
+/// Version of the binary scene format written by writeBinaryScene
+constexpr std::uint32_t binarySceneVersion = 1;
+
+/**
+ * @brief Parses a text scene.
+ *
+ * @param text Scene description
+ * @return Compiled geometry of the scene
+ * @throws std::runtime_error with the line number if the text is not a valid scene
+ */
+std::shared_ptr<CompiledGeometry> parseScene(std::string_view text);
+
+/**
+ * @brief Loads a text or binary scene file, detected by the magic bytes of the binary format.
+ *
+ * @param filename Path of the scene file
+ * @return Compiled geometry of the scene
+ * @throws std::runtime_error if the file cannot be read or is not a valid scene
+ */
+std::shared_ptr<CompiledGeometry> loadScene(const std::string &filename);
+
+/**
+ * @brief Writes the program of a compiled geometry as a binary scene file.
+ *
+ * @param geometry Compiled geometry without external geometries
+ * @param filename Path of the output file
+ * @throws std::invalid_argument if the program references external geometries
+ * @throws std::runtime_error if the file cannot be written
+ */
+void writeBinaryScene(const CompiledGeometry &geometry, const std::string &filename);
+
+} // namespace implicit
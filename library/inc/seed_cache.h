@@ -0,0 +1,92 @@
+#pragma once
+
+/**
+ * @file seed_cache.h
+ * @brief Provides a memoization table for seed point evaluations during partitioning.
+ *
+ * Seed points of a cell are snapped to an integer lattice spanned over the root cell at
+ * the resolution of the finest level. The seeds of a parent coincide with every other seed
+ * of its children, and neighbouring cells share their edge seeds, so each lattice point
+ * has to be evaluated only once per partition.
+ *
+ * A lattice point is evaluated at a coordinate computed from its index and the root
+ * cell, which may differ in the last bit from the coordinate that direct sampling
+ * computes from the cell bounds. Seeds exactly on the boundary may therefore be
+ * classified differently than without the cache.
+ */
+
+#include "quadtree.h"
+#include "AbsImplicitGeometry.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace implicit::detail
+{
+
+/**
+ * @class SeedPointCache
+ * @brief Open-addressing hash table mapping lattice points to inside flags.
+ *
+ * Each slot packs the lattice key and the inside flag into a single 64-bit word, so
+ * the table costs 8 bytes per slot at a load factor of at most one half. A size limit
+ * bounds the memory: once it is reached, new seeds are evaluated but no longer stored.
+ */
+class SeedPointCache
+{
+public:
+    /**
+     * @brief Constructs an empty cache for the lattice of the given root cell.
+     *
+     * @param rootCell Cell of the root node of the partition
+     * @param levels Number of levels below the root (maxDepth - root level)
+     * @param numberOfSeedPoints Number of sample points along each axis of a cell
+     * @param maxSize Maximum number of stored lattice points (0 for no limit)
+     */
+    SeedPointCache(Cell2D rootCell, int levels, int numberOfSeedPoints, std::size_t maxSize = 0);
+
+    /**
+     * @brief Checks whether a lattice with the given parameters fits into the key space.
+     *
+     * @param levels Number of levels below the root
+     * @param numberOfSeedPoints Number of sample points along each axis of a cell
+     * @return true if a cache can be constructed for these parameters
+     */
+    static bool isSupported(int levels, int numberOfSeedPoints);
+
+    /**
+     * @brief Determines whether the cell is cut, reusing cached seed evaluations.
+     *
+     * With early exit, the corners and the center are visited first and the test stops
+     * at the first disagreement, so later seeds may stay unevaluated.
+     *
+     * @param cell Cell to check (must be a descendant of the root cell)
+     * @param geometry Implicit geometry for boundary check
+     * @param earlyExit Whether to stop at the first disagreement
+     * @return true if some seed points are inside and some are outside
+     */
+    bool isCutByBoundary(Cell2D cell, const AbsImplicitGeometry &geometry, bool earlyExit = false);
+
+    /// Number of distinct lattice points evaluated so far
+    std::size_t size() const { return size_; }
+
+private:
+    /**
+     * @brief Looks up a key and returns its slot (occupied by the key or empty).
+     */
+    std::size_t findSlot(std::uint64_t key) const;
+
+    /**
+     * @brief Doubles the table capacity and rehashes all entries.
+     */
+    void grow();
+
+    std::vector<std::uint64_t> slots_;  ///< Packed (key << 1 | inside) entries
+    std::size_t size_;                  ///< Number of occupied slots
+    Cell2D rootCell_;                   ///< Root cell spanned by the lattice
+    std::uint64_t resolution_;          ///< Number of lattice intervals per axis
+    int numberOfSeedPoints_;            ///< Seed points per axis and cell
+    std::size_t maxSize_;               ///< Maximum number of occupied slots (0 for no limit)
+};
+
+} // namespace implicit::detail
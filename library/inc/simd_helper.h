@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file simd_helper.h
+ * @brief Provides vectorized point classification kernels for the primitive geometries.
+ *
+ * The kernels use AVX or SSE2 intrinsics when the compiler targets them and fall back
+ * to scalar code otherwise. All kernels produce exactly the same results as the scalar
+ * `inside` implementations of the corresponding primitives, evaluated in the precision
+ * of the kernel. The single precision kernels process twice as many points per vector.
+ */
+
+#include "AbsImplicitGeometry.hpp"
+
+#include <bitset>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Returns a mask with the lowest n bits set.
+ *
+ * @param n Number of points in the batch (at most maxBatchSize)
+ * @return Mask covering all points of the batch
+ */
+inline PointMask maskOfSize(std::size_t n)
+{
+    return n >= maxBatchSize ? ~PointMask(0) : (PointMask(1) << n) - 1;
+}
+
+/**
+ * @brief Counts the number of points flagged in a mask.
+ *
+ * @param mask Batch result mask
+ * @return Number of set bits
+ */
+inline std::size_t countPoints(PointMask mask)
+{
+    return std::bitset<maxBatchSize>(mask).count();
+}
+
+/**
+ * @brief Classifies a batch of points against a circle.
+ *
+ * @param cx X-coordinate of the circle center
+ * @param cy Y-coordinate of the circle center
+ * @param r Radius of the circle
+ * @param x X-coordinates of the points
+ * @param y Y-coordinates of the points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i lies inside or on the circle
+ */
+PointMask insideCircleBatch(double cx, double cy, double r,
+                            const double *x, const double *y, std::size_t n);
+
+/**
+ * @brief Classifies a batch of points against an axis-aligned rectangle.
+ *
+ * @param x1 Left boundary (min x)
+ * @param y1 Bottom boundary (min y)
+ * @param x2 Right boundary (max x)
+ * @param y2 Top boundary (max y)
+ * @param x X-coordinates of the points
+ * @param y Y-coordinates of the points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i lies inside or on the rectangle
+ */
+PointMask insideRectangleBatch(double x1, double y1, double x2, double y2,
+                               const double *x, const double *y, std::size_t n);
+
+/**
+ * @brief Classifies a batch of points against a circle in single precision.
+ *
+ * @see insideCircleBatch(double, double, double, const double *, const double *, std::size_t)
+ */
+PointMask insideCircleBatch(float cx, float cy, float r,
+                            const float *x, const float *y, std::size_t n);
+
+/**
+ * @brief Classifies a batch of points against an axis-aligned rectangle in single precision.
+ *
+ * @see insideRectangleBatch(double, double, double, double, const double *, const double *, std::size_t)
+ */
+PointMask insideRectangleBatch(float x1, float y1, float x2, float y2,
+                               const float *x, const float *y, std::size_t n);
+
+} // namespace implicit::detail
@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * @file stats_helper.h
+ * @brief Provides the switch and counters for the optional instrumentation.
+ *
+ * Statistics are only collected if the library is compiled with IMPLICIT_ENABLE_STATS
+ * (CMake option ENABLE_STATS). Otherwise `IMPLICIT_STATS(...)` expands to nothing and
+ * the counters are not part of any class.
+ */
+
+#include <atomic>
+#include <cstddef>
+
+#ifdef IMPLICIT_ENABLE_STATS
+#define IMPLICIT_STATS(statement) statement
+#else
+#define IMPLICIT_STATS(statement)
+#endif
+
+namespace implicit::detail
+{
+
+/**
+ * @class EvaluationCounter
+ * @brief Thread-safe event counter that is reset instead of copied.
+ *
+ * Allows classes holding a counter to stay copyable; a copy starts counting from zero.
+ */
+class EvaluationCounter
+{
+public:
+    EvaluationCounter() = default;
+
+    EvaluationCounter(const EvaluationCounter &)
+    { }
+
+    EvaluationCounter &operator=(const EvaluationCounter &)
+    {
+        return *this;
+    }
+
+    /// Adds n events
+    void add(std::size_t n) const { count_.fetch_add(n, std::memory_order_relaxed); }
+
+    /// Number of events counted so far
+    std::size_t value() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    mutable std::atomic<std::size_t> count_ { 0 };  ///< Number of events
+};
+
+} // namespace implicit::detail
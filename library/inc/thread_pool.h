@@ -0,0 +1,131 @@
+#pragma once
+
+/**
+ * @file thread_pool.h
+ * @brief Provides a small work-stealing thread pool for recursive task parallelism.
+ *
+ * Every thread owns a task deque. New tasks are pushed to the back of the spawning thread's
+ * deque and popped from the back again (depth-first, cache friendly), while idle threads
+ * steal from the front of other deques (breadth-first, large tasks). Threads waiting for a
+ * task group keep executing tasks, so nested spawning cannot deadlock.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace implicit::detail
+{
+
+/**
+ * @class TaskGroup
+ * @brief Tracks a set of spawned tasks that can be waited for together.
+ */
+class TaskGroup
+{
+private:
+    friend class ThreadPool;
+
+    std::atomic<std::size_t> pending_ { 0 };  ///< Number of unfinished tasks
+    std::exception_ptr exception_;            ///< First exception thrown by a task
+    std::mutex exceptionMutex_;               ///< Guards exception_
+};
+
+/**
+ * @class ThreadPool
+ * @brief Work-stealing pool executing tasks on a fixed number of threads.
+ *
+ * The thread calling `wait` participates in the execution, so a pool of size N starts
+ * N - 1 worker threads. Threads not owned by the pool share the deque of slot 0.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param numberOfThreads Total number of threads including the calling thread
+     *                        (0 selects the hardware concurrency)
+     */
+    explicit ThreadPool(std::size_t numberOfThreads);
+
+    /**
+     * @brief Stops and joins all worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Total number of threads including the calling thread
+    std::size_t size() const { return queues_.size(); }
+
+    /**
+     * @brief Schedules a task as part of the given group.
+     *
+     * @param group Group the task belongs to
+     * @param task Function to execute
+     */
+    void spawn(TaskGroup &group, std::function<void()> task);
+
+    /**
+     * @brief Executes pending tasks until all tasks of the group have finished.
+     *
+     * While no task is queued, the calling thread sleeps until a task is spawned or the
+     * last task of a group finishes.
+     *
+     * @param group Group to wait for
+     * @throws The first exception thrown by a task of the group
+     */
+    void wait(TaskGroup &group);
+
+private:
+    /// Task together with the group it belongs to
+    struct Task
+    {
+        std::function<void()> function;
+        TaskGroup *group;
+    };
+
+    /// Deque of tasks owned by one thread
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * @brief Returns the deque index of the calling thread.
+     */
+    std::size_t currentIndex() const;
+
+    /**
+     * @brief Pops a task from the own deque or steals one and executes it.
+     *
+     * @param index Deque index of the calling thread
+     * @return true if a task was executed
+     */
+    bool runOneTask(std::size_t index);
+
+    /**
+     * @brief Main loop of a worker thread.
+     *
+     * @param index Deque index of the worker
+     */
+    void workerLoop(std::size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues_;  ///< One deque per thread
+    std::vector<std::thread> workers_;            ///< Worker threads (slots 1 to N-1)
+    std::atomic<std::size_t> queuedTasks_ { 0 };  ///< Tasks waiting in any deque
+    std::atomic<bool> stop_ { false };            ///< Shutdown flag
+    std::mutex sleepMutex_;                       ///< Guards sleeping workers and waiters
+    std::condition_variable wakeup_;              ///< Signals new tasks, finished groups or shutdown
+};
+
+} // namespace implicit::detail
@@ -4,6 +4,9 @@
  */
 
 #include "AbsImplicitGeometry.hpp"
+#include "bounding_box_helper.h"
+
+#include <algorithm>
 
 namespace implicit
 {
@@ -16,4 +19,51 @@ namespace implicit
 AbsImplicitGeometry::~AbsImplicitGeometry()
 { }
 
+/**
+ * @brief Fallback batch query evaluating `inside` point by point.
+ */
+PointMask AbsImplicitGeometry::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    PointMask mask = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        mask |= PointMask(inside(x[i], y[i])) << i;
+    return mask;
+}
+
+/**
+ * @brief Fallback single precision batch query converting the points to double.
+ */
+PointMask AbsImplicitGeometry::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    double xs[maxBatchSize];
+    double ys[maxBatchSize];
+    std::copy(x, x + n, xs);
+    std::copy(y, y + n, ys);
+    return insideBatch(xs, ys, n);
+}
+
+/**
+ * @brief Conservative fallback classification reporting every cell as cut.
+ */
+CellClassification AbsImplicitGeometry::classify(Cell2D) const
+{
+    return CellClassification::Cut;
+}
+
+/**
+ * @brief Conservative fallback distance bound carrying no information.
+ */
+double AbsImplicitGeometry::distance(double, double) const
+{
+    return 0.0;
+}
+
+/**
+ * @brief Conservative fallback bounding box covering the whole plane.
+ */
+Cell2D AbsImplicitGeometry::boundingBox() const
+{
+    return detail::infiniteBox();
+}
+
 } // namespace implicit
@@ -0,0 +1,31 @@
+/**
+ * @file AbsNaryOperation.cpp
+ * @brief Implements the base class for n-ary boolean operations on implicit geometries.
+ */
+
+#include "AbsNaryOperation.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace implicit
+{
+
+/**
+ * @brief Stores the operands after checking that there is at least one valid operand.
+ */
+AbsNaryOperation::AbsNaryOperation(std::vector<ImplicitGeometryPtr> operands)
+        : operands_(std::move(operands))
+{
+    if (operands_.empty() ||
+        std::any_of(operands_.begin(), operands_.end(), [](const ImplicitGeometryPtr &operand) { return !operand; }))
+        throw std::invalid_argument("AbsNaryOperation: operands must be a non-empty list of geometries");
+}
+
+/**
+ * @brief Virtual destructor to enable proper polymorphic cleanup.
+ */
+AbsNaryOperation::~AbsNaryOperation()
+{ }
+
+} // namespace implicit
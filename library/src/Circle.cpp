@@ -4,6 +4,9 @@
  */
 
 #include "Circle.hpp"
+#include "distance_helper.h"
+#include "simd_helper.h"
+#include "classification_helper.h"
 #include <cmath>
 
 namespace implicit
@@ -31,9 +34,72 @@ Circle::Circle(double x, double y, double radius)
  */
 bool Circle::inside(double x, double y) const
 {
+    IMPLICIT_STATS(evaluations_.add(1));
     double dx = x - x_;
     double dy = y - y_;
     return (dx * dx + dy * dy) <= (r_ * r_);
 }
 
+/**
+ * @brief Checks a batch of points against the circle.
+ *
+ * Delegates to the vectorized circle kernel.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i lies inside or on the boundary
+ */
+PointMask Circle::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    return detail::insideCircleBatch(x_, y_, r_, x, y, n);
+}
+
+/**
+ * @brief Checks a batch of single precision points against the circle.
+ *
+ * The parameters are rounded to float and passed to the single precision kernel.
+ */
+PointMask Circle::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    return detail::insideCircleBatch(static_cast<float>(x_), static_cast<float>(y_),
+                                     static_cast<float>(r_), x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the circle.
+ *
+ * The cell is inside if its farthest point from the center is inside, and
+ * outside if its nearest point is outside.
+ *
+ * @param cell Cell to classify
+ * @return Inside, Outside or Cut
+ */
+CellClassification Circle::classify(Cell2D cell) const
+{
+    return detail::classifyCircle(x_, y_, r_, cell);
+}
+
+/**
+ * @brief Computes the signed distance to the circle boundary.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Distance to the center minus the radius
+ */
+double Circle::distance(double x, double y) const
+{
+    return detail::circleDistance(x_, y_, r_, x, y);
+}
+
+/**
+ * @brief Returns the axis-aligned square enclosing the circle.
+ */
+Cell2D Circle::boundingBox() const
+{
+    return { Bounds { x_ - r_, x_ + r_ }, Bounds { y_ - r_, y_ + r_ } };
+}
+
 } // namespace implicit
@@ -0,0 +1,504 @@
+/**
+ * @file CompiledGeometry.cpp
+ * @brief Implements the CSG compiler and the postfix program interpreter.
+ */
+
+#include "CompiledGeometry.hpp"
+#include "distance_helper.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Union.hpp"
+#include "Intersection.hpp"
+#include "Difference.hpp"
+#include "NaryUnion.hpp"
+#include "NaryIntersection.hpp"
+#include "IndexedUnion.hpp"
+#include "simd_helper.h"
+#include "classification_helper.h"
+#include "bounding_box_helper.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace implicit
+{
+
+namespace
+{
+
+/**
+ * @brief Maps a binary CSG node to its opcode.
+ *
+ * @return true if the node is one of the supported operations
+ */
+bool operationCode(const AbsImplicitGeometry &geometry, CompiledGeometry::OpCode &code)
+{
+    if (dynamic_cast<const Union *>(&geometry))
+        code = CompiledGeometry::OpCode::Union;
+    else if (dynamic_cast<const Intersection *>(&geometry))
+        code = CompiledGeometry::OpCode::Intersection;
+    else if (dynamic_cast<const Difference *>(&geometry))
+        code = CompiledGeometry::OpCode::Difference;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief Maps an n-ary CSG node to the opcode applied between consecutive operands.
+ *
+ * Indexed unions are not expanded, so that they keep answering queries through their index.
+ *
+ * @return true if the node is an n-ary union or intersection
+ */
+bool naryOperationCode(const AbsImplicitGeometry &geometry, CompiledGeometry::OpCode &code)
+{
+    if (dynamic_cast<const IndexedUnion *>(&geometry))
+        return false;
+    else if (dynamic_cast<const NaryUnion *>(&geometry))
+        code = CompiledGeometry::OpCode::Union;
+    else if (dynamic_cast<const NaryIntersection *>(&geometry))
+        code = CompiledGeometry::OpCode::Intersection;
+    else
+        return false;
+
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Compiles the tree into a postfix program.
+ *
+ * @param geometry Root of the CSG tree
+ * @throws std::invalid_argument if the geometry is null
+ * @throws std::length_error if the program needs more than maxStackDepth stack slots
+ */
+CompiledGeometry::CompiledGeometry(const ImplicitGeometryPtr &geometry)
+        : stackDepth_(0)
+{
+    if (!geometry)
+        throw std::invalid_argument("CompiledGeometry: geometry must not be null");
+
+    DepthMap depths;
+    stackDepth_ = computeDepths(geometry, depths);
+
+    if (stackDepth_ > maxStackDepth)
+        throw std::length_error("CompiledGeometry: CSG tree exceeds the maximum stack depth");
+
+    emit(geometry, depths);
+    singleParameters_.assign(parameters_.begin(), parameters_.end());
+    boundingBox_ = geometry->boundingBox();
+}
+
+/**
+ * @brief Checks the program by running it on bounding boxes, which also yields the box of the result.
+ *
+ * @param instructions Postfix instruction stream
+ * @param parameters Primitive parameters in program order
+ * @throws std::invalid_argument if the program is malformed or contains External instructions
+ * @throws std::length_error if the program needs more than maxStackDepth stack slots
+ */
+CompiledGeometry::CompiledGeometry(std::vector<OpCode> instructions, std::vector<double> parameters)
+        : code_(std::move(instructions)), parameters_(std::move(parameters)), stackDepth_(0)
+{
+    Cell2D stack[maxStackDepth];
+    std::size_t top = 0;
+    std::size_t consumed = 0;
+
+    auto push = [&](const Cell2D &box)
+    {
+        if (top == maxStackDepth)
+            throw std::length_error("CompiledGeometry: program exceeds the maximum stack depth");
+        stack[top++] = box;
+        stackDepth_ = std::max(stackDepth_, top);
+    };
+
+    auto take = [&](std::size_t count)
+    {
+        if (parameters_.size() - consumed < count)
+            throw std::invalid_argument("CompiledGeometry: program needs more parameters than given");
+        const double *p = parameters_.data() + consumed;
+        consumed += count;
+        return p;
+    };
+
+    for (OpCode code : code_)
+    {
+        if (code == OpCode::Circle)
+        {
+            const double *p = take(3);
+            push({ Bounds { p[0] - p[2], p[0] + p[2] }, Bounds { p[1] - p[2], p[1] + p[2] } });
+            continue;
+        }
+        if (code == OpCode::Rectangle)
+        {
+            const double *p = take(4);
+            push({ Bounds { p[0], p[2] }, Bounds { p[1], p[3] } });
+            continue;
+        }
+        if (code == OpCode::External)
+            throw std::invalid_argument("CompiledGeometry: program must not contain External instructions");
+        if (code > OpCode::ReverseDifference)
+            throw std::invalid_argument("CompiledGeometry: program contains an unknown instruction");
+        if (top < 2)
+            throw std::invalid_argument("CompiledGeometry: operation without two operands");
+
+        --top;
+        switch (code)
+        {
+            case OpCode::Union:
+                stack[top - 1] = detail::mergeBoxes(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Intersection:
+                stack[top - 1] = detail::intersectBoxes(stack[top - 1], stack[top]);
+                break;
+            case OpCode::ReverseDifference:
+                stack[top - 1] = stack[top];
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (top != 1)
+        throw std::invalid_argument("CompiledGeometry: program must leave exactly one result");
+    if (consumed != parameters_.size())
+        throw std::invalid_argument("CompiledGeometry: program leaves parameters unused");
+
+    singleParameters_.assign(parameters_.begin(), parameters_.end());
+    boundingBox_ = stack[0];
+}
+
+/**
+ * @brief Computes Sethi-Ullman numbers for all nodes of the tree.
+ *
+ * A primitive needs one slot. An operation needs the larger of its operand
+ * depths, or one more if both are equal. An n-ary operation folds its operands
+ * from the deepest one on, so each further operand needs one slot more than its depth.
+ */
+std::size_t CompiledGeometry::computeDepths(const ImplicitGeometryPtr &geometry, DepthMap &depths)
+{
+    auto found = depths.find(geometry.get());
+    if (found != depths.end())
+        return found->second;
+
+    std::size_t depth = 1;
+    OpCode code;
+    if (operationCode(*geometry, code))
+    {
+        const auto &operation = static_cast<const AbsOperation &>(*geometry);
+        std::size_t depth1 = computeDepths(operation.operand1(), depths);
+        std::size_t depth2 = computeDepths(operation.operand2(), depths);
+        depth = depth1 == depth2 ? depth1 + 1 : std::max(depth1, depth2);
+    }
+    else if (naryOperationCode(*geometry, code))
+    {
+        const auto &operation = static_cast<const AbsNaryOperation &>(*geometry);
+        std::vector<std::size_t> operandDepths;
+        for (const auto &operand : operation.operands())
+            operandDepths.push_back(computeDepths(operand, depths));
+
+        std::sort(operandDepths.begin(), operandDepths.end(), std::greater<>());
+        depth = operandDepths.front();
+        if (operandDepths.size() > 1)
+            depth = std::max(depth, operandDepths[1] + 1);
+    }
+
+    depths[geometry.get()] = depth;
+    return depth;
+}
+
+/**
+ * @brief Emits the subtree in postfix order, deeper operand first.
+ *
+ * If the second operand of a difference is emitted first, the operation is
+ * emitted as ReverseDifference so that the result is unchanged. N-ary operations
+ * are emitted as a chain of binary ones, starting with the deepest operand.
+ */
+void CompiledGeometry::emit(const ImplicitGeometryPtr &geometry, const DepthMap &depths)
+{
+    OpCode code;
+    if (operationCode(*geometry, code))
+    {
+        const auto &operation = static_cast<const AbsOperation &>(*geometry);
+        const auto &operand1 = operation.operand1();
+        const auto &operand2 = operation.operand2();
+
+        if (depths.at(operand2.get()) > depths.at(operand1.get()))
+        {
+            emit(operand2, depths);
+            emit(operand1, depths);
+            if (code == OpCode::Difference)
+                code = OpCode::ReverseDifference;
+        }
+        else
+        {
+            emit(operand1, depths);
+            emit(operand2, depths);
+        }
+
+        code_.push_back(code);
+    }
+    else if (naryOperationCode(*geometry, code))
+    {
+        auto operands = static_cast<const AbsNaryOperation &>(*geometry).operands();
+        std::stable_sort(operands.begin(), operands.end(),
+                         [&depths](const ImplicitGeometryPtr &a, const ImplicitGeometryPtr &b)
+                         {
+                             return depths.at(a.get()) > depths.at(b.get());
+                         });
+
+        emit(operands.front(), depths);
+        for (std::size_t i = 1; i < operands.size(); ++i)
+        {
+            emit(operands[i], depths);
+            code_.push_back(code);
+        }
+    }
+    else if (auto circle = dynamic_cast<const Circle *>(geometry.get()))
+    {
+        code_.push_back(OpCode::Circle);
+        parameters_.insert(parameters_.end(), { circle->centerX(), circle->centerY(), circle->radius() });
+    }
+    else if (auto rectangle = dynamic_cast<const Rectangle *>(geometry.get()))
+    {
+        code_.push_back(OpCode::Rectangle);
+        parameters_.insert(parameters_.end(),
+                           { rectangle->xMin(), rectangle->yMin(), rectangle->xMax(), rectangle->yMax() });
+    }
+    else
+    {
+        code_.push_back(OpCode::External);
+        externals_.push_back(geometry);
+    }
+}
+
+/**
+ * @brief Runs the program for a single point.
+ *
+ * The stack is a bit stack stored in one 64-bit word; the top of the stack is bit 0.
+ */
+bool CompiledGeometry::inside(double x, double y) const
+{
+    IMPLICIT_STATS(evaluations_.add(1));
+    // Every instruction but the root, which the caller counted
+    detail::countProfiledEvaluations(code_.size() - 1);
+    const double *p = parameters_.data();
+    auto external = externals_.begin();
+    std::uint64_t stack = 0;
+
+    for (OpCode code : code_)
+    {
+        switch (code)
+        {
+            case OpCode::Circle:
+            {
+                double dx = x - p[0];
+                double dy = y - p[1];
+                stack = (stack << 1) | ((dx * dx + dy * dy) <= (p[2] * p[2]));
+                p += 3;
+                break;
+            }
+            case OpCode::Rectangle:
+                stack = (stack << 1) | (x >= p[0] && x <= p[2] && y >= p[1] && y <= p[3]);
+                p += 4;
+                break;
+            case OpCode::External:
+                stack = (stack << 1) | (*external++)->inside(x, y);
+                break;
+            case OpCode::Union:
+                stack = (stack >> 2) << 1 | ((stack | (stack >> 1)) & 1);
+                break;
+            case OpCode::Intersection:
+                stack = (stack >> 2) << 1 | ((stack & (stack >> 1)) & 1);
+                break;
+            case OpCode::Difference:
+                stack = (stack >> 2) << 1 | ((~stack & (stack >> 1)) & 1);
+                break;
+            case OpCode::ReverseDifference:
+                stack = (stack >> 2) << 1 | ((stack & ~(stack >> 1)) & 1);
+                break;
+        }
+    }
+
+    return stack & 1;
+}
+
+/**
+ * @brief Runs the program once for a whole batch of points.
+ *
+ * Every stack slot holds the mask of a full batch, and primitives use the
+ * vectorized kernels.
+ */
+template<typename Real>
+PointMask CompiledGeometry::evaluateBatch(const Real *parameters, const Real *x, const Real *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    detail::countProfiledEvaluations(code_.size() - 1);
+    const Real *p = parameters;
+    auto external = externals_.begin();
+
+    PointMask stack[maxStackDepth];
+    std::size_t top = 0;
+
+    for (OpCode code : code_)
+    {
+        switch (code)
+        {
+            case OpCode::Circle:
+                stack[top++] = detail::insideCircleBatch(p[0], p[1], p[2], x, y, n);
+                p += 3;
+                break;
+            case OpCode::Rectangle:
+                stack[top++] = detail::insideRectangleBatch(p[0], p[1], p[2], p[3], x, y, n);
+                p += 4;
+                break;
+            case OpCode::External:
+                stack[top++] = (*external++)->insideBatch(x, y, n);
+                break;
+            case OpCode::Union:
+                --top;
+                stack[top - 1] |= stack[top];
+                break;
+            case OpCode::Intersection:
+                --top;
+                stack[top - 1] &= stack[top];
+                break;
+            case OpCode::Difference:
+                --top;
+                stack[top - 1] &= ~stack[top];
+                break;
+            case OpCode::ReverseDifference:
+                --top;
+                stack[top - 1] = stack[top] & ~stack[top - 1];
+                break;
+        }
+    }
+
+    return stack[0];
+}
+
+/**
+ * @brief Runs the program on a batch of double precision points.
+ */
+PointMask CompiledGeometry::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    return evaluateBatch(parameters_.data(), x, y, n);
+}
+
+/**
+ * @brief Runs the program on a batch of single precision points.
+ */
+PointMask CompiledGeometry::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    return evaluateBatch(singleParameters_.data(), x, y, n);
+}
+
+/**
+ * @brief Runs the program on cell classifications instead of point tests.
+ */
+CellClassification CompiledGeometry::classify(Cell2D cell) const
+{
+    const double *p = parameters_.data();
+    auto external = externals_.begin();
+
+    CellClassification stack[maxStackDepth];
+    std::size_t top = 0;
+
+    for (OpCode code : code_)
+    {
+        switch (code)
+        {
+            case OpCode::Circle:
+                stack[top++] = detail::classifyCircle(p[0], p[1], p[2], cell);
+                p += 3;
+                break;
+            case OpCode::Rectangle:
+                stack[top++] = detail::classifyRectangle(p[0], p[1], p[2], p[3], cell);
+                p += 4;
+                break;
+            case OpCode::External:
+                stack[top++] = (*external++)->classify(cell);
+                break;
+            case OpCode::Union:
+                --top;
+                stack[top - 1] = detail::uniteClassifications(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Intersection:
+                --top;
+                stack[top - 1] = detail::intersectClassifications(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Difference:
+                --top;
+                stack[top - 1] = detail::subtractClassifications(stack[top - 1], stack[top]);
+                break;
+            case OpCode::ReverseDifference:
+                --top;
+                stack[top - 1] = detail::subtractClassifications(stack[top], stack[top - 1]);
+                break;
+        }
+    }
+
+    return stack[0];
+}
+
+/**
+ * @brief Runs the program on signed distances, combining them with min/max.
+ */
+double CompiledGeometry::distance(double x, double y) const
+{
+    const double *p = parameters_.data();
+    auto external = externals_.begin();
+
+    double stack[maxStackDepth];
+    std::size_t top = 0;
+
+    for (OpCode code : code_)
+    {
+        switch (code)
+        {
+            case OpCode::Circle:
+                stack[top++] = detail::circleDistance(p[0], p[1], p[2], x, y);
+                p += 3;
+                break;
+            case OpCode::Rectangle:
+                stack[top++] = detail::rectangleDistance(p[0], p[1], p[2], p[3], x, y);
+                p += 4;
+                break;
+            case OpCode::External:
+                stack[top++] = (*external++)->distance(x, y);
+                break;
+            case OpCode::Union:
+                --top;
+                stack[top - 1] = std::min(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Intersection:
+                --top;
+                stack[top - 1] = std::max(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Difference:
+                --top;
+                stack[top - 1] = std::max(stack[top - 1], -stack[top]);
+                break;
+            case OpCode::ReverseDifference:
+                --top;
+                stack[top - 1] = std::max(stack[top], -stack[top - 1]);
+                break;
+        }
+    }
+
+    return stack[0];
+}
+
+/**
+ * @brief Returns the bounding box of the source tree.
+ */
+Cell2D CompiledGeometry::boundingBox() const
+{
+    return boundingBox_;
+}
+
+} // namespace implicit
@@ -4,6 +4,10 @@
  */
 
 #include "Difference.hpp"
+#include "classification_helper.h"
+#include "simd_helper.h"
+
+#include <algorithm>
 
 namespace implicit
 {
@@ -31,7 +35,83 @@ Difference::Difference(ImplicitGeometryPtr operand1,
  */
 bool Difference::inside(double x, double y) const
 {
-    return operand1_->inside(x, y) && !operand2_->inside(x, y);
+    IMPLICIT_STATS(evaluations_.add(1));
+    return evaluateOperands([&](const AbsImplicitGeometry &operand) { return operand.inside(x, y); },
+                            [](int operand, bool inside) { return operand == 0 ? !inside : inside; },
+                            [](bool inside1, bool inside2) { return inside1 && !inside2; });
+}
+
+/**
+ * @brief Checks a batch of points against the difference (A \ B) of the operands.
+ *
+ * Operand2 is skipped if operand1 contains none of the points, and operand1 is skipped
+ * if operand2 contains all of them.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i is inside operand1 and not inside operand2
+ */
+template<typename Real>
+PointMask Difference::evaluateBatch(const Real *x, const Real *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    PointMask full = detail::maskOfSize(n);
+    return evaluateOperands([&](const AbsImplicitGeometry &operand) { return operand.insideBatch(x, y, n); },
+                            [full](int operand, PointMask mask) { return operand == 0 ? mask == 0 : mask == full; },
+                            [](PointMask mask1, PointMask mask2) { return mask1 & ~mask2; });
+}
+
+/**
+ * @brief Checks a batch of points in double precision.
+ */
+PointMask Difference::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Checks a batch of points in single precision.
+ */
+PointMask Difference::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the difference (A \ B) of the operands.
+ *
+ * The second operand is skipped if the cell lies outside the first one.
+ *
+ * @param cell Cell to classify
+ * @return Inside, Outside or Cut
+ */
+CellClassification Difference::classify(Cell2D cell) const
+{
+    auto classification = operand1_->classify(cell);
+    if (classification == CellClassification::Outside)
+        return classification;
+    return detail::subtractClassifications(classification, operand2_->classify(cell));
+}
+
+/**
+ * @brief Computes a conservative signed distance to the difference (A \\ B).
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Signed distance bound
+ */
+double Difference::distance(double x, double y) const
+{
+    return std::max(operand1_->distance(x, y), -operand2_->distance(x, y));
+}
+
+/**
+ * @brief Returns the box of the first operand, since subtracting never adds points.
+ */
+Cell2D Difference::boundingBox() const
+{
+    return operand1_->boundingBox();
 }
 
 } // namespace implicit
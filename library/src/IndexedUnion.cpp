@@ -0,0 +1,436 @@
+/**
+ * @file IndexedUnion.cpp
+ * @brief Implements the grid-indexed union of many implicit geometries.
+ */
+
+#include "IndexedUnion.hpp"
+#include "classification_helper.h"
+#include "bounding_box_helper.h"
+#include "simd_helper.h"
+#include "operand_profile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace implicit
+{
+
+namespace
+{
+
+/// Maximum number of grid columns or rows
+constexpr int maxGridResolution = 2048;
+
+/// Operands covering more grid cells are visited by every query instead
+constexpr long long maxCellsPerOperand = 256;
+
+/**
+ * @brief Returns a box containing no points.
+ */
+Cell2D emptyBox()
+{
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    return { Bounds { inf, -inf }, Bounds { inf, -inf } };
+}
+
+/**
+ * @brief Checks whether all bounds of a box are finite.
+ */
+bool isFiniteBox(const Cell2D &box)
+{
+    return std::isfinite(box[0][0]) && std::isfinite(box[0][1]) &&
+           std::isfinite(box[1][0]) && std::isfinite(box[1][1]);
+}
+
+/**
+ * @brief Distance from a point to a closed box (zero inside).
+ */
+double boxDistance(double x, double y, const Cell2D &box)
+{
+    double dx = std::max({ box[0][0] - x, 0.0, x - box[0][1] });
+    double dy = std::max({ box[1][0] - y, 0.0, y - box[1][1] });
+    return std::hypot(dx, dy);
+}
+
+/**
+ * @brief Number of grid cells along an extent, proportional to its share of the domain.
+ */
+int gridResolution(double extent, double otherExtent, std::size_t numberOfOperands)
+{
+    if (!(extent > 0.0))
+        return 1;
+
+    double cells = otherExtent > 0.0 ? std::sqrt(static_cast<double>(numberOfOperands) * extent / otherExtent)
+                                     : static_cast<double>(numberOfOperands);
+
+    return static_cast<int>(std::clamp(std::round(cells), 1.0, static_cast<double>(maxGridResolution)));
+}
+
+} // namespace
+
+/**
+ * @brief Sorts the operand boxes into a grid with about one cell per indexed operand.
+ *
+ * Operands with an empty box can contain no point and are left out of all queries.
+ *
+ * @param operands Operand geometries
+ */
+IndexedUnion::IndexedUnion(std::vector<ImplicitGeometryPtr> operands)
+        : NaryUnion(std::move(operands)),
+          domain_(emptyBox()),
+          boundingBox_(emptyBox())
+{
+    std::vector<std::uint32_t> bounded;
+
+    boxes_.reserve(operands_.size());
+    for (std::size_t i = 0; i < operands_.size(); ++i)
+    {
+        boxes_.push_back(operands_[i]->boundingBox());
+        boundingBox_ = detail::mergeBoxes(boundingBox_, boxes_[i]);
+
+        if (detail::isEmptyBox(boxes_[i]))
+            continue;
+
+        if (isFiniteBox(boxes_[i]))
+        {
+            bounded.push_back(static_cast<std::uint32_t>(i));
+            domain_ = detail::mergeBoxes(domain_, boxes_[i]);
+        }
+        else
+        {
+            unindexed_.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+    if (bounded.empty())
+        return;
+
+    double width = domain_[0][1] - domain_[0][0];
+    double height = domain_[1][1] - domain_[1][0];
+
+    nx_ = gridResolution(width, height, bounded.size());
+    ny_ = gridResolution(height, width, bounded.size());
+    inverseWidth_ = width > 0.0 ? nx_ / width : 0.0;
+    inverseHeight_ = height > 0.0 ? ny_ / height : 0.0;
+
+    // Two passes over the operands: count the entries per grid cell, then fill them in
+    std::vector<std::uint32_t> indexed;
+    cellStart_.assign(static_cast<std::size_t>(nx_) * ny_ + 1, 0);
+
+    for (std::uint32_t operand : bounded)
+    {
+        const Cell2D &box = boxes_[operand];
+        int i0 = column(box[0][0]), i1 = column(box[0][1]);
+        int j0 = row(box[1][0]), j1 = row(box[1][1]);
+
+        if (static_cast<long long>(i1 - i0 + 1) * (j1 - j0 + 1) > maxCellsPerOperand)
+        {
+            unindexed_.push_back(operand);
+            continue;
+        }
+
+        indexed.push_back(operand);
+        for (int j = j0; j <= j1; ++j)
+            for (int i = i0; i <= i1; ++i)
+                ++cellStart_[static_cast<std::size_t>(j) * nx_ + i + 1];
+    }
+
+    for (std::size_t cell = 1; cell < cellStart_.size(); ++cell)
+        cellStart_[cell] += cellStart_[cell - 1];
+
+    std::vector<std::uint32_t> fill(cellStart_.begin(), cellStart_.end() - 1);
+    cellOperands_.resize(cellStart_.back());
+
+    for (std::uint32_t operand : indexed)
+    {
+        const Cell2D &box = boxes_[operand];
+        for (int j = row(box[1][0]); j <= row(box[1][1]); ++j)
+            for (int i = column(box[0][0]); i <= column(box[0][1]); ++i)
+                cellOperands_[fill[static_cast<std::size_t>(j) * nx_ + i]++] = operand;
+    }
+
+    std::sort(unindexed_.begin(), unindexed_.end());
+}
+
+/**
+ * @brief Maps an x-coordinate to its grid column; coordinates outside the grid map to the border.
+ */
+int IndexedUnion::column(double x) const
+{
+    double position = (x - domain_[0][0]) * inverseWidth_;
+    if (!(position >= 0.0))
+        return 0;
+    if (position >= nx_)
+        return nx_ - 1;
+    return static_cast<int>(position);
+}
+
+/**
+ * @brief Maps a y-coordinate to its grid row; coordinates outside the grid map to the border.
+ */
+int IndexedUnion::row(double y) const
+{
+    double position = (y - domain_[1][0]) * inverseHeight_;
+    if (!(position >= 0.0))
+        return 0;
+    if (position >= ny_)
+        return ny_ - 1;
+    return static_cast<int>(position);
+}
+
+/**
+ * @brief Visits the grid cells overlapping the query box.
+ *
+ * An operand listed in several of these cells is visited only in the first one, i.e. the
+ * cell at the larger of its own and the query's lowest column and row.
+ */
+template<typename Visit>
+void IndexedUnion::forEachOverlapping(const Cell2D &query, Visit visit) const
+{
+    if (nx_ == 0 || !detail::boxesOverlap(query, domain_))
+        return;
+
+    int i0 = column(query[0][0]), i1 = column(query[0][1]);
+    int j0 = row(query[1][0]), j1 = row(query[1][1]);
+
+    for (int j = j0; j <= j1; ++j)
+    {
+        for (int i = i0; i <= i1; ++i)
+        {
+            std::size_t cell = static_cast<std::size_t>(j) * nx_ + i;
+            for (std::uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k)
+            {
+                std::uint32_t operand = cellOperands_[k];
+                const Cell2D &box = boxes_[operand];
+
+                if (std::max(column(box[0][0]), i0) != i || std::max(row(box[1][0]), j0) != j)
+                    continue;
+
+                if (detail::boxesOverlap(box, query) && visit(operand))
+                    return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Checks the operands whose boxes contain the point until one contains the point.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return true if the point is inside at least one of the operands
+ */
+bool IndexedUnion::inside(double x, double y) const
+{
+    IMPLICIT_STATS(evaluations_.add(1));
+    return insidePoint(x, y);
+}
+
+/**
+ * @brief Point query shared by inside and insideBatch, without counting the evaluation.
+ *
+ * Single precision points are passed to the operands as batches of one point, so they
+ * are evaluated by the float kernels instead of being converted to double.
+ */
+template<typename Real>
+bool IndexedUnion::insidePoint(Real x, Real y) const
+{
+    auto insideOperand = [&](std::uint32_t operand)
+    {
+        if constexpr (std::is_same_v<Real, double>)
+            return operands_[operand]->inside(x, y);
+        else
+            return operands_[operand]->insideBatch(&x, &y, 1) != 0;
+    };
+
+    bool result = false;
+    std::size_t evaluated = 0;
+    forEachOverlapping({ Bounds { x, x }, Bounds { y, y } }, [&](std::uint32_t operand)
+    {
+        ++evaluated;
+        result = insideOperand(operand);
+        return result;
+    });
+
+    for (std::size_t i = 0; i < unindexed_.size() && !result; ++i, ++evaluated)
+        result = insideOperand(unindexed_[i]);
+
+    detail::countProfiledEvaluations(evaluated);
+    return result;
+}
+
+/**
+ * @brief Checks a batch of points against the operands overlapping the bounding box of the points.
+ *
+ * The remaining operands are skipped once all points are inside. Points spread over more
+ * grid cells than there are points are looked up one by one instead.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i is inside at least one operand
+ */
+template<typename Real>
+PointMask IndexedUnion::evaluateBatch(const Real *x, const Real *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    if (n == 0)
+        return 0;
+
+    Cell2D query { Bounds { x[0], x[0] }, Bounds { y[0], y[0] } };
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        query[0][0] = std::min(query[0][0], static_cast<double>(x[i]));
+        query[0][1] = std::max(query[0][1], static_cast<double>(x[i]));
+        query[1][0] = std::min(query[1][0], static_cast<double>(y[i]));
+        query[1][1] = std::max(query[1][1], static_cast<double>(y[i]));
+    }
+
+    PointMask mask = 0;
+
+    if (nx_ > 0)
+    {
+        long long cells = static_cast<long long>(column(query[0][1]) - column(query[0][0]) + 1) *
+                          (row(query[1][1]) - row(query[1][0]) + 1);
+        if (cells > static_cast<long long>(n))
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                mask |= static_cast<PointMask>(insidePoint(x[i], y[i])) << i;
+            return mask;
+        }
+    }
+
+    PointMask full = detail::maskOfSize(n);
+
+    std::size_t evaluated = 0;
+    forEachOverlapping(query, [&](std::uint32_t operand)
+    {
+        ++evaluated;
+        mask |= operands_[operand]->insideBatch(x, y, n);
+        return mask == full;
+    });
+
+    for (std::size_t i = 0; i < unindexed_.size() && mask != full; ++i, ++evaluated)
+        mask |= operands_[unindexed_[i]]->insideBatch(x, y, n);
+
+    detail::countProfiledEvaluations(evaluated);
+    return mask;
+}
+
+/**
+ * @brief Checks a batch of points in double precision.
+ */
+PointMask IndexedUnion::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Checks a batch of points in single precision.
+ */
+PointMask IndexedUnion::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the operands overlapping it; all other operands are outside.
+ *
+ * @param cell Cell to classify
+ * @return Inside, Outside or Cut
+ */
+CellClassification IndexedUnion::classify(Cell2D cell) const
+{
+    auto classification = CellClassification::Outside;
+
+    forEachOverlapping(cell, [&](std::uint32_t operand)
+    {
+        classification = detail::uniteClassifications(classification, operands_[operand]->classify(cell));
+        return classification == CellClassification::Inside;
+    });
+
+    for (std::size_t i = 0; i < unindexed_.size() && classification != CellClassification::Inside; ++i)
+        classification = detail::uniteClassifications(classification, operands_[unindexed_[i]]->classify(cell));
+
+    return classification;
+}
+
+/**
+ * @brief Computes a conservative signed distance to the union.
+ *
+ * The grid cells are searched in square rings around the cell nearest to the point. The
+ * search stops once no operand outside the searched square can be closer than the best
+ * distance found: with c the point clamped to the grid, any grid point q outside the
+ * square satisfies |p - q|^2 >= |p - c|^2 + |c - q|^2. Operands whose box is farther
+ * away than the best distance are skipped, since their distance cannot be smaller.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Signed distance bound
+ */
+double IndexedUnion::distance(double x, double y) const
+{
+    double best = std::numeric_limits<double>::infinity();
+    for (std::uint32_t operand : unindexed_)
+        best = std::min(best, operands_[operand]->distance(x, y));
+
+    if (nx_ == 0)
+        return best;
+
+    double cx = std::clamp(x, domain_[0][0], domain_[0][1]);
+    double cy = std::clamp(y, domain_[1][0], domain_[1][1]);
+    double offset2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+
+    double cellWidth = (domain_[0][1] - domain_[0][0]) / nx_;
+    double cellHeight = (domain_[1][1] - domain_[1][0]) / ny_;
+    int ci = column(cx), cj = row(cy);
+
+    auto visitCell = [&](int i, int j)
+    {
+        std::size_t cell = static_cast<std::size_t>(j) * nx_ + i;
+        for (std::uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k)
+        {
+            std::uint32_t operand = cellOperands_[k];
+            if (boxDistance(x, y, boxes_[operand]) <= std::max(best, 0.0))
+                best = std::min(best, operands_[operand]->distance(x, y));
+        }
+    };
+
+    for (int ring = 0; ; ++ring)
+    {
+        int i0 = ci - ring, i1 = ci + ring;
+        int j0 = cj - ring, j1 = cj + ring;
+
+        for (int j = std::max(j0, 0); j <= std::min(j1, ny_ - 1); ++j)
+        {
+            bool edgeRow = j == j0 || j == j1;
+            for (int i = std::max(i0, 0); i <= std::min(i1, nx_ - 1); ++i)
+                if (edgeRow || i == i0 || i == i1)
+                    visitCell(i, j);
+        }
+
+        // Distance from the clamped point to the grid cells not searched yet
+        double remaining = std::numeric_limits<double>::infinity();
+        if (i0 > 0) remaining = std::min(remaining, cx - (domain_[0][0] + i0 * cellWidth));
+        if (i1 < nx_ - 1) remaining = std::min(remaining, domain_[0][0] + (i1 + 1) * cellWidth - cx);
+        if (j0 > 0) remaining = std::min(remaining, cy - (domain_[1][0] + j0 * cellHeight));
+        if (j1 < ny_ - 1) remaining = std::min(remaining, domain_[1][0] + (j1 + 1) * cellHeight - cy);
+
+        if (std::isinf(remaining) || best <= std::sqrt(offset2 + remaining * remaining))
+            break;
+    }
+
+    return best;
+}
+
+/**
+ * @brief Returns the merged operand boxes computed at construction.
+ */
+Cell2D IndexedUnion::boundingBox() const
+{
+    return boundingBox_;
+}
+
+} // namespace implicit
@@ -4,6 +4,10 @@
  */
 
 #include "Intersection.hpp"
+#include "classification_helper.h"
+#include "bounding_box_helper.h"
+
+#include <algorithm>
 
 namespace implicit
 {
@@ -30,7 +34,81 @@ Intersection::Intersection(ImplicitGeometryPtr operand1,
  */
 bool Intersection::inside(double x, double y) const
 {
-    return operand1_->inside(x, y) && operand2_->inside(x, y);
+    IMPLICIT_STATS(evaluations_.add(1));
+    return evaluateOperands([&](const AbsImplicitGeometry &operand) { return operand.inside(x, y); },
+                            [](int, bool inside) { return !inside; },
+                            [](bool inside1, bool inside2) { return inside1 && inside2; });
+}
+
+/**
+ * @brief Checks a batch of points against the intersection of the operands.
+ *
+ * The second evaluated operand is skipped if the first one contains none of the points.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i is inside both operands
+ */
+template<typename Real>
+PointMask Intersection::evaluateBatch(const Real *x, const Real *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    return evaluateOperands([&](const AbsImplicitGeometry &operand) { return operand.insideBatch(x, y, n); },
+                            [](int, PointMask mask) { return mask == 0; },
+                            [](PointMask mask1, PointMask mask2) { return mask1 & mask2; });
+}
+
+/**
+ * @brief Checks a batch of points in double precision.
+ */
+PointMask Intersection::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Checks a batch of points in single precision.
+ */
+PointMask Intersection::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the intersection of the operands.
+ *
+ * The second operand is skipped if the cell lies outside the first one.
+ *
+ * @param cell Cell to classify
+ * @return Inside, Outside or Cut
+ */
+CellClassification Intersection::classify(Cell2D cell) const
+{
+    auto classification = operand1_->classify(cell);
+    if (classification == CellClassification::Outside)
+        return classification;
+    return detail::intersectClassifications(classification, operand2_->classify(cell));
+}
+
+/**
+ * @brief Computes a conservative signed distance to the intersection.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Signed distance bound
+ */
+double Intersection::distance(double x, double y) const
+{
+    return std::max(operand1_->distance(x, y), operand2_->distance(x, y));
+}
+
+/**
+ * @brief Intersects the operand boxes, since inside points lie in both.
+ */
+Cell2D Intersection::boundingBox() const
+{
+    return detail::intersectBoxes(operand1_->boundingBox(), operand2_->boundingBox());
 }
 
 } // namespace implicit
@@ -0,0 +1,126 @@
+/**
+ * @file NaryIntersection.cpp
+ * @brief Implements the CSG intersection of any number of implicit geometries.
+ */
+
+#include "NaryIntersection.hpp"
+#include "classification_helper.h"
+#include "bounding_box_helper.h"
+#include "operand_profile.h"
+
+#include <algorithm>
+
+namespace implicit
+{
+
+/**
+ * @brief Constructs the intersection of the given geometries.
+ *
+ * @param operands Operand geometries in evaluation order
+ */
+NaryIntersection::NaryIntersection(std::vector<ImplicitGeometryPtr> operands)
+        : AbsNaryOperation(std::move(operands))
+{ }
+
+/**
+ * @brief Checks the operands in order until one excludes the point.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return true if the point is inside all operands
+ */
+bool NaryIntersection::inside(double x, double y) const
+{
+    IMPLICIT_STATS(evaluations_.add(1));
+    std::size_t i = 0;
+    while (i < operands_.size() && operands_[i]->inside(x, y))
+        ++i;
+    detail::countProfiledEvaluations(std::min(i + 1, operands_.size()));
+    return i == operands_.size();
+}
+
+/**
+ * @brief Checks a batch of points against the intersection of the operands.
+ *
+ * The remaining operands are skipped once no point is inside.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i is inside all operands
+ */
+template<typename Real>
+PointMask NaryIntersection::evaluateBatch(const Real *x, const Real *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    PointMask mask = operands_.front()->insideBatch(x, y, n);
+    std::size_t i = 1;
+    for (; i < operands_.size() && mask != 0; ++i)
+        mask &= operands_[i]->insideBatch(x, y, n);
+    detail::countProfiledEvaluations(i);
+    return mask;
+}
+
+/**
+ * @brief Checks a batch of points in double precision.
+ */
+PointMask NaryIntersection::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Checks a batch of points in single precision.
+ */
+PointMask NaryIntersection::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the intersection of the operands.
+ *
+ * The remaining operands are skipped once the cell is known to be outside.
+ *
+ * @param cell Cell to classify
+ * @return Inside, Outside or Cut
+ */
+CellClassification NaryIntersection::classify(Cell2D cell) const
+{
+    auto classification = CellClassification::Inside;
+    for (const auto &operand : operands_)
+    {
+        classification = detail::intersectClassifications(classification, operand->classify(cell));
+        if (classification == CellClassification::Outside)
+            break;
+    }
+    return classification;
+}
+
+/**
+ * @brief Computes a conservative signed distance to the intersection.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Signed distance bound
+ */
+double NaryIntersection::distance(double x, double y) const
+{
+    double result = operands_.front()->distance(x, y);
+    for (std::size_t i = 1; i < operands_.size(); ++i)
+        result = std::max(result, operands_[i]->distance(x, y));
+    return result;
+}
+
+/**
+ * @brief Intersects the operand boxes, since inside points lie in all of them.
+ */
+Cell2D NaryIntersection::boundingBox() const
+{
+    Cell2D box = operands_.front()->boundingBox();
+    for (std::size_t i = 1; i < operands_.size(); ++i)
+        box = detail::intersectBoxes(box, operands_[i]->boundingBox());
+    return box;
+}
+
+} // namespace implicit
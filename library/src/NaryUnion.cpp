@@ -0,0 +1,132 @@
+/**
+ * @file NaryUnion.cpp
+ * @brief Implements the CSG union of any number of implicit geometries.
+ */
+
+#include "NaryUnion.hpp"
+#include "classification_helper.h"
+#include "bounding_box_helper.h"
+#include "simd_helper.h"
+#include "operand_profile.h"
+
+#include <algorithm>
+
+namespace implicit
+{
+
+/**
+ * @brief Constructs the union of the given geometries.
+ *
+ * @param operands Operand geometries in evaluation order
+ */
+NaryUnion::NaryUnion(std::vector<ImplicitGeometryPtr> operands)
+        : AbsNaryOperation(std::move(operands))
+{ }
+
+/**
+ * @brief Checks the operands in order until one contains the point.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return true if the point is inside at least one of the operands
+ */
+bool NaryUnion::inside(double x, double y) const
+{
+    IMPLICIT_STATS(evaluations_.add(1));
+    std::size_t i = 0;
+    while (i < operands_.size() && !operands_[i]->inside(x, y))
+        ++i;
+    detail::countProfiledEvaluations(std::min(i + 1, operands_.size()));
+    return i < operands_.size();
+}
+
+/**
+ * @brief Checks a batch of points against the union of the operands.
+ *
+ * The remaining operands are skipped once all points are inside.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i is inside at least one operand
+ */
+template<typename Real>
+PointMask NaryUnion::evaluateBatch(const Real *x, const Real *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    PointMask full = detail::maskOfSize(n);
+    PointMask mask = 0;
+    std::size_t evaluated = 0;
+    for (const auto &operand : operands_)
+    {
+        mask |= operand->insideBatch(x, y, n);
+        if (++evaluated, mask == full)
+            break;
+    }
+    detail::countProfiledEvaluations(evaluated);
+    return mask;
+}
+
+/**
+ * @brief Checks a batch of points in double precision.
+ */
+PointMask NaryUnion::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Checks a batch of points in single precision.
+ */
+PointMask NaryUnion::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the union of the operands.
+ *
+ * The remaining operands are skipped once the cell is known to be inside.
+ *
+ * @param cell Cell to classify
+ * @return Inside, Outside or Cut
+ */
+CellClassification NaryUnion::classify(Cell2D cell) const
+{
+    auto classification = CellClassification::Outside;
+    for (const auto &operand : operands_)
+    {
+        classification = detail::uniteClassifications(classification, operand->classify(cell));
+        if (classification == CellClassification::Inside)
+            break;
+    }
+    return classification;
+}
+
+/**
+ * @brief Computes a conservative signed distance to the union.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Signed distance bound
+ */
+double NaryUnion::distance(double x, double y) const
+{
+    double result = operands_.front()->distance(x, y);
+    for (std::size_t i = 1; i < operands_.size(); ++i)
+        result = std::min(result, operands_[i]->distance(x, y));
+    return result;
+}
+
+/**
+ * @brief Merges the operand boxes.
+ */
+Cell2D NaryUnion::boundingBox() const
+{
+    Cell2D box = operands_.front()->boundingBox();
+    for (std::size_t i = 1; i < operands_.size(); ++i)
+        box = detail::mergeBoxes(box, operands_[i]->boundingBox());
+    return box;
+}
+
+} // namespace implicit
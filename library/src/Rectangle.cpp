@@ -4,6 +4,9 @@
  */
 
 #include "Rectangle.hpp"
+#include "distance_helper.h"
+#include "simd_helper.h"
+#include "classification_helper.h"
 
 namespace implicit
 {
@@ -32,7 +35,67 @@ Rectangle::Rectangle(double x1, double y1, double x2, double y2)
  */
 bool Rectangle::inside(double x, double y) const
 {
+    IMPLICIT_STATS(evaluations_.add(1));
     return x >= x1_ && x <= x2_ && y >= y1_ && y <= y2_;
 }
 
+/**
+ * @brief Checks a batch of points against the rectangle.
+ *
+ * Delegates to the vectorized rectangle kernel.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i lies within or on the boundary
+ */
+PointMask Rectangle::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    return detail::insideRectangleBatch(x1_, y1_, x2_, y2_, x, y, n);
+}
+
+/**
+ * @brief Checks a batch of single precision points against the rectangle.
+ *
+ * The parameters are rounded to float and passed to the single precision kernel.
+ */
+PointMask Rectangle::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    return detail::insideRectangleBatch(static_cast<float>(x1_), static_cast<float>(y1_),
+                                        static_cast<float>(x2_), static_cast<float>(y2_), x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the rectangle.
+ *
+ * @param cell Cell to classify
+ * @return Inside if the cell is contained, Outside if it is disjoint, Cut otherwise
+ */
+CellClassification Rectangle::classify(Cell2D cell) const
+{
+    return detail::classifyRectangle(x1_, y1_, x2_, y2_, cell);
+}
+
+/**
+ * @brief Computes the signed distance to the rectangle boundary.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Signed distance (negative inside)
+ */
+double Rectangle::distance(double x, double y) const
+{
+    return detail::rectangleDistance(x1_, y1_, x2_, y2_, x, y);
+}
+
+/**
+ * @brief Returns the extent of the rectangle.
+ */
+Cell2D Rectangle::boundingBox() const
+{
+    return { Bounds { x1_, x2_ }, Bounds { y1_, y2_ } };
+}
+
 } // namespace implicit
@@ -4,6 +4,11 @@
  */
 
 #include "Union.hpp"
+#include "classification_helper.h"
+#include "bounding_box_helper.h"
+#include "simd_helper.h"
+
+#include <algorithm>
 
 namespace implicit
 {
@@ -30,7 +35,82 @@ Union::Union(ImplicitGeometryPtr operand1,
  */
 bool Union::inside(double x, double y) const
 {
-    return operand1_->inside(x, y) || operand2_->inside(x, y);
+    IMPLICIT_STATS(evaluations_.add(1));
+    return evaluateOperands([&](const AbsImplicitGeometry &operand) { return operand.inside(x, y); },
+                            [](int, bool inside) { return inside; },
+                            [](bool inside1, bool inside2) { return inside1 || inside2; });
+}
+
+/**
+ * @brief Checks a batch of points against the union of the operands.
+ *
+ * The second evaluated operand is skipped if the first one already contains all points.
+ *
+ * @param x X-coordinates of the query points
+ * @param y Y-coordinates of the query points
+ * @param n Number of points (at most maxBatchSize)
+ * @return Mask with bit i set if point i is inside at least one operand
+ */
+template<typename Real>
+PointMask Union::evaluateBatch(const Real *x, const Real *y, std::size_t n) const
+{
+    IMPLICIT_STATS(evaluations_.add(n));
+    PointMask full = detail::maskOfSize(n);
+    return evaluateOperands([&](const AbsImplicitGeometry &operand) { return operand.insideBatch(x, y, n); },
+                            [full](int, PointMask mask) { return mask == full; },
+                            [](PointMask mask1, PointMask mask2) { return mask1 | mask2; });
+}
+
+/**
+ * @brief Checks a batch of points in double precision.
+ */
+PointMask Union::insideBatch(const double *x, const double *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Checks a batch of points in single precision.
+ */
+PointMask Union::insideBatch(const float *x, const float *y, std::size_t n) const
+{
+    return evaluateBatch(x, y, n);
+}
+
+/**
+ * @brief Classifies a cell against the union of the operands.
+ *
+ * The second operand is skipped if the first one already contains the cell.
+ *
+ * @param cell Cell to classify
+ * @return Inside, Outside or Cut
+ */
+CellClassification Union::classify(Cell2D cell) const
+{
+    auto classification = operand1_->classify(cell);
+    if (classification == CellClassification::Inside)
+        return classification;
+    return detail::uniteClassifications(classification, operand2_->classify(cell));
+}
+
+/**
+ * @brief Computes a conservative signed distance to the union.
+ *
+ * @param x X-coordinate of the query point
+ * @param y Y-coordinate of the query point
+ * @return Signed distance bound
+ */
+double Union::distance(double x, double y) const
+{
+    return std::min(operand1_->distance(x, y), operand2_->distance(x, y));
+}
+
+/**
+ * @brief Merges the operand boxes.
+ */
+Cell2D Union::boundingBox() const
+{
+    return detail::mergeBoxes(operand1_->boundingBox(), operand2_->boundingBox());
 }
 
 } // namespace implicit
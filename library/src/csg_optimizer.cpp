@@ -0,0 +1,425 @@
+/**
+ * @file csg_optimizer.cpp
+ * @brief Implements flattening, hash-consing and operand ordering of CSG trees.
+ */
+
+#include "csg_optimizer.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Union.hpp"
+#include "Intersection.hpp"
+#include "Difference.hpp"
+#include "NaryUnion.hpp"
+#include "NaryIntersection.hpp"
+#include "IndexedUnion.hpp"
+#include "bounding_box_helper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace implicit
+{
+
+namespace
+{
+
+/// First operand of a Difference node
+const ImplicitGeometryPtr &operand1Of(const AbsImplicitGeometry &geometry)
+{
+    return static_cast<const Difference &>(geometry).operand1();
+}
+
+/// Second operand of a Difference node
+const ImplicitGeometryPtr &operand2Of(const AbsImplicitGeometry &geometry)
+{
+    return static_cast<const Difference &>(geometry).operand2();
+}
+
+/// Node types distinguished by the optimizer
+enum class NodeKind
+{
+    Circle,
+    Rectangle,
+    Union,
+    Intersection,
+    Difference,
+    External
+};
+
+/**
+ * @brief Determines the kind of a node; binary and n-ary operations share a kind.
+ *
+ * Indexed unions are kept as they are, since flattening would drop their index.
+ */
+NodeKind nodeKind(const AbsImplicitGeometry &geometry)
+{
+    if (dynamic_cast<const IndexedUnion *>(&geometry)) return NodeKind::External;
+    if (dynamic_cast<const Circle *>(&geometry)) return NodeKind::Circle;
+    if (dynamic_cast<const Rectangle *>(&geometry)) return NodeKind::Rectangle;
+    if (dynamic_cast<const Union *>(&geometry) || dynamic_cast<const NaryUnion *>(&geometry))
+        return NodeKind::Union;
+    if (dynamic_cast<const Intersection *>(&geometry) || dynamic_cast<const NaryIntersection *>(&geometry))
+        return NodeKind::Intersection;
+    if (dynamic_cast<const Difference *>(&geometry)) return NodeKind::Difference;
+    return NodeKind::External;
+}
+
+/**
+ * @brief Returns the operands of a union or intersection node.
+ */
+std::vector<ImplicitGeometryPtr> operandsOf(const AbsImplicitGeometry &geometry)
+{
+    if (auto operation = dynamic_cast<const AbsOperation *>(&geometry))
+        return { operation->operand1(), operation->operand2() };
+    return static_cast<const AbsNaryOperation &>(geometry).operands();
+}
+
+/**
+ * @brief Area of a box, infinite for unbounded boxes and zero for empty ones.
+ */
+double boxArea(const Cell2D &box)
+{
+    if (detail::isEmptyBox(box))
+        return 0.0;
+    return (box[0][1] - box[0][0]) * (box[1][1] - box[1][0]);
+}
+
+/**
+ * @class Optimizer
+ * @brief Rewrites a tree bottom-up, memoizing results per input and per structure.
+ */
+class Optimizer
+{
+public:
+    explicit Optimizer(const OptimizerOptions &options)
+            : options_(options)
+    { }
+
+    /**
+     * @brief Returns the optimized equivalent of an input node.
+     */
+    ImplicitGeometryPtr optimize(const ImplicitGeometryPtr &geometry)
+    {
+        auto found = optimized_.find(geometry.get());
+        if (found != optimized_.end())
+            return found->second;
+
+        ImplicitGeometryPtr result;
+        NodeKind kind = nodeKind(*geometry);
+
+        switch (kind)
+        {
+            case NodeKind::Union:
+            case NodeKind::Intersection:
+                result = combine(kind, collectOperands(kind, geometry));
+                break;
+            case NodeKind::Difference:
+                result = options_.flatten ? subtractChain(geometry) : subtract(optimize(operand1Of(*geometry)),
+                                                                             optimize(operand2Of(*geometry)));
+                break;
+            case NodeKind::Circle:
+            case NodeKind::Rectangle:
+            case NodeKind::External:
+                result = share(geometry, 1.0);
+                break;
+        }
+
+        optimized_[geometry.get()] = result;
+        return result;
+    }
+
+private:
+    /// Subtree information of an optimized node
+    struct NodeInfo
+    {
+        double cost;  ///< Number of nodes evaluated in the worst case
+        Cell2D box;   ///< Bounding box of the inside region
+    };
+
+    /**
+     * @brief Collects the optimized operands of a union or intersection.
+     *
+     * With flattening, nested nodes of the same kind are expanded iteratively, so deep
+     * chains do not recurse.
+     */
+    std::vector<ImplicitGeometryPtr> collectOperands(NodeKind kind, const ImplicitGeometryPtr &geometry)
+    {
+        std::vector<ImplicitGeometryPtr> operands;
+        std::vector<ImplicitGeometryPtr> pending = operandsOf(*geometry);
+        std::reverse(pending.begin(), pending.end());
+
+        while (!pending.empty())
+        {
+            ImplicitGeometryPtr operand = pending.back();
+            pending.pop_back();
+
+            if (options_.flatten && nodeKind(*operand) == kind)
+            {
+                auto nested = operandsOf(*operand);
+                pending.insert(pending.end(), nested.rbegin(), nested.rend());
+            }
+            else
+            {
+                operands.push_back(optimize(operand));
+            }
+        }
+
+        return operands;
+    }
+
+    /**
+     * @brief Builds the (shared) union or intersection of optimized operands.
+     */
+    ImplicitGeometryPtr combine(NodeKind kind, std::vector<ImplicitGeometryPtr> operands)
+    {
+        if (options_.flatten)
+        {
+            // Operands may have been simplified into a node of the same kind
+            std::vector<ImplicitGeometryPtr> flat;
+            for (const auto &operand : operands)
+            {
+                if (nodeKind(*operand) == kind)
+                {
+                    auto nested = operandsOf(*operand);
+                    flat.insert(flat.end(), nested.begin(), nested.end());
+                }
+                else
+                {
+                    flat.push_back(operand);
+                }
+            }
+            operands = std::move(flat);
+        }
+
+        if (options_.deduplicate)
+        {
+            // A ∪ A = A and A ∩ A = A; identical subtrees share one pointer after hash-consing
+            std::unordered_set<const AbsImplicitGeometry *> seen;
+            std::vector<ImplicitGeometryPtr> unique;
+            for (const auto &operand : operands)
+                if (seen.insert(operand.get()).second)
+                    unique.push_back(operand);
+            operands = std::move(unique);
+        }
+
+        if (operands.size() == 1)
+            return operands.front();
+
+        if (options_.reorder)
+            reorder(kind, operands);
+
+        double cost = 1.0;
+        for (const auto &operand : operands)
+            cost += info_.at(operand.get()).cost;
+
+        ImplicitGeometryPtr node;
+        if (!options_.flatten && operands.size() == 2)
+        {
+            if (kind == NodeKind::Union)
+                node = std::make_shared<Union>(operands[0], operands[1]);
+            else
+                node = std::make_shared<Intersection>(operands[0], operands[1]);
+        }
+        else if (kind == NodeKind::Union)
+        {
+            node = std::make_shared<NaryUnion>(operands);
+        }
+        else
+        {
+            node = std::make_shared<NaryIntersection>(operands);
+        }
+
+        return share(node, cost);
+    }
+
+    /**
+     * @brief Rewrites a chain ((a \ b) \ c) \ ... into a \ (b ∪ c ∪ ...).
+     *
+     * The chain is walked iteratively and all subtrahends are united in a single
+     * combine, so long generated chains take linear time and do not recurse.
+     */
+    ImplicitGeometryPtr subtractChain(const ImplicitGeometryPtr &geometry)
+    {
+        std::vector<ImplicitGeometryPtr> subtrahends;
+        ImplicitGeometryPtr minuend = geometry;
+
+        while (nodeKind(*minuend) == NodeKind::Difference && !optimized_.count(minuend.get()))
+        {
+            subtrahends.push_back(operand2Of(*minuend));
+            minuend = operand1Of(*minuend);
+        }
+
+        // Subtrahends in the order of the chain, from the innermost difference outwards
+        std::reverse(subtrahends.begin(), subtrahends.end());
+        for (auto &subtrahend : subtrahends)
+            subtrahend = optimize(subtrahend);
+
+        return subtract(optimize(minuend), combine(NodeKind::Union, std::move(subtrahends)));
+    }
+
+    /**
+     * @brief Builds the (shared) difference of two optimized operands.
+     *
+     * With flattening, (a \ b) \ c is rewritten to a \ (b ∪ c).
+     */
+    ImplicitGeometryPtr subtract(ImplicitGeometryPtr minuend, ImplicitGeometryPtr subtrahend)
+    {
+        if (options_.flatten && nodeKind(*minuend) == NodeKind::Difference)
+        {
+            const auto &inner = static_cast<const Difference &>(*minuend);
+            subtrahend = combine(NodeKind::Union, { inner.operand2(), subtrahend });
+            minuend = inner.operand1();
+        }
+
+        double cost = 1.0 + info_.at(minuend.get()).cost + info_.at(subtrahend.get()).cost;
+        return share(std::make_shared<Difference>(minuend, subtrahend), cost);
+    }
+
+    /**
+     * @brief Orders the operands by expected cost per decided query.
+     *
+     * An operand with cost c that decides a union with probability p (the point is
+     * inside) or an intersection with probability 1 - p (the point is outside) should
+     * come first if c / p, respectively c / (1 - p), is small. The sort is stable, so
+     * ties keep the input order.
+     */
+    void reorder(NodeKind kind, std::vector<ImplicitGeometryPtr> &operands) const
+    {
+        Cell2D domain = info_.at(operands.front().get()).box;
+        for (const auto &operand : operands)
+            domain = detail::mergeBoxes(domain, info_.at(operand.get()).box);
+
+        double domainArea = boxArea(domain);
+
+        auto rank = [&](const ImplicitGeometryPtr &operand)
+        {
+            const NodeInfo &info = info_.at(operand.get());
+            double area = boxArea(info.box);
+
+            double p = 0.5;
+            if (std::isfinite(domainArea) && domainArea > 0.0 && std::isfinite(area))
+                p = area / domainArea;
+
+            double decisive = kind == NodeKind::Union ? p : 1.0 - p;
+            return decisive > 0.0 ? info.cost / decisive : std::numeric_limits<double>::infinity();
+        };
+
+        std::vector<std::pair<double, ImplicitGeometryPtr>> ranked;
+        for (const auto &operand : operands)
+            ranked.emplace_back(rank(operand), operand);
+
+        std::stable_sort(ranked.begin(), ranked.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+        for (std::size_t i = 0; i < operands.size(); ++i)
+            operands[i] = ranked[i].second;
+    }
+
+    /**
+     * @brief Returns the canonical node structurally equal to the given one.
+     *
+     * Primitives are identified by their parameters, operations by their type and the
+     * canonical pointers of their operands (in sorted order for unions and intersections),
+     * and all other geometries by their address.
+     */
+    ImplicitGeometryPtr share(const ImplicitGeometryPtr &geometry, double cost)
+    {
+        if (options_.deduplicate)
+        {
+            auto inserted = canonical_.emplace(structureKey(*geometry), geometry);
+            if (!inserted.second)
+                return inserted.first->second;
+        }
+
+        info_.emplace(geometry.get(), NodeInfo { cost, geometry->boundingBox() });
+        return geometry;
+    }
+
+    /**
+     * @brief Serializes the type and the parameters or operand pointers of a node.
+     */
+    static std::string structureKey(const AbsImplicitGeometry &geometry)
+    {
+        std::string key;
+        auto append = [&key](const auto &value)
+        {
+            char bytes[sizeof(value)];
+            std::memcpy(bytes, &value, sizeof(value));
+            key.append(bytes, sizeof(value));
+        };
+
+        NodeKind kind = nodeKind(geometry);
+        key.push_back(static_cast<char>(kind));
+
+        switch (kind)
+        {
+            case NodeKind::Circle:
+            {
+                const auto &circle = static_cast<const Circle &>(geometry);
+                append(circle.centerX());
+                append(circle.centerY());
+                append(circle.radius());
+                break;
+            }
+            case NodeKind::Rectangle:
+            {
+                const auto &rectangle = static_cast<const Rectangle &>(geometry);
+                append(rectangle.xMin());
+                append(rectangle.yMin());
+                append(rectangle.xMax());
+                append(rectangle.yMax());
+                break;
+            }
+            case NodeKind::Union:
+            case NodeKind::Intersection:
+            {
+                std::vector<const AbsImplicitGeometry *> operands;
+                for (const auto &operand : operandsOf(geometry))
+                    operands.push_back(operand.get());
+                std::sort(operands.begin(), operands.end());
+                for (auto operand : operands)
+                    append(operand);
+                break;
+            }
+            case NodeKind::Difference:
+            {
+                const auto &difference = static_cast<const Difference &>(geometry);
+                append(difference.operand1().get());
+                append(difference.operand2().get());
+                break;
+            }
+            case NodeKind::External:
+                append(&geometry);
+                break;
+        }
+
+        return key;
+    }
+
+    OptimizerOptions options_;  ///< Rewrites to perform
+    std::unordered_map<const AbsImplicitGeometry *, ImplicitGeometryPtr> optimized_;  ///< Result per input node
+    std::unordered_map<std::string, ImplicitGeometryPtr> canonical_;  ///< Canonical node per structure
+    std::unordered_map<const AbsImplicitGeometry *, NodeInfo> info_;  ///< Cost and box per output node
+};
+
+} // namespace
+
+/**
+ * @brief Runs the rewriting pass on the tree.
+ */
+ImplicitGeometryPtr optimizeGeometry(const ImplicitGeometryPtr &geometry, const OptimizerOptions &options)
+{
+    if (!geometry)
+        throw std::invalid_argument("optimizeGeometry: geometry must not be null");
+
+    Optimizer optimizer(options);
+    return optimizer.optimize(geometry);
+}
+
+} // namespace implicit
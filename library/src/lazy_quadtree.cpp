@@ -0,0 +1,182 @@
+/**
+ * @file lazy_quadtree.cpp
+ * @brief Implements the on-demand quadtree with LRU eviction.
+ */
+
+#include "lazy_quadtree.h"
+#include "bounding_box_helper.h"
+
+#include <algorithm>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Constructs the tree without evaluating the geometry.
+ */
+LazyQuadTree::LazyQuadTree(const AbsImplicitGeometry &geometry, Cell2D rootCell, int maxDepth,
+                           const PartitionOptions &options, std::size_t memoryBudget)
+        : geometry_(geometry), options_(options), maxDepth_(maxDepth), memoryBudget_(memoryBudget),
+          numberOfNodes_(1), numberOfEvaluations_(0), accessCounter_(0)
+{
+    root_.cell = rootCell;
+}
+
+/**
+ * @brief Refines the window, collects its leaves and enforces the memory budget.
+ */
+CellsAndLevels LazyQuadTree::query(Cell2D window)
+{
+    ++accessCounter_;
+
+    CellsAndLevels data;
+    if (boxesOverlap(root_.cell, window))
+        queryRecursive(root_, window, data);
+
+    evict();
+    return data;
+}
+
+/**
+ * @brief Descends to the child containing the point, expanding nodes on the way.
+ */
+bool LazyQuadTree::locate(double x, double y, Cell2D &cell, unsigned int &level)
+{
+    const Cell2D &root = root_.cell;
+    if (!(x >= root[0][0] && x <= root[0][1] && y >= root[1][0] && y <= root[1][1]))
+        return false;
+
+    ++accessCounter_;
+
+    Node *node = &root_;
+    node->lastAccess = accessCounter_;
+
+    while (expand(*node))
+    {
+        const Cell2D &upper = node->children[3].cell;
+        int child = (x >= upper[0][0] ? 2 : 0) + (y >= upper[1][0] ? 1 : 0);
+        node = &node->children[child];
+        node->lastAccess = accessCounter_;
+    }
+
+    cell = node->cell;
+    level = static_cast<unsigned int>(node->level);
+
+    evict();
+    return true;
+}
+
+/**
+ * @brief Runs the cut test once per node and (re)creates evicted children without retesting.
+ */
+bool LazyQuadTree::expand(Node &node)
+{
+    if (node.refinement == Refinement::Unknown)
+    {
+        ++numberOfEvaluations_;
+        bool cut = node.level < maxDepth_ &&
+                   recordCut(options_, node.level, isCutByBoundary(node.cell, geometry_, options_, node.level));
+        node.refinement = cut ? Refinement::Cut : Refinement::Leaf;
+    }
+
+    if (node.refinement == Refinement::Leaf)
+        return false;
+
+    if (node.children.empty())
+    {
+        auto subCells = subdivideCell(node.cell);
+        node.children.resize(4);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            node.children[i].cell = subCells[i];
+            node.children[i].level = node.level + 1;
+        }
+
+        numberOfNodes_ += 4;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Depth-first traversal restricted to children overlapping the window.
+ */
+void LazyQuadTree::queryRecursive(Node &node, const Cell2D &window, CellsAndLevels &data)
+{
+    node.lastAccess = accessCounter_;
+
+    if (!expand(node))
+    {
+        data.first.push_back(node.cell);
+        data.second.push_back(static_cast<unsigned int>(node.level));
+        return;
+    }
+
+    for (auto &child : node.children)
+        if (boxesOverlap(child.cell, window))
+            queryRecursive(child, window, data);
+}
+
+/**
+ * @brief Collapses the coldest subtrees down to three quarters of the budget.
+ *
+ * Ancestors are visited whenever a descendant is, so their access counter is never
+ * older. Sorting by age and then by decreasing level therefore collapses descendants
+ * before their ancestors, and no collapsed node is accessed afterwards.
+ */
+void LazyQuadTree::evict()
+{
+    if (memoryBudget_ == 0 || memoryUsage() <= memoryBudget_)
+        return;
+
+    std::vector<Node *> candidates;
+    collectExpanded(root_, candidates);
+
+    std::sort(candidates.begin(), candidates.end(), [](const Node *a, const Node *b)
+    {
+        if (a->lastAccess != b->lastAccess)
+            return a->lastAccess < b->lastAccess;
+        return a->level > b->level;
+    });
+
+    std::size_t lowWaterMark = memoryBudget_ / 4 * 3;
+
+    for (Node *node : candidates)
+    {
+        if (memoryUsage() <= lowWaterMark)
+            break;
+
+        numberOfNodes_ -= countDescendants(*node);
+        node->children.clear();
+        node->children.shrink_to_fit();
+    }
+}
+
+/**
+ * @brief Gathers refined nodes from earlier queries in depth-first order.
+ */
+void LazyQuadTree::collectExpanded(Node &node, std::vector<Node *> &nodes) const
+{
+    if (node.children.empty())
+        return;
+
+    if (node.lastAccess != accessCounter_)
+        nodes.push_back(&node);
+
+    for (auto &child : node.children)
+        collectExpanded(child, nodes);
+}
+
+/**
+ * @brief Recursively counts the nodes of all subtrees below the node.
+ */
+std::size_t LazyQuadTree::countDescendants(const Node &node)
+{
+    std::size_t count = node.children.size();
+    for (const auto &child : node.children)
+        count += countDescendants(child);
+    return count;
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,47 @@
+/**
+ * @file leaf_sink.cpp
+ * @brief Implements the in-memory and callback leaf sinks.
+ */
+
+#include "leaf_sink.h"
+
+namespace implicit
+{
+
+/**
+ * @brief Virtual destructor for LeafSink.
+ */
+LeafSink::~LeafSink()
+{ }
+
+/**
+ * @brief Default end-of-stream handler doing nothing.
+ */
+void LeafSink::finish()
+{ }
+
+/**
+ * @brief Appends the chunk to the collected leaves.
+ */
+void LeafBuffer::consume(const Cell2D *cells, const unsigned int *levels, std::size_t n)
+{
+    cells_.insert(cells_.end(), cells, cells + n);
+    levels_.insert(levels_.end(), levels, levels + n);
+}
+
+/**
+ * @brief Constructs a sink calling the given function for each chunk.
+ */
+LeafCallback::LeafCallback(Function function)
+        : function_(std::move(function))
+{ }
+
+/**
+ * @brief Forwards the chunk to the callback.
+ */
+void LeafCallback::consume(const Cell2D *cells, const unsigned int *levels, std::size_t n)
+{
+    function_(cells, levels, n);
+}
+
+} // namespace implicit
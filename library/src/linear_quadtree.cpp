@@ -0,0 +1,447 @@
+/**
+ * @file linear_quadtree.cpp
+ * @brief Implements the pointerless Morton-code quadtree.
+ */
+
+#include "linear_quadtree.h"
+#include "quadtree_balance.h"
+#include "seed_cache.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Constructs a tree whose single leaf is the root cell.
+ */
+LinearQuadTree::LinearQuadTree(Cell2D rootCell)
+        : rootCell_(rootCell), codes_{ 0 }, levels_{ 0 }, maxDepth_(0), truncated_(false)
+{ }
+
+/**
+ * @brief Replaces the leaves by a fresh partition of the root cell.
+ */
+void LinearQuadTree::partition(const AbsImplicitGeometry &geometry, int maxDepth,
+                               const PartitionOptions &options)
+{
+    if (maxDepth > maxMortonLevel)
+        throw std::invalid_argument("LinearQuadTree: maxDepth exceeds the Morton code resolution");
+
+    profileOperandOrder(geometry, rootCell_, options);
+
+    Leaves leaves;
+
+    if (options.numberOfThreads == 1)
+    {
+        partitionSerial(geometry, rootCell_, 0, 0, maxDepth, options, leaves);
+    }
+    else
+    {
+        ThreadPool pool(options.numberOfThreads);
+        partitionParallel(geometry, rootCell_, 0, 0, maxDepth, options, pool, leaves);
+    }
+
+    codes_ = std::move(leaves.codes);
+    levels_ = std::move(leaves.levels);
+    states_.clear();
+    maxDepth_ = maxDepth;
+    truncated_ = false;
+}
+
+namespace
+{
+
+/// Cut cell waiting to be split by the best-first refinement
+struct Candidate
+{
+    double priority;   ///< Error indicator
+    MortonCode code;   ///< Morton code of the cell
+    int level;         ///< Level of the cell
+    Cell2D cell;       ///< Bounding box of the cell
+};
+
+/// Orders the queue by descending priority and ascending code
+struct CandidateOrder
+{
+    bool operator()(const Candidate &a, const Candidate &b) const
+    {
+        return a.priority < b.priority || (a.priority == b.priority && a.code > b.code);
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Splits the queued cut cell with the largest error indicator until the budget is reached.
+ */
+void LinearQuadTree::refine(const AbsImplicitGeometry &geometry, const RefinementBudget &budget,
+                            const PartitionOptions &options)
+{
+    if (budget.maxDepth > maxMortonLevel)
+        throw std::invalid_argument("LinearQuadTree: maxDepth exceeds the Morton code resolution");
+
+    profileOperandOrder(geometry, rootCell_, options);
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    bool byBoundaryLength = budget.priority == RefinementPriority::BoundaryLength;
+
+    // The sampled boundary length decides the cut as well, so the seeds are sampled once
+    bool lengthIsCutTest = byBoundaryLength && options.cutCriterion == CutCriterion::SeedPoints;
+
+    // Only a leaf budget bounds the cache: a cell adds at most (n - 1)^2 new lattice points
+    std::unique_ptr<SeedPointCache> cache;
+    if (!lengthIsCutTest && budget.maxLeaves != 0 && useSeedPointCache(options, budget.maxDepth))
+    {
+        auto intervals = static_cast<std::size_t>(options.numberOfSeedPoints - 1);
+        cache = std::make_unique<SeedPointCache>(rootCell_, budget.maxDepth, options.numberOfSeedPoints,
+                                                 budget.maxLeaves * intervals * intervals);
+    }
+
+    std::vector<std::pair<MortonCode, std::uint8_t>> leaves;
+    std::priority_queue<Candidate, std::vector<Candidate>, CandidateOrder> queue;
+
+    if (budget.maxLeaves != 0)
+        leaves.reserve(budget.maxLeaves);
+
+    // Tests a new cell and either queues it for splitting or keeps it as a leaf
+    auto insert = [&](Cell2D cell, MortonCode code, int level)
+    {
+        double priority = std::ldexp(1.0, -level);
+        bool cut = false;
+
+        if (level < budget.maxDepth && lengthIsCutTest)
+        {
+            priority *= estimateBoundaryLength(cell, geometry, options, level);
+            cut = priority > 0.0;
+        }
+        else if (level < budget.maxDepth)
+        {
+            cut = isCutByBoundary(cell, geometry, options, level, cache.get());
+            if (cut && byBoundaryLength)
+                priority *= estimateBoundaryLength(cell, geometry, seedPointsAtLevel(options, level));
+        }
+
+        if (level < budget.maxDepth && recordCut(options, level, cut))
+            queue.push({ priority, code, level, cell });
+        else
+            leaves.emplace_back(code, static_cast<std::uint8_t>(level));
+    };
+
+    // Splitting a cell replaces one leaf by four
+    auto withinBudget = [&]()
+    {
+        if (budget.maxLeaves != 0 && leaves.size() + queue.size() + 3 > budget.maxLeaves)
+            return false;
+        return budget.maxSeconds <= 0.0 ||
+               std::chrono::duration<double>(Clock::now() - start).count() < budget.maxSeconds;
+    };
+
+    insert(rootCell_, 0, 0);
+
+    while (!queue.empty() && withinBudget())
+    {
+        Candidate candidate = queue.top();
+        queue.pop();
+
+        auto subCells = subdivideCell(candidate.cell);
+        for (int child = 0; child < 4; ++child)
+            insert(subCells[child], childCode(candidate.code, candidate.level, child), candidate.level + 1);
+    }
+
+    truncated_ = !queue.empty();
+    for (; !queue.empty(); queue.pop())
+        leaves.emplace_back(queue.top().code, static_cast<std::uint8_t>(queue.top().level));
+
+    // Leaves do not overlap, so sorting by code restores the depth-first order
+    std::sort(leaves.begin(), leaves.end());
+
+    codes_.resize(leaves.size());
+    levels_.resize(leaves.size());
+    for (std::size_t i = 0; i < leaves.size(); ++i)
+    {
+        codes_[i] = leaves[i].first;
+        levels_[i] = leaves[i].second;
+    }
+
+    states_.clear();
+    maxDepth_ = budget.maxDepth;
+}
+
+/**
+ * @brief Applies 2:1 balancing to the leaf arrays.
+ */
+void LinearQuadTree::balance()
+{
+    balanceLeaves(codes_, levels_);
+    states_.clear();
+}
+
+/**
+ * @brief Returns all leaf cells and their levels in Morton order.
+ */
+CellsAndLevels LinearQuadTree::getLeafCells() const
+{
+    CellsAndLevels data;
+    data.first.reserve(size());
+    data.second.reserve(size());
+
+    for (std::size_t i = 0; i < size(); ++i)
+    {
+        data.first.push_back(cell(i));
+        data.second.push_back(levels_[i]);
+    }
+
+    return data;
+}
+
+/**
+ * @brief Derives the bounds of a leaf from its code.
+ */
+Cell2D LinearQuadTree::cell(std::size_t index) const
+{
+    return cellFromCode(rootCell_, codes_[index], levels_[index]);
+}
+
+/**
+ * @brief Replays the subdivision path encoded in the code.
+ */
+Cell2D LinearQuadTree::cellFromCode(Cell2D rootCell, MortonCode code, int level)
+{
+    Cell2D cell = rootCell;
+    for (int l = 1; l <= level; ++l)
+        cell = subdivideCell(cell)[childIndex(code, l)];
+    return cell;
+}
+
+/**
+ * @brief Classifies contiguous ranges of leaves, one task per range.
+ */
+void LinearQuadTree::classifyLeaves(const AbsImplicitGeometry &geometry, const PartitionOptions &options)
+{
+    states_.assign(size(), CellClassification::Cut);
+
+    auto classifyRange = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Cell2D leaf = cell(i);
+
+            if ((levels_[i] == maxDepth_ || truncated_) && isCutByBoundary(leaf, geometry, options, levels_[i]))
+                continue;
+
+            double xcenter = 0.5 * (leaf[0][0] + leaf[0][1]);
+            double ycenter = 0.5 * (leaf[1][0] + leaf[1][1]);
+            states_[i] = geometry.inside(xcenter, ycenter) ? CellClassification::Inside
+                                                           : CellClassification::Outside;
+        }
+    };
+
+    if (options.numberOfThreads == 1)
+    {
+        classifyRange(0, size());
+        return;
+    }
+
+    ThreadPool pool(options.numberOfThreads);
+    std::size_t numberOfRanges = 4 * pool.size();
+    std::size_t rangeSize = (size() + numberOfRanges - 1) / numberOfRanges;
+
+    TaskGroup group;
+    for (std::size_t begin = 0; begin < size(); begin += rangeSize)
+        pool.spawn(group, [&, begin]()
+        {
+            classifyRange(begin, std::min(begin + rangeSize, size()));
+        });
+
+    pool.wait(group);
+}
+
+/**
+ * @brief Maps the point to the finest lattice and searches the leaf codes.
+ */
+std::size_t LinearQuadTree::locate(double x, double y) const
+{
+    MortonCode code;
+    if (!pointCode(x, y, code))
+        return npos;
+
+    return leafIndex(code);
+}
+
+/**
+ * @brief Sorts the queries by Morton code and resolves them in ranges.
+ *
+ * Within a range, the search for each query starts at the leaf found for the previous
+ * one, so the leaf array is traversed once in ascending order.
+ */
+std::vector<std::size_t> LinearQuadTree::locate(const double *x, const double *y, std::size_t n,
+                                                unsigned numberOfThreads) const
+{
+    std::vector<std::size_t> result(n, npos);
+    std::vector<std::pair<MortonCode, std::size_t>> queries;
+    queries.reserve(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        MortonCode code;
+        if (pointCode(x[i], y[i], code))
+            queries.emplace_back(code, i);
+    }
+
+    std::sort(queries.begin(), queries.end());
+
+    auto resolveRange = [&](std::size_t begin, std::size_t end)
+    {
+        std::size_t leaf = 0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            leaf = leafIndex(queries[i].first, leaf);
+            result[queries[i].second] = leaf;
+        }
+    };
+
+    if (numberOfThreads == 1)
+    {
+        resolveRange(0, queries.size());
+        return result;
+    }
+
+    ThreadPool pool(numberOfThreads);
+    std::size_t rangeSize = (queries.size() + pool.size() - 1) / pool.size();
+
+    TaskGroup group;
+    for (std::size_t begin = 0; begin < queries.size(); begin += rangeSize)
+        pool.spawn(group, [&, begin]()
+        {
+            resolveRange(begin, std::min(begin + rangeSize, queries.size()));
+        });
+
+    pool.wait(group);
+
+    return result;
+}
+
+/**
+ * @brief Scales the point to integer lattice coordinates, clamping the upper boundary.
+ */
+bool LinearQuadTree::pointCode(double x, double y, MortonCode &code) const
+{
+    double tx = (x - rootCell_[0][0]) / (rootCell_[0][1] - rootCell_[0][0]);
+    double ty = (y - rootCell_[1][0]) / (rootCell_[1][1] - rootCell_[1][0]);
+
+    if (!(tx >= 0.0 && tx <= 1.0 && ty >= 0.0 && ty <= 1.0))
+        return false;
+
+    double resolution = std::ldexp(1.0, maxMortonLevel);
+    std::uint32_t last = cellExtent(0) - 1;
+
+    auto ix = std::min(static_cast<std::uint32_t>(tx * resolution), last);
+    auto iy = std::min(static_cast<std::uint32_t>(ty * resolution), last);
+
+    code = encodeMorton(ix, iy);
+    return true;
+}
+
+/**
+ * @brief Binary search for the leaf whose code range contains the given code.
+ */
+std::size_t LinearQuadTree::leafIndex(MortonCode code, std::size_t first) const
+{
+    auto next = std::upper_bound(codes_.begin() + static_cast<std::ptrdiff_t>(first), codes_.end(), code);
+    return static_cast<std::size_t>(next - codes_.begin()) - 1;
+}
+
+/**
+ * @brief Depth-first recursion emitting leaves in Morton order.
+ */
+void LinearQuadTree::partitionRecursive(const AbsImplicitGeometry &geometry, Cell2D cell,
+                                        MortonCode code, int level, int maxDepth,
+                                        const PartitionOptions &options, SeedPointCache *cache,
+                                        Leaves &leaves)
+{
+    if (level < maxDepth && recordCut(options, level, isCutByBoundary(cell, geometry, options, level, cache)))
+    {
+        auto subCells = subdivideCell(cell);
+        for (int child = 0; child < 4; ++child)
+            partitionRecursive(geometry, subCells[child], childCode(code, level, child),
+                               level + 1, maxDepth, options, cache, leaves);
+    }
+    else
+    {
+        leaves.codes.push_back(code);
+        leaves.levels.push_back(static_cast<std::uint8_t>(level));
+    }
+}
+
+/**
+ * @brief Sets up the seed point cache for the subtree if requested.
+ */
+void LinearQuadTree::partitionSerial(const AbsImplicitGeometry &geometry, Cell2D cell,
+                                     MortonCode code, int level, int maxDepth,
+                                     const PartitionOptions &options, Leaves &leaves) const
+{
+    int levels = maxDepth - level;
+
+    if (useSeedPointCache(options, levels))
+    {
+        SeedPointCache cache(cell, levels, options.numberOfSeedPoints);
+        partitionRecursive(geometry, cell, code, level, maxDepth, options, &cache, leaves);
+    }
+    else
+    {
+        partitionRecursive(geometry, cell, code, level, maxDepth, options, nullptr, leaves);
+    }
+}
+
+/**
+ * @brief Partitions the children as separate tasks and concatenates their leaves in order.
+ */
+void LinearQuadTree::partitionParallel(const AbsImplicitGeometry &geometry, Cell2D cell,
+                                       MortonCode code, int level, int maxDepth,
+                                       const PartitionOptions &options, ThreadPool &pool,
+                                       Leaves &leaves) const
+{
+    if (maxDepth - level <= options.taskGranularity)
+    {
+        partitionSerial(geometry, cell, code, level, maxDepth, options, leaves);
+        return;
+    }
+
+    if (!recordCut(options, level, isCutByBoundary(cell, geometry, options, level)))
+    {
+        leaves.codes.push_back(code);
+        leaves.levels.push_back(static_cast<std::uint8_t>(level));
+        return;
+    }
+
+    auto subCells = subdivideCell(cell);
+    Leaves childLeaves[4];
+
+    TaskGroup group;
+    for (int child = 0; child < 4; ++child)
+        pool.spawn(group, [&, child]()
+        {
+            partitionParallel(geometry, subCells[child], childCode(code, level, child),
+                              level + 1, maxDepth, options, pool, childLeaves[child]);
+        });
+
+    pool.wait(group);
+
+    for (const auto &child : childLeaves)
+    {
+        leaves.codes.insert(leaves.codes.end(), child.codes.begin(), child.codes.end());
+        leaves.levels.insert(leaves.levels.end(), child.levels.begin(), child.levels.end());
+    }
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,84 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implements read-only file mappings with POSIX mmap.
+ */
+
+#include "mapped_file.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Opens the file, maps its full length and closes the descriptor again.
+ *
+ * Empty files are not mapped, since mmap rejects a zero length.
+ */
+MappedFile::MappedFile(const std::string &filename)
+{
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw std::runtime_error("MappedFile: cannot open file " + filename);
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0)
+    {
+        ::close(descriptor);
+        throw std::runtime_error("MappedFile: cannot determine the size of " + filename);
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    if (size_ > 0)
+    {
+        void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(descriptor);
+            throw std::runtime_error("MappedFile: cannot map file " + filename);
+        }
+        data_ = static_cast<const char *>(mapping);
+    }
+
+    ::close(descriptor);
+}
+
+/**
+ * @brief Releases the mapping if the object still owns one.
+ */
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(const_cast<char *>(data_), size_);
+}
+
+/**
+ * @brief Takes over the mapping of another object.
+ */
+MappedFile::MappedFile(MappedFile &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+{ }
+
+/**
+ * @brief Releases the own mapping and takes over the one of another object.
+ */
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (data_)
+            ::munmap(const_cast<char *>(data_), size_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+} // namespace implicit::detail
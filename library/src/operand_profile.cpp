@@ -0,0 +1,114 @@
+/**
+ * @file operand_profile.cpp
+ * @brief Implements the operand profile and the profile-guided reordering.
+ */
+
+#include "operand_profile.h"
+#include "AbsOperation.hpp"
+#include "AbsNaryOperation.hpp"
+
+#include <unordered_set>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Assigns slots to the binary operations in preorder, once per shared node.
+ */
+OperandProfiler::OperandProfiler(const AbsImplicitGeometry &geometry)
+        : previous_(current_), recording_(true)
+{
+    std::unordered_set<const AbsImplicitGeometry *> visited;
+    std::vector<const AbsImplicitGeometry *> pending { &geometry };
+
+    while (!pending.empty())
+    {
+        const AbsImplicitGeometry *node = pending.back();
+        pending.pop_back();
+
+        if (!visited.insert(node).second)
+            continue;
+
+        if (auto operation = dynamic_cast<const AbsOperation *>(node))
+        {
+            slots_.emplace(operation, operations_.size());
+            operations_.push_back(operation);
+            pending.push_back(operation->operand2().get());
+            pending.push_back(operation->operand1().get());
+        }
+        else if (auto naryOperation = dynamic_cast<const AbsNaryOperation *>(node))
+        {
+            for (const auto &operand : naryOperation->operands())
+                pending.push_back(operand.get());
+        }
+    }
+
+    counters_.assign(operations_.size(), OperandCounters { });
+
+    // A thread always sees its own increment, so its evaluations find the profiler
+    recordingProfilers_.fetch_add(1, std::memory_order_relaxed);
+    current_ = this;
+}
+
+/**
+ * @brief Deactivates the profiler if the profile was not finished.
+ */
+OperandProfiler::~OperandProfiler()
+{
+    if (recording_)
+        detach();
+}
+
+/**
+ * @brief Picks the operand order of every operation from the counters.
+ */
+std::vector<OperandCounters> OperandProfiler::finish()
+{
+    if (recording_)
+        detach();
+
+    // Expected cost per decided query; the decision rate is smoothed (rule of succession),
+    // so operands that never decided are still ranked by their cost
+    auto rank = [](const OperandCounters &slot, int operand)
+    {
+        double evaluations = static_cast<double>(slot.evaluations[operand]);
+        double meanCost = static_cast<double>(slot.cost[operand]) / evaluations;
+        double decisionRate = (static_cast<double>(slot.decisions[operand]) + 1.0) / (evaluations + 2.0);
+        return meanCost / decisionRate;
+    };
+
+    for (std::size_t slot = 0; slot < operations_.size(); ++slot)
+    {
+        const OperandCounters &profile = counters_[slot];
+        if (profile.evaluations[0] == 0 || profile.evaluations[1] == 0)
+            continue;
+
+        double rank1 = rank(profile, 0);
+        double rank2 = rank(profile, 1);
+        if (rank1 != rank2)
+            operations_[slot]->operand2First_.store(rank2 < rank1, std::memory_order_relaxed);
+    }
+
+    return counters_;
+}
+
+/**
+ * @brief Looks up the slot of the operation.
+ */
+OperandCounters *OperandProfiler::counters(const AbsOperation *operation)
+{
+    auto slot = slots_.find(operation);
+    return slot == slots_.end() ? nullptr : &counters_[slot->second];
+}
+
+/**
+ * @brief Hands the thread back to the profiler that was active before.
+ */
+void OperandProfiler::detach()
+{
+    current_ = previous_;
+    recording_ = false;
+    recordingProfilers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace implicit::detail
@@ -9,9 +9,20 @@
 #include "quadtree.h"
 #include "quadtree_helper.h"
 #include "AbsImplicitGeometry.hpp"
+#include "simd_helper.h"
+#include "seed_cache.h"
+#include "thread_pool.h"
+#include "leaf_sink.h"
+#include "linear_quadtree.h"
+#include "bounding_box_helper.h"
+#include "operand_profile.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 
 namespace implicit {
 namespace detail {
@@ -39,27 +50,290 @@ std::array<Cell2D, 4> subdivideCell(Cell2D cell)
  * @brief Checks if the cell intersects the boundary of the implicit geometry.
  *
  * Samples `numberOfSeedPoints` along each axis and counts interior hits.
+ * The seed points are collected into blocks of up to `maxBatchSize` points so
+ * that each block costs a single batch query on the geometry.
  * Returns true if some points are inside and some are outside.
+ *
+ * With early exit, the first block holds the four corners and, for an odd number of
+ * seeds, the center. The remaining seeds follow in row-major order, and every block is
+ * only evaluated while all previous seeds agree.
  */
+template<typename Real>
 bool isCutByBoundary(Cell2D cell,
                      const AbsImplicitGeometry &geometry,
-                     int numberOfSeedPoints)
+                     int numberOfSeedPoints,
+                     bool earlyExit)
 {
     double xmin = cell[0][0], xmax = cell[0][1];
     double ymin = cell[1][0], ymax = cell[1][1];
 
-    int count = 0;
+    Real xs[maxBatchSize];
+    Real ys[maxBatchSize];
+    std::size_t size = 0;
+
+    std::size_t count = 0;
+    std::size_t evaluated = 0;
+
+    // Seeds are computed in double and rounded once
+    auto seedX = [&](int i) { return static_cast<Real>(i / (numberOfSeedPoints - 1.0) * (xmax - xmin) + xmin); };
+    auto seedY = [&](int j) { return static_cast<Real>(j / (numberOfSeedPoints - 1.0) * (ymax - ymin) + ymin); };
+
+    // Evaluates the pending block and reports whether the seeds disagree so far
+    auto evaluateBlock = [&]()
+    {
+        count += countPoints(geometry.insideBatch(xs, ys, size));
+        evaluated += size;
+        size = 0;
+        return earlyExit && count != 0 && count != evaluated;
+    };
+
+    int last = numberOfSeedPoints - 1;
+    int center = numberOfSeedPoints % 2 ? last / 2 : -1;
+
+    auto isPriority = [&](int i, int j)
+    {
+        return earlyExit && (((i == 0 || i == last) && (j == 0 || j == last)) || (i == center && j == center));
+    };
+
+    if (earlyExit)
+    {
+        for (int i : { 0, last })
+            for (int j : { 0, last })
+            {
+                xs[size] = seedX(i);
+                ys[size++] = seedY(j);
+            }
+
+        if (center >= 0)
+        {
+            xs[size] = seedX(center);
+            ys[size++] = seedY(center);
+        }
+
+        if (evaluateBlock())
+            return true;
+    }
+
     for (int i = 0; i < numberOfSeedPoints; ++i)
     {
-        double x = i / (numberOfSeedPoints - 1.0) * (xmax - xmin) + xmin;
+        Real x = seedX(i);
         for (int j = 0; j < numberOfSeedPoints; ++j)
         {
-            double y = j / (numberOfSeedPoints - 1.0) * (ymax - ymin) + ymin;
-            count += geometry.inside(x, y);
+            if (isPriority(i, j))
+                continue;
+
+            xs[size] = x;
+            ys[size] = seedY(j);
+
+            if (++size == maxBatchSize && evaluateBlock())
+                return true;
         }
     }
 
-    return count != 0 && count != numberOfSeedPoints * numberOfSeedPoints;
+    if (size != 0)
+        evaluateBlock();
+
+    return count != 0 && count != evaluated;
+}
+
+template bool isCutByBoundary<float>(Cell2D, const AbsImplicitGeometry &, int, bool);
+template bool isCutByBoundary<double>(Cell2D, const AbsImplicitGeometry &, int, bool);
+
+/**
+ * @brief Samples the seed points in double precision.
+ */
+bool isCutByBoundary(Cell2D cell,
+                     const AbsImplicitGeometry &geometry,
+                     int numberOfSeedPoints,
+                     bool earlyExit)
+{
+    return isCutByBoundary<double>(cell, geometry, numberOfSeedPoints, earlyExit);
+}
+
+/**
+ * @brief Compares the seed spacing with the float resolution of the largest cell coordinate.
+ */
+bool useSinglePrecision(Cell2D cell, int numberOfSeedPoints)
+{
+    double intervals = std::max(numberOfSeedPoints - 1, 1);
+    double spacing = std::min(cell[0][1] - cell[0][0], cell[1][1] - cell[1][0]) / intervals;
+    double magnitude = std::max({ std::abs(cell[0][0]), std::abs(cell[0][1]),
+                                  std::abs(cell[1][0]), std::abs(cell[1][1]) });
+
+    return spacing >= minSinglePrecisionSpacing * std::numeric_limits<float>::epsilon() * magnitude;
+}
+
+/**
+ * @brief Samples the seed grid in batches and counts sign changes between neighbours.
+ */
+template<typename Real>
+double estimateBoundaryLength(Cell2D cell,
+                              const AbsImplicitGeometry &geometry,
+                              int numberOfSeedPoints)
+{
+    int n = numberOfSeedPoints;
+    double xmin = cell[0][0], xmax = cell[0][1];
+    double ymin = cell[1][0], ymax = cell[1][1];
+    double hx = (xmax - xmin) / (n - 1);
+    double hy = (ymax - ymin) / (n - 1);
+
+    // inside[i * n + j] holds the state of the seed (i, j)
+    std::vector<char> inside(static_cast<std::size_t>(n) * n);
+
+    Real xs[maxBatchSize];
+    Real ys[maxBatchSize];
+    std::size_t size = 0;
+    std::size_t first = 0;
+
+    // Same seeds as isCutByBoundary, so both agree on whether the cell is cut
+    auto seedX = [&](int i) { return static_cast<Real>(i / (n - 1.0) * (xmax - xmin) + xmin); };
+    auto seedY = [&](int j) { return static_cast<Real>(j / (n - 1.0) * (ymax - ymin) + ymin); };
+
+    auto evaluateBlock = [&]()
+    {
+        PointMask mask = geometry.insideBatch(xs, ys, size);
+        for (std::size_t m = 0; m < size; ++m)
+            inside[first + m] = static_cast<char>((mask >> m) & 1);
+        first += size;
+        size = 0;
+    };
+
+    for (int i = 0; i < n; ++i)
+    {
+        Real x = seedX(i);
+        for (int j = 0; j < n; ++j)
+        {
+            xs[size] = x;
+            ys[size] = seedY(j);
+
+            if (++size == maxBatchSize)
+                evaluateBlock();
+        }
+    }
+
+    if (size != 0)
+        evaluateBlock();
+
+    std::size_t xChanges = 0;  // Crossings of the lines y = const
+    std::size_t yChanges = 0;  // Crossings of the lines x = const
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            char state = inside[i * n + j];
+            if (i + 1 < n) xChanges += state != inside[(i + 1) * n + j];
+            if (j + 1 < n) yChanges += state != inside[i * n + j + 1];
+        }
+    }
+
+    // Average of the length estimates pi / 2 * h * N of both line families
+    constexpr double pi = 3.14159265358979323846;
+    return 0.25 * pi * (hy * static_cast<double>(xChanges) + hx * static_cast<double>(yChanges));
+}
+
+template double estimateBoundaryLength<float>(Cell2D, const AbsImplicitGeometry &, int);
+template double estimateBoundaryLength<double>(Cell2D, const AbsImplicitGeometry &, int);
+
+/**
+ * @brief Samples the seed points in double precision.
+ */
+double estimateBoundaryLength(Cell2D cell,
+                              const AbsImplicitGeometry &geometry,
+                              int numberOfSeedPoints)
+{
+    return estimateBoundaryLength<double>(cell, geometry, numberOfSeedPoints);
+}
+
+/**
+ * @brief Applies distance culling and samples the seed grid of the level in the configured precision.
+ */
+double estimateBoundaryLength(Cell2D cell,
+                              const AbsImplicitGeometry &geometry,
+                              const PartitionOptions &options,
+                              int level)
+{
+    if (options.distanceCulling && isFarFromBoundary(cell, geometry))
+        return 0.0;
+
+    int numberOfSeedPoints = seedPointsAtLevel(options, level);
+
+    if (options.singlePrecision && useSinglePrecision(cell, numberOfSeedPoints))
+        return estimateBoundaryLength<float>(cell, geometry, numberOfSeedPoints);
+
+    return estimateBoundaryLength<double>(cell, geometry, numberOfSeedPoints);
+}
+
+/**
+ * @brief Compares the center distance with the half-diagonal of the cell.
+ */
+bool isFarFromBoundary(Cell2D cell, const AbsImplicitGeometry &geometry)
+{
+    double width = cell[0][1] - cell[0][0];
+    double height = cell[1][1] - cell[1][0];
+    double xcenter = 0.5 * (cell[0][0] + cell[0][1]);
+    double ycenter = 0.5 * (cell[1][0] + cell[1][1]);
+
+    // Small safety margin against rounding in the distance evaluation
+    double halfDiagonal = 0.5 * std::hypot(width, height) * (1.0 + 1e-12);
+
+    return std::abs(geometry.distance(xcenter, ycenter)) > halfDiagonal;
+}
+
+/**
+ * @brief Checks if the cell is cut using the criterion selected in the options.
+ */
+bool isCutByBoundary(Cell2D cell,
+                     const AbsImplicitGeometry &geometry,
+                     const PartitionOptions &options,
+                     int level,
+                     SeedPointCache *cache)
+{
+    if (options.distanceCulling && isFarFromBoundary(cell, geometry))
+        return false;
+
+    if (options.cutCriterion == CutCriterion::Interval)
+        return geometry.classify(cell) == CellClassification::Cut;
+
+    if (cache)
+        return cache->isCutByBoundary(cell, geometry, options.earlyExit);
+
+    int numberOfSeedPoints = seedPointsAtLevel(options, level);
+
+    if (options.singlePrecision && useSinglePrecision(cell, numberOfSeedPoints))
+        return isCutByBoundary<float>(cell, geometry, numberOfSeedPoints, options.earlyExit);
+
+    return isCutByBoundary(cell, geometry, numberOfSeedPoints, options.earlyExit);
+}
+
+/**
+ * @brief The cache needs a uniform seed count on a lattice that fits into its key space.
+ */
+bool useSeedPointCache(const PartitionOptions &options, int levels)
+{
+    return options.cacheSeedPoints &&
+           options.cutCriterion == CutCriterion::SeedPoints &&
+           options.seedPointsPerLevel.empty() &&
+           SeedPointCache::isSupported(levels, options.numberOfSeedPoints);
+}
+
+/**
+ * @brief Partitions the cell coarsely under an operand profiler and applies its order.
+ */
+void profileOperandOrder(const AbsImplicitGeometry &geometry, Cell2D cell, const PartitionOptions &options)
+{
+    if (options.profileDepth <= 0)
+        return;
+
+    // The profiler records the evaluations of the calling thread only
+    PartitionOptions profileOptions = options;
+    profileOptions.profileDepth = 0;
+    profileOptions.numberOfThreads = 1;
+    profileOptions.stats = nullptr;
+
+    OperandProfiler profiler(geometry);
+    QuadTreeNode root(cell, 0);
+    root.partition(geometry, options.profileDepth, profileOptions);
+    profiler.finish();
 }
 
 /**
@@ -72,7 +346,8 @@ void writeCellsToVtkFile(const CellsAndLevels &data, const std::string &filename
     size_t numberOfCells = cells.size();
 
     std::ofstream outfile(filename);
-    if (!outfile.is_open()) return;
+    if (!outfile.is_open())
+        throw std::runtime_error("writeCellsToVtkFile: cannot open output file " + filename);
 
     outfile << "# vtk DataFile Version 4.2\n";
     outfile << "Adaptive Quadtree\n";
@@ -116,12 +391,79 @@ QuadTreeNode::QuadTreeNode(Cell2D cell, int level)
 /**
  * @brief Recursively partitions the node based on geometry boundary interaction.
  */
-void QuadTreeNode::partition(const AbsImplicitGeometry &geometry, int maxDepth)
+void QuadTreeNode::partition(const AbsImplicitGeometry &geometry, int maxDepth,
+                             const PartitionOptions &options)
 {
-    int numberOfSeedPoints = 7;
+    profileOperandOrder(geometry, cell_, options);
 
+    if (options.numberOfThreads == 1)
+    {
+        partitionSerial(geometry, maxDepth, options);
+        return;
+    }
+
+    ThreadPool pool(options.numberOfThreads);
+    partitionParallel(geometry, maxDepth, options, pool);
+}
+
+/**
+ * @brief Partitions the subtree on the calling thread with an optional seed point cache.
+ */
+void QuadTreeNode::partitionSerial(const AbsImplicitGeometry &geometry, int maxDepth,
+                                   const PartitionOptions &options)
+{
+    int levels = maxDepth - level_;
+
+    if (useSeedPointCache(options, levels))
+    {
+        SeedPointCache cache(cell_, levels, options.numberOfSeedPoints);
+        partitionRecursive(geometry, maxDepth, options, &cache);
+    }
+    else
+    {
+        partitionRecursive(geometry, maxDepth, options, nullptr);
+    }
+}
+
+/**
+ * @brief Spawns one task per child until the remaining depth reaches the task granularity.
+ */
+void QuadTreeNode::partitionParallel(const AbsImplicitGeometry &geometry, int maxDepth,
+                                     const PartitionOptions &options, ThreadPool &pool)
+{
+    if (maxDepth - level_ <= options.taskGranularity)
+    {
+        partitionSerial(geometry, maxDepth, options);
+        return;
+    }
+
+    if (recordCut(options, level_, isCutByBoundary(cell_, geometry, options, level_)))
+    {
+        auto subCells = subdivideCell(cell_);
+        children_.reserve(4);
+
+        for (const auto &sub : subCells)
+            children_.emplace_back(sub, level_ + 1);
+
+        TaskGroup group;
+        for (auto &child : children_)
+            pool.spawn(group, [&child, &geometry, maxDepth, &options, &pool]()
+            {
+                child.partitionParallel(geometry, maxDepth, options, pool);
+            });
+
+        pool.wait(group);
+    }
+}
+
+/**
+ * @brief Recursively partitions the node, sharing the seed point cache across the subtree.
+ */
+void QuadTreeNode::partitionRecursive(const AbsImplicitGeometry &geometry, int maxDepth,
+                                      const PartitionOptions &options, SeedPointCache *cache)
+{
     if (level_ < maxDepth &&
-        isCutByBoundary(cell_, geometry, numberOfSeedPoints))
+        recordCut(options, level_, isCutByBoundary(cell_, geometry, options, level_, cache)))
     {
         auto subCells = subdivideCell(cell_);
         children_.reserve(4);
@@ -129,11 +471,46 @@ void QuadTreeNode::partition(const AbsImplicitGeometry &geometry, int maxDepth)
         for (const auto &sub : subCells)
         {
             children_.emplace_back(sub, level_ + 1);
-            children_.back().partition(geometry, maxDepth);
+            children_.back().partitionRecursive(geometry, maxDepth, options, cache);
         }
     }
 }
 
+/**
+ * @brief Re-classifies the nodes touching the dirty region and keeps all others.
+ */
+void QuadTreeNode::update(const AbsImplicitGeometry &geometry, Cell2D dirtyRegion, int maxDepth,
+                          const PartitionOptions &options)
+{
+    if (!boxesOverlap(cell_, dirtyRegion))
+        return;
+
+    if (level_ < maxDepth &&
+        recordCut(options, level_, isCutByBoundary(cell_, geometry, options, level_)))
+    {
+        if (children_.empty())
+        {
+            auto subCells = subdivideCell(cell_);
+            children_.reserve(4);
+
+            for (const auto &sub : subCells)
+            {
+                children_.emplace_back(sub, level_ + 1);
+                children_.back().partitionSerial(geometry, maxDepth, options);
+            }
+        }
+        else
+        {
+            for (auto &child : children_)
+                child.update(geometry, dirtyRegion, maxDepth, options);
+        }
+    }
+    else
+    {
+        children_.clear();
+    }
+}
+
 /**
  * @brief Returns all leaf cells and their levels from this node and its children.
  */
@@ -144,6 +521,26 @@ CellsAndLevels QuadTreeNode::getLeafCells() const
     return data;
 }
 
+/**
+ * @brief Descends to the child containing the point until a leaf is reached.
+ */
+const QuadTreeNode *QuadTreeNode::findLeaf(double x, double y) const
+{
+    if (!(x >= cell_[0][0] && x <= cell_[0][1] && y >= cell_[1][0] && y <= cell_[1][1]))
+        return nullptr;
+
+    const QuadTreeNode *node = this;
+    while (!node->children_.empty())
+    {
+        // Children are ordered as in subdivideCell: (x0, y0), (x0, y1), (x1, y0), (x1, y1)
+        Cell2D upper = node->children_[3].cell_;
+        int child = (x >= upper[0][0] ? 2 : 0) + (y >= upper[1][0] ? 1 : 0);
+        node = &node->children_[child];
+    }
+
+    return node;
+}
+
 /**
  * @brief Recursive helper to collect leaf cells.
  */
@@ -161,20 +558,155 @@ void QuadTreeNode::getLeafCellsRecursive(CellsAndLevels &data) const
     }
 }
 
+/**
+ * @brief Merges the bounding boxes of a primitive before and after an edit.
+ */
+Cell2D changedRegion(const AbsImplicitGeometry &before, const AbsImplicitGeometry &after)
+{
+    return mergeBoxes(before.boundingBox(), after.boundingBox());
+}
+
+namespace
+{
+
+/**
+ * @class LeafChunk
+ * @brief Collects leaves and forwards them to a sink whenever the chunk is full.
+ */
+class LeafChunk
+{
+public:
+    LeafChunk(LeafSink &sink, QuadTreeStats *stats)
+            : sink_(sink), stats_(stats)
+    {
+        cells_.reserve(leafChunkSize);
+        levels_.reserve(leafChunkSize);
+    }
+
+    void push(Cell2D cell, unsigned int level)
+    {
+        cells_.push_back(cell);
+        levels_.push_back(level);
+        if (cells_.size() == leafChunkSize)
+            flush();
+    }
+
+    void flush()
+    {
+        if (cells_.empty()) return;
+        IMPLICIT_STATS(WriteTimer timer(stats_));
+        sink_.consume(cells_.data(), levels_.data(), cells_.size());
+        cells_.clear();
+        levels_.clear();
+    }
+
+private:
+    LeafSink &sink_;
+    QuadTreeStats *stats_;
+    std::vector<Cell2D> cells_;
+    std::vector<unsigned int> levels_;
+};
+
+/**
+ * @brief Depth-first recursion emitting leaves to the chunk instead of creating nodes.
+ */
+void streamRecursive(const AbsImplicitGeometry &geometry, Cell2D cell, int level, int maxDepth,
+                     const PartitionOptions &options, LeafChunk &chunk)
+{
+    if (level < maxDepth && recordCut(options, level, isCutByBoundary(cell, geometry, options, level)))
+    {
+        for (const auto &sub : subdivideCell(cell))
+            streamRecursive(geometry, sub, level + 1, maxDepth, options, chunk);
+    }
+    else
+    {
+        chunk.push(cell, static_cast<unsigned int>(level));
+    }
+}
+
+} // namespace
+
 } // namespace implicit::detail
 
+/**
+ * @brief Streams the leaves of a depth-first partition to a sink in bounded chunks, without a seed point cache.
+ */
+void streamQuadTree(const AbsImplicitGeometry &geometry,
+                    Cell2D boundingBox,
+                    int maxDepth,
+                    LeafSink &sink,
+                    const PartitionOptions &options)
+{
+    detail::profileOperandOrder(geometry, boundingBox, options);
+    detail::LeafChunk chunk(sink, options.stats);
+
+    detail::streamRecursive(geometry, boundingBox, 0, maxDepth, options, chunk);
+    chunk.flush();
+
+    IMPLICIT_STATS(detail::WriteTimer timer(options.stats));
+    sink.finish();
+}
+
 /**
  * @brief Top-level function to generate a quadtree and write it to a VTK file.
  */
 void generateQuadTree(const AbsImplicitGeometry &geometry,
                       Cell2D boundingBox,
                       int maxDepth,
-                      const std::string &filename)
+                      const std::string &filename,
+                      const PartitionOptions &options,
+                      VtkFormat format)
 {
+    IMPLICIT_STATS(detail::StatsScope statsScope(geometry, options.stats));
+
+    // A requested seed point cache is kept by partitioning the tree instead of streaming
+    if (format == VtkFormat::Ascii && options.numberOfThreads == 1 &&
+        !detail::useSeedPointCache(options, maxDepth))
+    {
+        VtkStreamWriter writer(filename, format);
+        streamQuadTree(geometry, boundingBox, maxDepth, writer, options);
+        IMPLICIT_STATS(statsScope.lap(&QuadTreeStats::partitionSeconds));
+        return;
+    }
+
     detail::QuadTreeNode rootNode(boundingBox, 0);
-    rootNode.partition(geometry, maxDepth);
+    rootNode.partition(geometry, maxDepth, options);
+    IMPLICIT_STATS(statsScope.lap(&QuadTreeStats::partitionSeconds));
+
     auto leaves = rootNode.getLeafCells();
-    detail::writeCellsToVtkFile(leaves, filename);
+    IMPLICIT_STATS(statsScope.lap(&QuadTreeStats::collectSeconds));
+
+    if (format == VtkFormat::Binary)
+        detail::writeCellsToBinaryVtkFile(leaves, filename);
+    else
+        detail::writeCellsToVtkFile(leaves, filename);
+    IMPLICIT_STATS(statsScope.lap(&QuadTreeStats::writeSeconds));
+}
+
+/**
+ * @brief Refines best-first within the budget and writes the leaves to a VTK file.
+ */
+void generateQuadTree(const AbsImplicitGeometry &geometry,
+                      Cell2D boundingBox,
+                      const RefinementBudget &budget,
+                      const std::string &filename,
+                      const PartitionOptions &options,
+                      VtkFormat format)
+{
+    IMPLICIT_STATS(detail::StatsScope statsScope(geometry, options.stats));
+
+    detail::LinearQuadTree tree(boundingBox);
+    tree.refine(geometry, budget, options);
+    IMPLICIT_STATS(statsScope.lap(&QuadTreeStats::partitionSeconds));
+
+    auto leaves = tree.getLeafCells();
+    IMPLICIT_STATS(statsScope.lap(&QuadTreeStats::collectSeconds));
+
+    if (format == VtkFormat::Binary)
+        detail::writeCellsToBinaryVtkFile(leaves, filename);
+    else
+        detail::writeCellsToVtkFile(leaves, filename);
+    IMPLICIT_STATS(statsScope.lap(&QuadTreeStats::writeSeconds));
 }
 
 } // namespace implicit
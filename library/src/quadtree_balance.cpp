@@ -0,0 +1,232 @@
+/**
+ * @file quadtree_balance.cpp
+ * @brief Implements 2:1 balancing and neighbour search on Morton-ordered leaves.
+ */
+
+#include "quadtree_balance.h"
+#include "linear_quadtree.h"
+
+#include <algorithm>
+
+namespace implicit::detail
+{
+
+namespace
+{
+
+/**
+ * @brief Checks whether a code produced by neighbour arithmetic left the domain.
+ *
+ * Overflow or underflow of either coordinate carries into the two highest bits, which
+ * are unused by codes inside the domain.
+ */
+inline bool isOutsideDomain(MortonCode code)
+{
+    return (code >> (2 * maxMortonLevel)) != 0;
+}
+
+/**
+ * @brief Returns the code of the same-sized cell across the given face.
+ */
+inline MortonCode faceNeighbour(MortonCode code, int level, Face face)
+{
+    std::uint32_t extent = cellExtent(level);
+
+    switch (face)
+    {
+        case Face::Left:   return subtractMorton(code, encodeMorton(extent, 0));
+        case Face::Right:  return addMorton(code, encodeMorton(extent, 0));
+        case Face::Bottom: return subtractMorton(code, encodeMorton(0, extent));
+        case Face::Top:    return addMorton(code, encodeMorton(0, extent));
+    }
+
+    return code;
+}
+
+/**
+ * @brief Returns the index of the leaf whose code range contains the given code.
+ */
+inline std::size_t containingLeaf(const std::vector<MortonCode> &codes, MortonCode code)
+{
+    return static_cast<std::size_t>(std::upper_bound(codes.begin(), codes.end(), code) - codes.begin()) - 1;
+}
+
+/**
+ * @brief Checks whether a leaf inside a neighbour cell touches the shared face.
+ */
+inline bool touchesFace(MortonCode leaf, int leafLevel, MortonCode neighbour, int level, Face face)
+{
+    switch (face)
+    {
+        case Face::Left:
+            return mortonX(leaf) + cellExtent(leafLevel) == mortonX(neighbour) + cellExtent(level);
+        case Face::Right:
+            return mortonX(leaf) == mortonX(neighbour);
+        case Face::Bottom:
+            return mortonY(leaf) + cellExtent(leafLevel) == mortonY(neighbour) + cellExtent(level);
+        case Face::Top:
+            return mortonY(leaf) == mortonY(neighbour);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Splits a leaf just enough that all target cells at the given level become leaves.
+ *
+ * @param code Code of the leaf
+ * @param level Level of the leaf
+ * @param targetLevel Level of the target cells
+ * @param first First target code inside the leaf
+ * @param last End of the target codes inside the leaf
+ */
+void splitLeaf(MortonCode code, int level, int targetLevel,
+               const MortonCode *first, const MortonCode *last,
+               std::vector<MortonCode> &codes, std::vector<std::uint8_t> &levels)
+{
+    if (level == targetLevel || first == last)
+    {
+        codes.push_back(code);
+        levels.push_back(static_cast<std::uint8_t>(level));
+        return;
+    }
+
+    for (int child = 0; child < 4; ++child)
+    {
+        MortonCode childBegin = childCode(code, level, child);
+        const MortonCode *childLast = std::lower_bound(first, last, childBegin + mortonSpan(level + 1));
+
+        splitLeaf(childBegin, level + 1, targetLevel, first, childLast, codes, levels);
+        first = childLast;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Ripples refinement requests from the finest to the coarsest level.
+ */
+void balanceLeaves(std::vector<MortonCode> &codes, std::vector<std::uint8_t> &levels)
+{
+    if (codes.empty())
+        return;
+
+    int finestLevel = *std::max_element(levels.begin(), levels.end());
+
+    std::vector<MortonCode> required;
+    std::vector<MortonCode> balancedCodes;
+    std::vector<std::uint8_t> balancedLevels;
+
+    for (int level = finestLevel; level >= 2; --level)
+    {
+        int parentLevel = level - 1;
+        required.clear();
+
+        for (std::size_t i = 0; i < codes.size(); ++i)
+        {
+            if (levels[i] != level)
+                continue;
+
+            MortonCode parent = codes[i] & ~(mortonSpan(parentLevel) - 1);
+            for (auto face : { Face::Left, Face::Right, Face::Bottom, Face::Top })
+            {
+                MortonCode neighbour = faceNeighbour(parent, parentLevel, face);
+                if (!isOutsideDomain(neighbour))
+                    required.push_back(neighbour);
+            }
+        }
+
+        if (required.empty())
+            continue;
+
+        std::sort(required.begin(), required.end());
+        required.erase(std::unique(required.begin(), required.end()), required.end());
+
+        balancedCodes.clear();
+        balancedLevels.clear();
+
+        const MortonCode *first = required.data();
+        const MortonCode *end = required.data() + required.size();
+
+        for (std::size_t i = 0; i < codes.size(); ++i)
+        {
+            const MortonCode *last = std::lower_bound(first, end, codes[i] + mortonSpan(levels[i]));
+
+            if (levels[i] < parentLevel && first != last)
+            {
+                splitLeaf(codes[i], levels[i], parentLevel, first, last, balancedCodes, balancedLevels);
+            }
+            else
+            {
+                balancedCodes.push_back(codes[i]);
+                balancedLevels.push_back(levels[i]);
+            }
+
+            first = last;
+        }
+
+        codes.swap(balancedCodes);
+        levels.swap(balancedLevels);
+    }
+}
+
+/**
+ * @brief Looks up the same-sized cell across each face and collects the leaves touching it.
+ *
+ * A coarser or equal leaf containing the neighbour cell is the only neighbour. Otherwise
+ * the neighbour cell is subdivided and its leaves touching the face are the neighbours.
+ */
+NeighbourTable buildNeighbourTable(const std::vector<MortonCode> &codes,
+                                   const std::vector<std::uint8_t> &levels)
+{
+    NeighbourTable table;
+    table.offsets.reserve(codes.size() + 1);
+    table.neighbours.reserve(4 * codes.size());
+    table.faces.reserve(4 * codes.size());
+    table.offsets.push_back(0);
+
+    for (std::size_t i = 0; i < codes.size(); ++i)
+    {
+        int level = levels[i];
+
+        for (auto face : { Face::Left, Face::Right, Face::Bottom, Face::Top })
+        {
+            MortonCode neighbour = faceNeighbour(codes[i], level, face);
+            if (isOutsideDomain(neighbour))
+                continue;
+
+            std::size_t j = containingLeaf(codes, neighbour);
+
+            if (levels[j] <= level)
+            {
+                table.neighbours.push_back(j);
+                table.faces.push_back(face);
+                continue;
+            }
+
+            MortonCode end = neighbour + mortonSpan(level);
+            for (; j < codes.size() && codes[j] < end; ++j)
+            {
+                if (touchesFace(codes[j], levels[j], neighbour, level, face))
+                {
+                    table.neighbours.push_back(j);
+                    table.faces.push_back(face);
+                }
+            }
+        }
+
+        table.offsets.push_back(table.neighbours.size());
+    }
+
+    return table;
+}
+
+/**
+ * @brief Builds the neighbour table from the leaves of the tree.
+ */
+NeighbourTable buildNeighbourTable(const LinearQuadTree &tree)
+{
+    return buildNeighbourTable(tree.codes(), tree.levels());
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,198 @@
+/**
+ * @file quadtree_file.cpp
+ * @brief Implements the binary quadtree file writer and the memory-mapped reader.
+ */
+
+#include "quadtree_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace implicit::detail
+{
+
+namespace
+{
+
+/// Magic bytes at the start of a quadtree file
+constexpr char quadTreeFileMagic[8] = { 'I', 'M', 'P', 'Q', 'T', 'R', 'E', 'E' };
+
+/// Byte order mark of the quadtree file format
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+/// Flag set if the file contains leaf states
+constexpr std::uint32_t hasStatesFlag = 1;
+
+/// Flag set if the leaves come from a truncated refinement
+constexpr std::uint32_t truncatedFlag = 2;
+
+/**
+ * @struct QuadTreeFileHeader
+ * @brief Fixed-size header of a quadtree file.
+ */
+struct QuadTreeFileHeader
+{
+    char magic[8];                ///< Magic bytes identifying the format
+    std::uint32_t version;        ///< Format version
+    std::uint32_t byteOrder;      ///< Byte order mark as written
+    double rootCell[4];           ///< Root cell as xmin, xmax, ymin, ymax
+    std::uint64_t numberOfLeaves; ///< Number of leaves
+    std::uint32_t flags;          ///< Combination of hasStatesFlag and truncatedFlag
+    std::uint32_t maxDepth;       ///< Maximum depth of the partition
+};
+
+static_assert(sizeof(QuadTreeFileHeader) == 64, "QuadTreeFileHeader must not contain padding");
+
+/**
+ * @brief Rounds a byte count up to a multiple of 8, so that the arrays stay aligned.
+ */
+std::uint64_t padded(std::uint64_t size)
+{
+    return (size + 7) / 8 * 8;
+}
+
+} // namespace
+
+/**
+ * @brief Writes header, codes, padded levels and optional states.
+ */
+void writeQuadTreeFile(const LinearQuadTree &tree, const std::string &filename)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("writeQuadTreeFile: cannot open output file " + filename);
+
+    Cell2D root = tree.rootCell();
+    std::size_t n = tree.size();
+
+    QuadTreeFileHeader header;
+    std::memcpy(header.magic, quadTreeFileMagic, sizeof(header.magic));
+    header.version = quadTreeFileVersion;
+    header.byteOrder = byteOrderMark;
+    header.rootCell[0] = root[0][0];
+    header.rootCell[1] = root[0][1];
+    header.rootCell[2] = root[1][0];
+    header.rootCell[3] = root[1][1];
+    header.numberOfLeaves = n;
+    header.flags = (tree.hasStates() ? hasStatesFlag : 0) | (tree.truncated() ? truncatedFlag : 0);
+    header.maxDepth = static_cast<std::uint32_t>(tree.maxDepth());
+
+    const char padding[8] = { };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(tree.codes().data()), static_cast<std::streamsize>(n * sizeof(MortonCode)));
+    file.write(reinterpret_cast<const char *>(tree.levels().data()), static_cast<std::streamsize>(n));
+    file.write(padding, static_cast<std::streamsize>(padded(n) - n));
+
+    if (tree.hasStates())
+    {
+        std::vector<std::uint8_t> states(n);
+        for (std::size_t i = 0; i < n; ++i)
+            states[i] = static_cast<std::uint8_t>(tree.state(i));
+        file.write(reinterpret_cast<const char *>(states.data()), static_cast<std::streamsize>(n));
+    }
+
+    if (!file)
+        throw std::runtime_error("writeQuadTreeFile: cannot write output file " + filename);
+}
+
+/**
+ * @brief Maps the file, checks header, size, levels and states and points the leaf arrays into the mapping.
+ */
+MappedQuadTree::MappedQuadTree(const std::string &filename)
+        : file_(filename)
+{
+    QuadTreeFileHeader header;
+    if (file_.size() < sizeof(header) ||
+        std::memcmp(file_.data(), quadTreeFileMagic, sizeof(quadTreeFileMagic)) != 0)
+        throw std::runtime_error("MappedQuadTree: " + filename + " is not a quadtree file");
+
+    std::memcpy(&header, file_.data(), sizeof(header));
+
+    if (header.byteOrder != byteOrderMark)
+        throw std::runtime_error("MappedQuadTree: " + filename + " was written with another byte order");
+    if (header.version != quadTreeFileVersion)
+        throw std::runtime_error("MappedQuadTree: unsupported file version in " + filename);
+    if (header.maxDepth > static_cast<std::uint32_t>(maxMortonLevel))
+        throw std::runtime_error("MappedQuadTree: maximum depth in " + filename + " exceeds the Morton code resolution");
+
+    // Bytes per leaf: code, level (padded as a whole) and optionally state
+    std::uint64_t available = file_.size() - sizeof(header);
+    std::uint64_t n = header.numberOfLeaves;
+    bool states = header.flags & hasStatesFlag;
+    if (n == 0 || n > available / (sizeof(MortonCode) + 1 + states) ||
+        n * sizeof(MortonCode) + padded(n) + (states ? n : 0) > available)
+        throw std::runtime_error("MappedQuadTree: truncated quadtree file " + filename);
+
+    rootCell_ = { Bounds { header.rootCell[0], header.rootCell[1] }, Bounds { header.rootCell[2], header.rootCell[3] } };
+    size_ = static_cast<std::size_t>(n);
+    maxDepth_ = static_cast<int>(header.maxDepth);
+    truncated_ = header.flags & truncatedFlag;
+
+    // The mapping is page aligned and the header and code array are multiples of 8 bytes
+    const char *data = file_.data() + sizeof(header);
+    codes_ = reinterpret_cast<const MortonCode *>(data);
+    levels_ = reinterpret_cast<const std::uint8_t *>(data + n * sizeof(MortonCode));
+    if (states)
+        states_ = levels_ + padded(n);
+
+    // Out-of-range levels would overflow the shifts in cellFromCode, and out-of-range
+    // states are no valid CellClassification
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        if (levels_[i] > header.maxDepth)
+            throw std::runtime_error("MappedQuadTree: leaf level exceeds the maximum depth in " + filename);
+        if (states_ && states_[i] > static_cast<std::uint8_t>(CellClassification::Cut))
+            throw std::runtime_error("MappedQuadTree: invalid leaf state in " + filename);
+    }
+}
+
+/**
+ * @brief Replays the subdivision path of the leaf from the root cell.
+ */
+Cell2D MappedQuadTree::cell(std::size_t index) const
+{
+    return LinearQuadTree::cellFromCode(rootCell_, codes_[index], levels_[index]);
+}
+
+/**
+ * @brief Collects the bounds and levels of all leaves.
+ */
+CellsAndLevels MappedQuadTree::getLeafCells() const
+{
+    CellsAndLevels data;
+    data.first.reserve(size_);
+    data.second.reserve(size_);
+
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        data.first.push_back(cell(i));
+        data.second.push_back(levels_[i]);
+    }
+
+    return data;
+}
+
+/**
+ * @brief Copies the mapped arrays into the members of a new tree.
+ */
+LinearQuadTree MappedQuadTree::toLinearQuadTree() const
+{
+    LinearQuadTree tree(rootCell_);
+    tree.codes_.assign(codes_, codes_ + size_);
+    tree.levels_.assign(levels_, levels_ + size_);
+    tree.maxDepth_ = maxDepth_;
+    tree.truncated_ = truncated_;
+
+    if (states_)
+    {
+        tree.states_.resize(size_);
+        for (std::size_t i = 0; i < size_; ++i)
+            tree.states_[i] = state(i);
+    }
+
+    return tree;
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,189 @@
+/**
+ * @file quadtree_integration.cpp
+ * @brief Implements the moment integration over quadtree leaves.
+ */
+
+#include "quadtree_integration.h"
+#include "AbsImplicitGeometry.hpp"
+#include "simd_helper.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace implicit::detail
+{
+
+/**
+ * @brief Adds all integrals component-wise.
+ */
+Moments &Moments::operator+=(const Moments &other)
+{
+    area += other.area;
+    x += other.x;
+    y += other.y;
+    xx += other.xx;
+    xy += other.xy;
+    yy += other.yy;
+    return *this;
+}
+
+/**
+ * @brief Divides the first moments by the area.
+ */
+std::array<double, 2> Moments::centroid() const
+{
+    if (area == 0.0)
+        return { 0.0, 0.0 };
+    return { x / area, y / area };
+}
+
+/**
+ * @brief Shifts the second moments to the centroid (parallel axis theorem).
+ */
+std::array<double, 3> Moments::centralSecondMoments() const
+{
+    if (area == 0.0)
+        return { 0.0, 0.0, 0.0 };
+
+    auto c = centroid();
+    return { xx - area * c[0] * c[0], xy - area * c[0] * c[1], yy - area * c[1] * c[1] };
+}
+
+/**
+ * @brief Evaluates the closed-form integrals over the rectangle.
+ */
+Moments cellMoments(Cell2D cell)
+{
+    double a = cell[0][0], b = cell[0][1];
+    double c = cell[1][0], d = cell[1][1];
+
+    double ix0 = b - a, iy0 = d - c;
+    double ix1 = 0.5 * (b * b - a * a), iy1 = 0.5 * (d * d - c * c);
+    double ix2 = (b * b * b - a * a * a) / 3.0, iy2 = (d * d * d - c * c * c) / 3.0;
+
+    Moments moments;
+    moments.area = ix0 * iy0;
+    moments.x = ix1 * iy0;
+    moments.y = ix0 * iy1;
+    moments.xx = ix2 * iy0;
+    moments.xy = ix1 * iy1;
+    moments.yy = ix0 * iy2;
+    return moments;
+}
+
+namespace
+{
+
+/**
+ * @brief Integrates a cut leaf by classifying the centers of its sub-cells in batches.
+ */
+Moments integrateCutCell(const AbsImplicitGeometry &geometry, Cell2D cell, int n)
+{
+    double xmin = cell[0][0], ymin = cell[1][0];
+    double hx = (cell[0][1] - xmin) / n;
+    double hy = (cell[1][1] - ymin) / n;
+
+    double xs[maxBatchSize];
+    double ys[maxBatchSize];
+    std::size_t size = 0;
+
+    Moments moments;
+
+    auto evaluateBlock = [&]()
+    {
+        PointMask mask = geometry.insideBatch(xs, ys, size);
+        for (std::size_t k = 0; k < size; ++k)
+        {
+            if ((mask >> k) & 1)
+            {
+                Cell2D sub { Bounds { xs[k] - 0.5 * hx, xs[k] + 0.5 * hx },
+                             Bounds { ys[k] - 0.5 * hy, ys[k] + 0.5 * hy } };
+                moments += cellMoments(sub);
+            }
+        }
+        size = 0;
+    };
+
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            xs[size] = (i + 0.5) * hx + xmin;
+            ys[size] = (j + 0.5) * hy + ymin;
+
+            if (++size == maxBatchSize)
+                evaluateBlock();
+        }
+    }
+
+    if (size != 0)
+        evaluateBlock();
+
+    return moments;
+}
+
+} // namespace
+
+/**
+ * @brief Divides the leaf moments by the leaf area.
+ */
+double IntegrationResult::areaFraction(const std::vector<Cell2D> &cells, std::size_t index) const
+{
+    return leaves[index].area / cellMoments(cells[index]).area;
+}
+
+/**
+ * @brief Integrates contiguous ranges of leaves as separate tasks and sums them in order.
+ */
+IntegrationResult integrateLeaves(const AbsImplicitGeometry &geometry,
+                                  const std::vector<Cell2D> &cells,
+                                  const IntegrationOptions &options)
+{
+    IntegrationResult result;
+    result.leaves.resize(cells.size());
+
+    auto integrateRange = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            switch (geometry.classify(cells[i]))
+            {
+                case CellClassification::Inside:
+                    result.leaves[i] = cellMoments(cells[i]);
+                    break;
+                case CellClassification::Outside:
+                    break;
+                case CellClassification::Cut:
+                    result.leaves[i] = integrateCutCell(geometry, cells[i], options.samplesPerAxis);
+                    break;
+            }
+        }
+    };
+
+    if (options.numberOfThreads == 1)
+    {
+        integrateRange(0, cells.size());
+    }
+    else
+    {
+        ThreadPool pool(options.numberOfThreads);
+        std::size_t numberOfRanges = 4 * pool.size();
+        std::size_t rangeSize = (cells.size() + numberOfRanges - 1) / numberOfRanges;
+
+        TaskGroup group;
+        for (std::size_t begin = 0; begin < cells.size(); begin += rangeSize)
+            pool.spawn(group, [&, begin]()
+            {
+                integrateRange(begin, std::min(begin + rangeSize, cells.size()));
+            });
+
+        pool.wait(group);
+    }
+
+    for (const auto &leaf : result.leaves)
+        result.total += leaf;
+
+    return result;
+}
+
+} // namespace implicit::detail
@@ -0,0 +1,154 @@
+/**
+ * @file quadtree_stats.cpp
+ * @brief Implements the statistics collected during quadtree generation.
+ */
+
+#include "quadtree_helper.h"
+#include "AbsOperation.hpp"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Union.hpp"
+#include "Intersection.hpp"
+#include "Difference.hpp"
+#include "NaryUnion.hpp"
+#include "NaryIntersection.hpp"
+#include "IndexedUnion.hpp"
+#include "CompiledGeometry.hpp"
+
+namespace implicit
+{
+
+/**
+ * @brief Divides the cut cells by the tested cells of a level.
+ */
+double QuadTreeStats::cutRatio(int level) const
+{
+    if (level < 0 || level >= maxLevels)
+        return 0.0;
+
+    std::size_t cells = cellsPerLevel[level].load();
+    return cells ? static_cast<double>(cutCellsPerLevel[level].load()) / static_cast<double>(cells) : 0.0;
+}
+
+/**
+ * @brief Clears all counters, node statistics and timings.
+ */
+void QuadTreeStats::reset()
+{
+    for (int level = 0; level < maxLevels; ++level)
+    {
+        cellsPerLevel[level] = 0;
+        cutCellsPerLevel[level] = 0;
+    }
+
+    geometryNodes.clear();
+    partitionSeconds = 0.0;
+    collectSeconds = 0.0;
+    writeSeconds = 0.0;
+}
+
+#ifdef IMPLICIT_ENABLE_STATS
+namespace detail
+{
+
+namespace
+{
+
+/**
+ * @brief Returns the class name of a geometry node.
+ */
+std::string geometryType(const AbsImplicitGeometry &geometry)
+{
+    if (dynamic_cast<const Circle *>(&geometry)) return "Circle";
+    if (dynamic_cast<const Rectangle *>(&geometry)) return "Rectangle";
+    if (dynamic_cast<const Union *>(&geometry)) return "Union";
+    if (dynamic_cast<const Intersection *>(&geometry)) return "Intersection";
+    if (dynamic_cast<const Difference *>(&geometry)) return "Difference";
+    if (dynamic_cast<const IndexedUnion *>(&geometry)) return "IndexedUnion";
+    if (dynamic_cast<const NaryUnion *>(&geometry)) return "NaryUnion";
+    if (dynamic_cast<const NaryIntersection *>(&geometry)) return "NaryIntersection";
+    if (dynamic_cast<const CompiledGeometry *>(&geometry)) return "CompiledGeometry";
+    return "AbsImplicitGeometry";
+}
+
+/**
+ * @brief Preorder traversal helper of collectGeometryNodes.
+ */
+void collectGeometryNodes(const AbsImplicitGeometry &geometry, int depth,
+                          std::vector<GeometryNodeStats> &nodes)
+{
+    nodes.push_back({ &geometry, geometryType(geometry), depth, geometry.numberOfEvaluations() });
+
+    if (auto operation = dynamic_cast<const AbsOperation *>(&geometry))
+    {
+        collectGeometryNodes(*operation->operand1(), depth + 1, nodes);
+        collectGeometryNodes(*operation->operand2(), depth + 1, nodes);
+    }
+    else if (auto naryOperation = dynamic_cast<const AbsNaryOperation *>(&geometry))
+    {
+        for (const auto &operand : naryOperation->operands())
+            collectGeometryNodes(*operand, depth + 1, nodes);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Lists the geometry tree starting at depth zero.
+ */
+void collectGeometryNodes(const AbsImplicitGeometry &geometry, std::vector<GeometryNodeStats> &nodes)
+{
+    collectGeometryNodes(geometry, 0, nodes);
+}
+
+/**
+ * @brief Records the evaluation counts of all geometry nodes and starts the clock.
+ */
+StatsScope::StatsScope(const AbsImplicitGeometry &geometry, QuadTreeStats *stats)
+        : geometry_(geometry), stats_(stats), lastLap_(Clock::now()), writeSecondsAtLastLap_(0.0)
+{
+    if (!stats_) return;
+
+    collectGeometryNodes(geometry_, startNodes_);
+    writeSecondsAtLastLap_ = stats_->writeSeconds;
+}
+
+/**
+ * @brief Stores the number of evaluations per node since construction.
+ *
+ * A node reachable along several paths of the tree is listed once per path.
+ */
+StatsScope::~StatsScope()
+{
+    if (!stats_) return;
+
+    std::vector<GeometryNodeStats> nodes;
+    collectGeometryNodes(geometry_, nodes);
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        nodes[i].pointEvaluations -= startNodes_[i].pointEvaluations;
+
+    stats_->geometryNodes = std::move(nodes);
+}
+
+/**
+ * @brief Adds the time since the previous lap, minus streamed write time, to a phase.
+ */
+void StatsScope::lap(double QuadTreeStats::*phase)
+{
+    if (!stats_) return;
+
+    auto now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastLap_).count();
+    double written = stats_->writeSeconds - writeSecondsAtLastLap_;
+
+    stats_->*phase += elapsed - written;
+
+    lastLap_ = now;
+    writeSecondsAtLastLap_ = stats_->writeSeconds;
+}
+
+} // namespace detail
+#endif
+
+} // namespace implicit
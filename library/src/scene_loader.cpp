@@ -0,0 +1,309 @@
+/**
+ * @file scene_loader.cpp
+ * @brief Implements the streaming text scene parser and the binary scene format.
+ */
+
+#include "scene_loader.h"
+#include "mapped_file.h"
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace implicit
+{
+
+namespace
+{
+
+/// Magic bytes at the start of a binary scene file
+constexpr char binarySceneMagic[8] = { 'I', 'M', 'P', 'S', 'C', 'E', 'N', 'E' };
+
+/// Byte order mark of the binary scene format
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+/**
+ * @struct BinarySceneHeader
+ * @brief Fixed-size header of a binary scene file.
+ */
+struct BinarySceneHeader
+{
+    char magic[8];                       ///< Magic bytes identifying the format
+    std::uint32_t version;               ///< Format version
+    std::uint32_t byteOrder;             ///< Byte order mark as written
+    std::uint64_t numberOfInstructions;  ///< Length of the instruction stream
+    std::uint64_t numberOfParameters;    ///< Number of primitive parameters
+};
+
+static_assert(sizeof(BinarySceneHeader) == 32, "BinarySceneHeader must not contain padding");
+
+/**
+ * @brief Rounds a byte count up to a multiple of 8, so that the parameters are aligned.
+ */
+std::uint64_t padded(std::uint64_t size)
+{
+    return (size + 7) / 8 * 8;
+}
+
+/**
+ * @class SceneParser
+ * @brief Single pass over a text scene that emits the postfix program.
+ */
+class SceneParser
+{
+public:
+    explicit SceneParser(std::string_view text)
+            : position_(text.data()), end_(text.data() + text.size())
+    { }
+
+    /**
+     * @brief Parses the whole text.
+     */
+    std::shared_ptr<CompiledGeometry> parse()
+    {
+        using OpCode = CompiledGeometry::OpCode;
+
+        std::size_t depth = 0;
+
+        for (std::string_view keyword = next(); !keyword.empty(); keyword = next())
+        {
+            if (keyword == "circle")
+            {
+                push(depth, OpCode::Circle, 3);
+            }
+            else if (keyword == "rectangle")
+            {
+                push(depth, OpCode::Rectangle, 4);
+            }
+            else if (keyword == "union" || keyword == "intersection" || keyword == "difference")
+            {
+                if (depth < 2)
+                    fail("'" + std::string(keyword) + "' needs two operands");
+                --depth;
+                instructions_.push_back(keyword == "union" ? OpCode::Union :
+                                        keyword == "intersection" ? OpCode::Intersection : OpCode::Difference);
+            }
+            else
+            {
+                fail("unknown keyword '" + std::string(keyword) + "'");
+            }
+        }
+
+        if (depth != 1)
+            fail(depth == 0 ? "scene is empty" : "scene leaves " + std::to_string(depth) + " geometries uncombined");
+
+        return std::make_shared<CompiledGeometry>(std::move(instructions_), std::move(parameters_));
+    }
+
+private:
+    /**
+     * @brief Emits a primitive and reads its parameters.
+     */
+    void push(std::size_t &depth, CompiledGeometry::OpCode code, int numberOfParameters)
+    {
+        if (++depth > CompiledGeometry::maxStackDepth)
+            fail("too many geometries are waiting to be combined; combine them earlier");
+
+        instructions_.push_back(code);
+        for (int i = 0; i < numberOfParameters; ++i)
+            parameters_.push_back(number());
+    }
+
+    /**
+     * @brief Skips whitespace and comments, counting lines.
+     */
+    void skip()
+    {
+        while (position_ != end_)
+        {
+            char c = *position_;
+            if (c == '#')
+            {
+                while (position_ != end_ && *position_ != '\n')
+                    ++position_;
+            }
+            else if (c == '\n')
+            {
+                ++line_;
+                ++position_;
+            }
+            else if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+            {
+                ++position_;
+            }
+            else
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Checks whether a character ends a token.
+     */
+    static bool isDelimiter(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v' || c == '#';
+    }
+
+    /**
+     * @brief Returns the next token, or an empty view at the end of the text.
+     */
+    std::string_view next()
+    {
+        skip();
+        const char *begin = position_;
+        while (position_ != end_ && !isDelimiter(*position_))
+            ++position_;
+        return { begin, static_cast<std::size_t>(position_ - begin) };
+    }
+
+    /**
+     * @brief Reads the next token as a number.
+     */
+    double number()
+    {
+        std::string_view token = next();
+        if (token.empty())
+            fail("unexpected end of the scene, expected a number");
+
+        double value = 0.0;
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (result.ec != std::errc() || result.ptr != token.data() + token.size())
+            fail("expected a number, found '" + std::string(token) + "'");
+
+        return value;
+    }
+
+    /**
+     * @brief Throws a parse error for the current line.
+     */
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw std::runtime_error("parseScene: line " + std::to_string(line_) + ": " + message);
+    }
+
+    const char *position_;  ///< Next character to read
+    const char *end_;       ///< End of the text
+    std::size_t line_ = 1;  ///< Line of the next character
+
+    std::vector<CompiledGeometry::OpCode> instructions_;  ///< Program emitted so far
+    std::vector<double> parameters_;                      ///< Parameters emitted so far
+};
+
+/**
+ * @brief Reads the program of a binary scene straight into the vectors of the geometry.
+ */
+std::shared_ptr<CompiledGeometry> readBinaryScene(std::ifstream &file, std::uint64_t size, const std::string &filename)
+{
+    BinarySceneHeader header;
+    if (size < sizeof(header) || !file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        throw std::runtime_error("loadScene: truncated binary scene " + filename);
+
+    if (header.byteOrder != byteOrderMark)
+        throw std::runtime_error("loadScene: binary scene " + filename + " was written with another byte order");
+    if (header.version != binarySceneVersion)
+        throw std::runtime_error("loadScene: unsupported binary scene version in " + filename);
+
+    std::uint64_t available = size - sizeof(header);
+    std::uint64_t instructionBytes = padded(header.numberOfInstructions);
+    if (header.numberOfInstructions > available || instructionBytes > available ||
+        header.numberOfParameters > (available - instructionBytes) / sizeof(double))
+        throw std::runtime_error("loadScene: truncated binary scene " + filename);
+
+    using OpCode = CompiledGeometry::OpCode;
+
+    std::vector<OpCode> code(header.numberOfInstructions);
+    file.read(reinterpret_cast<char *>(code.data()), static_cast<std::streamsize>(code.size()));
+    file.seekg(static_cast<std::streamoff>(sizeof(header) + instructionBytes));
+
+    std::vector<double> values(header.numberOfParameters);
+    file.read(reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+
+    if (!file)
+        throw std::runtime_error("loadScene: cannot read binary scene " + filename);
+
+    try
+    {
+        return std::make_shared<CompiledGeometry>(std::move(code), std::move(values));
+    }
+    catch (const std::logic_error &error)
+    {
+        throw std::runtime_error("loadScene: invalid program in " + filename + ": " + error.what());
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Runs the parser on the text.
+ */
+std::shared_ptr<CompiledGeometry> parseScene(std::string_view text)
+{
+    return SceneParser(text).parse();
+}
+
+/**
+ * @brief Dispatches on the magic bytes; binary scenes are read, text scenes are mapped.
+ */
+std::shared_ptr<CompiledGeometry> loadScene(const std::string &filename)
+{
+    {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("loadScene: cannot open file " + filename);
+
+        auto size = static_cast<std::uint64_t>(file.tellg());
+        file.seekg(0);
+
+        char magic[sizeof(binarySceneMagic)];
+        if (size >= sizeof(magic) && file.read(magic, sizeof(magic)) &&
+            std::memcmp(magic, binarySceneMagic, sizeof(magic)) == 0)
+        {
+            file.seekg(0);
+            return readBinaryScene(file, size, filename);
+        }
+    }
+
+    detail::MappedFile file(filename);
+
+    return parseScene({ file.data(), file.size() });
+}
+
+/**
+ * @brief Writes header, padded instructions and parameters.
+ */
+void writeBinaryScene(const CompiledGeometry &geometry, const std::string &filename)
+{
+    const auto &instructions = geometry.instructions();
+    const auto &parameters = geometry.parameters();
+
+    for (auto code : instructions)
+        if (code == CompiledGeometry::OpCode::External)
+            throw std::invalid_argument("writeBinaryScene: geometry references external geometries");
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("writeBinaryScene: cannot open output file " + filename);
+
+    BinarySceneHeader header;
+    std::memcpy(header.magic, binarySceneMagic, sizeof(header.magic));
+    header.version = binarySceneVersion;
+    header.byteOrder = byteOrderMark;
+    header.numberOfInstructions = instructions.size();
+    header.numberOfParameters = parameters.size();
+
+    const char padding[8] = { };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(instructions.data()), static_cast<std::streamsize>(instructions.size()));
+    file.write(padding, static_cast<std::streamsize>(padded(instructions.size()) - instructions.size()));
+    file.write(reinterpret_cast<const char *>(parameters.data()),
+               static_cast<std::streamsize>(parameters.size() * sizeof(double)));
+
+    if (!file)
+        throw std::runtime_error("writeBinaryScene: cannot write output file " + filename);
+}
+
+} // namespace implicit
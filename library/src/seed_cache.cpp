@@ -0,0 +1,179 @@
+/**
+ * @file seed_cache.cpp
+ * @brief Implements the seed point memoization table.
+ */
+
+#include "seed_cache.h"
+
+#include <cmath>
+
+namespace implicit::detail
+{
+
+namespace
+{
+
+/// Marker for empty slots (no valid key has all bits set)
+constexpr std::uint64_t emptySlot = ~std::uint64_t(0);
+
+/// Initial number of slots (power of two)
+constexpr std::size_t initialCapacity = 1024;
+
+} // namespace
+
+/**
+ * @brief Constructs an empty cache with (numberOfSeedPoints - 1) * 2^levels lattice intervals per axis.
+ */
+SeedPointCache::SeedPointCache(Cell2D rootCell, int levels, int numberOfSeedPoints, std::size_t maxSize)
+        : slots_(initialCapacity, emptySlot), size_(0), rootCell_(rootCell),
+          resolution_(std::uint64_t(numberOfSeedPoints - 1) << levels),
+          numberOfSeedPoints_(numberOfSeedPoints), maxSize_(maxSize)
+{ }
+
+/**
+ * @brief Keys are ix * (resolution + 1) + iy shifted by one bit, so the lattice must stay below 2^31 points per axis.
+ */
+bool SeedPointCache::isSupported(int levels, int numberOfSeedPoints)
+{
+    return numberOfSeedPoints >= 2 && levels >= 0 && levels < 62 &&
+           (std::uint64_t(numberOfSeedPoints - 1) << levels) < (std::uint64_t(1) << 31);
+}
+
+/**
+ * @brief Evaluates the seeds missing from the cache in batches and counts interior hits.
+ *
+ * With early exit, the visit order is the same as for uncached sampling: corners,
+ * center (for an odd number of seeds), then the remaining seeds in row-major order.
+ */
+bool SeedPointCache::isCutByBoundary(Cell2D cell, const AbsImplicitGeometry &geometry, bool earlyExit)
+{
+    double rootXmin = rootCell_[0][0], rootWidth = rootCell_[0][1] - rootCell_[0][0];
+    double rootYmin = rootCell_[1][0], rootHeight = rootCell_[1][1] - rootCell_[1][0];
+    double scale = static_cast<double>(resolution_);
+
+    // Cells are dyadic subdivisions of the root, so these roundings are exact
+    auto ix0 = static_cast<std::uint64_t>(std::llround((cell[0][0] - rootXmin) / rootWidth * scale));
+    auto iy0 = static_cast<std::uint64_t>(std::llround((cell[1][0] - rootYmin) / rootHeight * scale));
+    auto extent = static_cast<std::uint64_t>(std::llround((cell[0][1] - cell[0][0]) / rootWidth * scale));
+    std::uint64_t step = extent / (numberOfSeedPoints_ - 1);
+
+    double xs[maxBatchSize];
+    double ys[maxBatchSize];
+    std::uint64_t keys[maxBatchSize];
+    std::size_t pending = 0;
+
+    std::size_t count = 0;
+    std::size_t evaluated = 0;
+
+    auto disagree = [&]()
+    {
+        return earlyExit && count != 0 && count != evaluated;
+    };
+
+    auto evaluatePending = [&]()
+    {
+        PointMask mask = geometry.insideBatch(xs, ys, pending);
+        for (std::size_t k = 0; k < pending; ++k)
+        {
+            bool inside = (mask >> k) & 1;
+            count += inside;
+
+            if (maxSize_ != 0 && size_ >= maxSize_)
+                continue;
+
+            std::size_t slot = findSlot(keys[k]);
+            if (slots_[slot] == emptySlot)
+            {
+                slots_[slot] = keys[k] << 1 | inside;
+                if (2 * ++size_ > slots_.size())
+                    grow();
+            }
+        }
+        evaluated += pending;
+        pending = 0;
+        return disagree();
+    };
+
+    // Looks up or queues one seed and reports whether the seeds disagree so far
+    auto visit = [&](int i, int j)
+    {
+        std::uint64_t ix = ix0 + i * step;
+        std::uint64_t iy = iy0 + j * step;
+        std::uint64_t key = ix * (resolution_ + 1) + iy;
+
+        std::uint64_t entry = slots_[findSlot(key)];
+        if (entry != emptySlot)
+        {
+            count += entry & 1;
+            ++evaluated;
+            return disagree();
+        }
+
+        xs[pending] = ix / scale * rootWidth + rootXmin;
+        ys[pending] = iy / scale * rootHeight + rootYmin;
+        keys[pending] = key;
+
+        return ++pending == maxBatchSize && evaluatePending();
+    };
+
+    int last = numberOfSeedPoints_ - 1;
+    int center = numberOfSeedPoints_ % 2 ? last / 2 : -1;
+
+    auto isPriority = [&](int i, int j)
+    {
+        return earlyExit && (((i == 0 || i == last) && (j == 0 || j == last)) || (i == center && j == center));
+    };
+
+    if (earlyExit)
+    {
+        for (int i : { 0, last })
+            for (int j : { 0, last })
+                if (visit(i, j))
+                    return true;
+
+        if (center >= 0 && visit(center, center))
+            return true;
+
+        if (pending != 0 && evaluatePending())
+            return true;
+    }
+
+    for (int i = 0; i < numberOfSeedPoints_; ++i)
+        for (int j = 0; j < numberOfSeedPoints_; ++j)
+            if (!isPriority(i, j) && visit(i, j))
+                return true;
+
+    if (pending != 0)
+        evaluatePending();
+
+    return count != 0 && count != evaluated;
+}
+
+/**
+ * @brief Linear probing with a multiplicative (Fibonacci) hash.
+ */
+std::size_t SeedPointCache::findSlot(std::uint64_t key) const
+{
+    std::size_t mask = slots_.size() - 1;
+    std::size_t slot = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 20) & mask;
+
+    while (slots_[slot] != emptySlot && (slots_[slot] >> 1) != key)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+/**
+ * @brief Rehashes all entries into a table of twice the size.
+ */
+void SeedPointCache::grow()
+{
+    std::vector<std::uint64_t> old(slots_.size() * 2, emptySlot);
+    old.swap(slots_);
+
+    for (std::uint64_t entry : old)
+        if (entry != emptySlot)
+            slots_[findSlot(entry >> 1)] = entry;
+}
+
+} // namespace implicit::detail
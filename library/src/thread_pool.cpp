@@ -0,0 +1,181 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implements the work-stealing thread pool.
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace implicit::detail
+{
+
+namespace
+{
+
+/// Pool and deque index of the current worker thread
+struct WorkerIdentity
+{
+    const void *pool = nullptr;
+    std::size_t index = 0;
+};
+
+thread_local WorkerIdentity currentWorker;
+
+} // namespace
+
+/**
+ * @brief Creates one deque per thread and starts the workers for slots 1 to N-1.
+ */
+ThreadPool::ThreadPool(std::size_t numberOfThreads)
+{
+    if (numberOfThreads == 0)
+        numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (std::size_t i = 0; i < numberOfThreads; ++i)
+        queues_.push_back(std::make_unique<Queue>());
+
+    for (std::size_t i = 1; i < numberOfThreads; ++i)
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+/**
+ * @brief Signals shutdown and joins the workers.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_all();
+
+    for (auto &worker : workers_)
+        worker.join();
+}
+
+/**
+ * @brief Pushes the task to the back of the calling thread's deque.
+ */
+void ThreadPool::spawn(TaskGroup &group, std::function<void()> task)
+{
+    group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    Queue &queue = *queues_[currentIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({ std::move(task), &group });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        queuedTasks_.fetch_add(1, std::memory_order_relaxed);
+    }
+    wakeup_.notify_one();
+}
+
+/**
+ * @brief Helps executing tasks while the group is unfinished and sleeps while all deques are empty.
+ */
+void ThreadPool::wait(TaskGroup &group)
+{
+    std::size_t index = currentIndex();
+
+    while (group.pending_.load(std::memory_order_acquire) != 0)
+    {
+        if (!runOneTask(index))
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeup_.wait(lock, [&]()
+            {
+                return group.pending_.load(std::memory_order_acquire) == 0 || queuedTasks_ != 0;
+            });
+        }
+    }
+
+    if (group.exception_)
+        std::rethrow_exception(group.exception_);
+}
+
+/**
+ * @brief Workers know their slot; all other threads use slot 0.
+ */
+std::size_t ThreadPool::currentIndex() const
+{
+    return currentWorker.pool == this ? currentWorker.index : 0;
+}
+
+/**
+ * @brief Takes the newest own task, or else the oldest task of another thread.
+ */
+bool ThreadPool::runOneTask(std::size_t index)
+{
+    Task task;
+    bool found = false;
+
+    for (std::size_t offset = 0; offset < queues_.size() && !found; ++offset)
+    {
+        Queue &queue = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            if (offset == 0)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    queuedTasks_.fetch_sub(1, std::memory_order_relaxed);
+
+    try
+    {
+        task.function();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(task.group->exceptionMutex_);
+        if (!task.group->exception_)
+            task.group->exception_ = std::current_exception();
+    }
+
+    // The group may be destroyed by its waiter as soon as the count reaches zero
+    if (task.group->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // Locking orders the notification after the check of a thread about to sleep
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        wakeup_.notify_all();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Executes tasks and sleeps while all deques are empty.
+ */
+void ThreadPool::workerLoop(std::size_t index)
+{
+    currentWorker = { this, index };
+
+    while (!stop_)
+    {
+        if (!runOneTask(index))
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeup_.wait(lock, [this]() { return stop_ || queuedTasks_ != 0; });
+        }
+    }
+}
+
+} // namespace implicit::detail
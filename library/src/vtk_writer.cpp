@@ -0,0 +1,337 @@
+/**
+ * @file vtk_writer.cpp
+ * @brief Implements the binary VTK export and the streaming VTK writer.
+ *
+ * Legacy binary VTK files store all numbers in big-endian byte order. The data is
+ * serialized into a buffer that is flushed in large blocks, so the writer is bound by
+ * the disk bandwidth rather than by formatted stream output.
+ */
+
+#include "quadtree_helper.h"
+#include "leaf_sink.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace implicit::detail
+{
+
+namespace
+{
+
+/// Size of the output buffer flushed to the file
+constexpr std::size_t bufferSize = 1 << 20;
+
+/**
+ * @class BigEndianWriter
+ * @brief Buffered writer for big-endian binary data.
+ */
+class BigEndianWriter
+{
+public:
+    explicit BigEndianWriter(std::ofstream &file)
+            : file_(file)
+    { }
+
+    ~BigEndianWriter()
+    {
+        flush();
+    }
+
+    void writeText(const std::string &text)
+    {
+        buffer_.insert(buffer_.end(), text.begin(), text.end());
+        flushIfFull();
+    }
+
+    void writeInt32(std::int32_t value)
+    {
+        auto bits = static_cast<std::uint32_t>(value);
+        for (int shift = 24; shift >= 0; shift -= 8)
+            buffer_.push_back(static_cast<char>((bits >> shift) & 0xFF));
+        flushIfFull();
+    }
+
+    void writeDouble(double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int shift = 56; shift >= 0; shift -= 8)
+            buffer_.push_back(static_cast<char>((bits >> shift) & 0xFF));
+        flushIfFull();
+    }
+
+    void flush()
+    {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+private:
+    void flushIfFull()
+    {
+        if (buffer_.size() >= bufferSize)
+            flush();
+    }
+
+    std::ofstream &file_;
+    std::vector<char> buffer_;
+};
+
+/// Width of the fixed-size point count field patched by the streaming writer
+constexpr int countFieldWidth = 20;
+
+/// Finest level whose corner lattice indices are still rounded exactly by std::llround
+constexpr unsigned int maxLatticeLevel = 62;
+
+/// Corner point by its integer coordinates on the lattice of the finest level
+using LatticePoint = std::pair<std::uint64_t, std::uint64_t>;
+
+/// Mixes both lattice coordinates with a multiplicative (Fibonacci) hash
+struct LatticePointHash
+{
+    std::size_t operator()(const LatticePoint &point) const
+    {
+        return std::hash<std::uint64_t>()(point.first * 0x9E3779B97F4A7C15ull ^ point.second);
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Writes a legacy binary VTK file with shared corner points.
+ *
+ * Corners are identified by their integer coordinates on the lattice of the finest
+ * level found in the data, which is exact for quadtree leaves.
+ */
+void writeCellsToBinaryVtkFile(const CellsAndLevels &data, const std::string &filename)
+{
+    const auto &cells = data.first;
+    const auto &levels = data.second;
+    std::size_t numberOfCells = cells.size();
+
+    Cell2D domain = numberOfCells ? cells.front() : Cell2D { };
+    unsigned int maxLevel = 0;
+    for (std::size_t i = 0; i < numberOfCells; ++i)
+    {
+        domain[0][0] = std::min(domain[0][0], cells[i][0][0]);
+        domain[0][1] = std::max(domain[0][1], cells[i][0][1]);
+        domain[1][0] = std::min(domain[1][0], cells[i][1][0]);
+        domain[1][1] = std::max(domain[1][1], cells[i][1][1]);
+        maxLevel = std::max(maxLevel, levels[i]);
+    }
+
+    if (maxLevel > maxLatticeLevel)
+        throw std::invalid_argument("writeCellsToBinaryVtkFile: cell level exceeds the corner lattice resolution");
+
+    std::ofstream outfile(filename, std::ios::binary);
+    if (!outfile.is_open())
+        throw std::runtime_error("writeCellsToBinaryVtkFile: cannot open output file " + filename);
+
+    double resolution = std::ldexp(1.0, static_cast<int>(maxLevel));
+    auto latticeIndex = [&](double value, const Bounds &bounds)
+    {
+        return static_cast<std::uint64_t>(std::llround((value - bounds[0]) / (bounds[1] - bounds[0]) * resolution));
+    };
+
+    std::unordered_map<LatticePoint, std::int32_t, LatticePointHash> pointIndices;
+    pointIndices.reserve(2 * numberOfCells);
+
+    std::vector<std::array<double, 2>> points;
+    points.reserve(2 * numberOfCells);
+
+    std::vector<std::int32_t> connectivity;
+    connectivity.reserve(4 * numberOfCells);
+
+    for (const auto &cell : cells)
+    {
+        double corners[4][2] = { { cell[0][0], cell[1][0] }, { cell[0][1], cell[1][0] },
+                                 { cell[0][1], cell[1][1] }, { cell[0][0], cell[1][1] } };
+
+        for (const auto &corner : corners)
+        {
+            LatticePoint key { latticeIndex(corner[0], domain[0]), latticeIndex(corner[1], domain[1]) };
+
+            auto inserted = pointIndices.emplace(key, static_cast<std::int32_t>(points.size()));
+            if (inserted.second)
+                points.push_back({ corner[0], corner[1] });
+
+            connectivity.push_back(inserted.first->second);
+        }
+    }
+
+    BigEndianWriter writer(outfile);
+
+    writer.writeText("# vtk DataFile Version 4.2\n");
+    writer.writeText("Adaptive Quadtree\n");
+    writer.writeText("BINARY\n");
+    writer.writeText("DATASET UNSTRUCTURED_GRID\n");
+
+    writer.writeText("POINTS " + std::to_string(points.size()) + " double\n");
+    for (const auto &point : points)
+    {
+        writer.writeDouble(point[0]);
+        writer.writeDouble(point[1]);
+        writer.writeDouble(0.0);
+    }
+
+    writer.writeText("\nCELLS " + std::to_string(numberOfCells) + " " + std::to_string(5 * numberOfCells) + "\n");
+    for (std::size_t i = 0; i < numberOfCells; ++i)
+    {
+        writer.writeInt32(4);
+        for (std::size_t j = 0; j < 4; ++j)
+            writer.writeInt32(connectivity[4 * i + j]);
+    }
+
+    writer.writeText("\nCELL_TYPES " + std::to_string(numberOfCells) + "\n");
+    for (std::size_t i = 0; i < numberOfCells; ++i)
+        writer.writeInt32(9); // VTK_QUAD
+
+    writer.writeText("\nCELL_DATA " + std::to_string(numberOfCells) + "\n");
+    writer.writeText("SCALARS depth int\nLOOKUP_TABLE default\n");
+    for (auto level : levels)
+        writer.writeInt32(static_cast<std::int32_t>(level));
+
+    writer.writeText("\n");
+}
+
+} // namespace implicit::detail
+
+namespace implicit
+{
+
+/**
+ * @brief Writes the header with a placeholder for the point count.
+ */
+VtkStreamWriter::VtkStreamWriter(const std::string &filename, VtkFormat format)
+        : file_(filename, std::ios::binary), levels_(std::tmpfile()), format_(format),
+          numberOfCells_(0)
+{
+    if (!file_.is_open() || !levels_)
+    {
+        if (levels_)
+            std::fclose(levels_);
+        throw std::runtime_error("VtkStreamWriter: cannot open output file " + filename);
+    }
+
+    file_ << "# vtk DataFile Version 4.2\n";
+    file_ << "Adaptive Quadtree\n";
+    file_ << (format_ == VtkFormat::Binary ? "BINARY\n" : "ASCII\n");
+    file_ << "DATASET UNSTRUCTURED_GRID\n";
+    file_ << "POINTS ";
+    pointCountOffset_ = file_.tellp();
+    file_ << std::setw(detail::countFieldWidth) << 0 << " double\n";
+}
+
+/**
+ * @brief Releases the temporary level file.
+ */
+VtkStreamWriter::~VtkStreamWriter()
+{
+    std::fclose(levels_);
+}
+
+/**
+ * @brief Writes four corner points per cell and spools one byte per level.
+ */
+void VtkStreamWriter::consume(const Cell2D *cells, const unsigned int *levels, std::size_t n)
+{
+    if (format_ == VtkFormat::Binary)
+    {
+        detail::BigEndianWriter writer(file_);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double x0 = cells[i][0][0], x1 = cells[i][0][1];
+            double y0 = cells[i][1][0], y1 = cells[i][1][1];
+            double corners[4][2] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+
+            for (const auto &corner : corners)
+            {
+                writer.writeDouble(corner[0]);
+                writer.writeDouble(corner[1]);
+                writer.writeDouble(0.0);
+            }
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double x0 = cells[i][0][0], x1 = cells[i][0][1];
+            double y0 = cells[i][1][0], y1 = cells[i][1][1];
+            file_ << x0 << " " << y0 << " 0\n";
+            file_ << x1 << " " << y0 << " 0\n";
+            file_ << x1 << " " << y1 << " 0\n";
+            file_ << x0 << " " << y1 << " 0\n";
+        }
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+        std::fputc(static_cast<int>(levels[i]), levels_);
+
+    numberOfCells_ += n;
+}
+
+/**
+ * @brief Appends the remaining sections and patches the point count in the header.
+ */
+void VtkStreamWriter::finish()
+{
+    std::size_t n = numberOfCells_;
+    bool binary = format_ == VtkFormat::Binary;
+
+    std::rewind(levels_);
+
+    if (binary)
+    {
+        detail::BigEndianWriter writer(file_);
+
+        writer.writeText("\nCELLS " + std::to_string(n) + " " + std::to_string(5 * n) + "\n");
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            writer.writeInt32(4);
+            for (std::size_t j = 0; j < 4; ++j)
+                writer.writeInt32(static_cast<std::int32_t>(4 * i + j));
+        }
+
+        writer.writeText("\nCELL_TYPES " + std::to_string(n) + "\n");
+        for (std::size_t i = 0; i < n; ++i)
+            writer.writeInt32(9); // VTK_QUAD
+
+        writer.writeText("\nCELL_DATA " + std::to_string(n) + "\n");
+        writer.writeText("SCALARS depth int\nLOOKUP_TABLE default\n");
+        for (std::size_t i = 0; i < n; ++i)
+            writer.writeInt32(std::fgetc(levels_));
+
+        writer.writeText("\n");
+    }
+    else
+    {
+        file_ << "CELLS " << n << " " << 5 * n << "\n";
+        for (std::size_t i = 0; i < n * 4; i += 4)
+            file_ << "4 " << i << " " << i + 1 << " " << i + 2 << " " << i + 3 << "\n";
+
+        file_ << "CELL_TYPES " << n << "\n";
+        for (std::size_t i = 0; i < n; ++i)
+            file_ << "9\n"; // VTK_QUAD
+
+        file_ << "CELL_DATA " << n << "\n";
+        file_ << "SCALARS depth double\nLOOKUP_TABLE default\n";
+        for (std::size_t i = 0; i < n; ++i)
+            file_ << std::fgetc(levels_) << "\n";
+    }
+
+    file_.seekp(pointCountOffset_);
+    file_ << std::setw(detail::countFieldWidth) << 4 * n;
+    file_.close();
+}
+
+} // namespace implicit
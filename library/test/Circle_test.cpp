@@ -55,4 +55,90 @@ TEST_CASE( "Circle_test" )
 
 
 
+TEST_CASE( "CircleBatch_test" )
+{
+    Circle circle( 3.0, -2.0, 0.6 );
+
+    double x[maxBatchSize], y[maxBatchSize];
+    for( std::size_t i = 0; i < maxBatchSize; ++i )
+    {
+        x[i] = 2.2 + 0.03 * i;
+        y[i] = -2.5 + 0.017 * i;
+    }
+
+    // Compare against the scalar test for all batch sizes (covers SIMD tails)
+    for( std::size_t n = 0; n <= maxBatchSize; ++n )
+    {
+        PointMask mask = circle.insideBatch( x, y, n );
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            CHECK( ( ( mask >> i ) & 1 ) == circle.inside( x[i], y[i] ) );
+        }
+        for( std::size_t i = n; i < maxBatchSize; ++i )
+        {
+            CHECK( ( ( mask >> i ) & 1 ) == 0 );
+        }
+    }
+}
+
+TEST_CASE( "CircleSingleBatch_test" )
+{
+    Circle circle( 3.0, -2.0, 0.6 );
+
+    float xf[maxBatchSize], yf[maxBatchSize];
+    double x[maxBatchSize], y[maxBatchSize];
+    for( std::size_t i = 0; i < maxBatchSize; ++i )
+    {
+        xf[i] = 2.2f + 0.03f * i;
+        yf[i] = -2.5f + 0.017f * i;
+        x[i] = xf[i];
+        y[i] = yf[i];
+    }
+
+    // Away from the boundary, single precision agrees with double precision for all batch sizes
+    for( std::size_t n = 0; n <= maxBatchSize; ++n )
+    {
+        CHECK( circle.insideBatch( xf, yf, n ) == circle.insideBatch( x, y, n ) );
+    }
+}
+
+
+
+TEST_CASE( "CircleClassify_test" )
+{
+    Circle circle( 3.0, -2.0, 0.6 );
+
+    CHECK( circle.classify( Cell2D { Bounds { 2.9, 3.1 }, Bounds { -2.1, -1.9 } } ) == CellClassification::Inside );
+    CHECK( circle.classify( Cell2D { Bounds { 0.0, 1.0 }, Bounds { 0.0, 1.0 } } ) == CellClassification::Outside );
+    CHECK( circle.classify( Cell2D { Bounds { 3.5, 4.0 }, Bounds { -2.1, -1.9 } } ) == CellClassification::Cut );
+
+    // Cell enclosing the whole circle, without any seed point inside
+    CHECK( circle.classify( Cell2D { Bounds { 0.0, 6.0 }, Bounds { -5.0, 1.0 } } ) == CellClassification::Cut );
+
+    // Cell touching the circle only in the corner region of its bounding box
+    CHECK( circle.classify( Cell2D { Bounds { 3.5, 4.0 }, Bounds { -1.5, -1.0 } } ) == CellClassification::Outside );
+}
+
+
+
+TEST_CASE( "CircleDistance_test" )
+{
+    Circle circle( 3.0, -2.0, 0.6 );
+
+    CHECK( circle.distance( 3.0, -2.0 ) == Approx( -0.6 ) );
+    CHECK( circle.distance( 3.6, -2.0 ) == Approx( 0.0 ).margin( 1e-12 ) );
+    CHECK( circle.distance( 3.0, 1.0 ) == Approx( 2.4 ) );
+    CHECK( circle.distance( 6.0, 2.0 ) == Approx( 4.4 ) );
+}
+
+TEST_CASE( "CircleBoundingBox_test" )
+{
+    Circle circle( 3.0, -2.0, 0.5 );
+
+    CHECK( circle.boundingBox( ) == Cell2D { Bounds { 2.5, 3.5 }, Bounds { -2.5, -1.5 } } );
+}
+
+
+
 } // implicit
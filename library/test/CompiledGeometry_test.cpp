@@ -0,0 +1,133 @@
+#include "catch.hpp"
+#include "CompiledGeometry.hpp"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+#include "NaryUnion.hpp"
+#include "NaryIntersection.hpp"
+#include "quadtree_helper.h"
+
+#include <algorithm>
+
+namespace implicit
+{
+
+class HalfPlaneMock : public AbsImplicitGeometry
+{
+    virtual bool inside( double x, double ) const
+    {
+        return x <= 0.3;
+    }
+};
+
+ImplicitGeometryPtr createTestGeometry( )
+{
+    auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+    auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+    auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+    auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+    auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+    auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+
+    return std::make_shared<Difference>( union1, circle2 );
+}
+
+void checkSameClassification( const AbsImplicitGeometry& reference, const CompiledGeometry& compiled )
+{
+    double x[maxBatchSize], y[maxBatchSize];
+
+    for( int i = 0; i < 40; ++i )
+    {
+        for( std::size_t j = 0; j < maxBatchSize; ++j )
+        {
+            x[j] = -1.6 + 3.2 * j / ( maxBatchSize - 1.0 );
+            y[j] = -1.6 + 3.2 * i / 39.0;
+
+            CHECK( compiled.inside( x[j], y[j] ) == reference.inside( x[j], y[j] ) );
+            CHECK( compiled.distance( x[j], y[j] ) == reference.distance( x[j], y[j] ) );
+        }
+
+        CHECK( compiled.insideBatch( x, y, maxBatchSize ) == reference.insideBatch( x, y, maxBatchSize ) );
+
+        // Both round the parameters to float in the same way
+        float xf[maxBatchSize], yf[maxBatchSize];
+        std::copy( x, x + maxBatchSize, xf );
+        std::copy( y, y + maxBatchSize, yf );
+
+        CHECK( compiled.insideBatch( xf, yf, maxBatchSize ) == reference.insideBatch( xf, yf, maxBatchSize ) );
+
+        for( std::size_t j = 0; j + 1 < maxBatchSize; j += 7 )
+        {
+            Cell2D cell { Bounds { x[j], x[j + 1] }, Bounds { y[j], y[j] + 0.3 } };
+
+            CHECK( compiled.classify( cell ) == reference.classify( cell ) );
+        }
+    }
+}
+
+TEST_CASE( "CompiledGeometry_test" )
+{
+    auto geometry = createTestGeometry( );
+
+    CompiledGeometry compiled( geometry );
+
+    CHECK( compiled.instructions( ).size( ) == 7 );
+    CHECK( compiled.parameters( ).size( ) == 14 );
+    CHECK( compiled.stackDepth( ) == 2 );
+
+    checkSameClassification( *geometry, compiled );
+
+    Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+    detail::QuadTreeNode rootNode( boundingBox, 0 );
+
+    rootNode.partition( compiled, 6 );
+
+    CHECK( rootNode.getLeafCells( ).first.size( ) == 856 );
+}
+
+TEST_CASE( "CompiledGeometryDeepTree_test" )
+{
+    // Right-deep chain of differences: operands are emitted in reversed order
+    ImplicitGeometryPtr geometry = std::make_shared<Circle>( 0.0, 0.0, 0.2 );
+
+    for( int i = 0; i < 200; ++i )
+    {
+        auto ring = std::make_shared<Difference>( std::make_shared<Circle>( 0.0, 0.0, 0.3 + 0.005 * i ), geometry );
+        geometry = std::make_shared<Difference>( std::make_shared<Rectangle>( -1.5, -1.5, 1.5, 1.5 ), ring );
+    }
+
+    geometry = std::make_shared<Union>( geometry, std::make_shared<HalfPlaneMock>( ) );
+
+    CompiledGeometry compiled( geometry );
+
+    CHECK( compiled.stackDepth( ) <= 3 );
+
+    checkSameClassification( *geometry, compiled );
+}
+
+TEST_CASE( "CompiledGeometryNary_test" )
+{
+    std::vector<ImplicitGeometryPtr> circles;
+    for( int i = 0; i < 100; ++i )
+    {
+        circles.push_back( std::make_shared<Circle>( -1.5 + 0.03 * i, 0.02 * ( i % 7 ), 0.1 ) );
+    }
+
+    auto bar = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+    auto circlesAndBar = std::make_shared<NaryUnion>( circles );
+    ImplicitGeometryPtr geometry = std::make_shared<NaryIntersection>(
+        std::vector<ImplicitGeometryPtr> { std::make_shared<HalfPlaneMock>( ),
+                                           std::make_shared<Union>( circlesAndBar, bar ),
+                                           std::make_shared<Circle>( 0.0, 0.0, 1.2 ) } );
+
+    CompiledGeometry compiled( geometry );
+
+    CHECK( compiled.stackDepth( ) <= 3 );
+
+    checkSameClassification( *geometry, compiled );
+}
+
+} // implicit
@@ -0,0 +1,74 @@
+#include "catch.hpp"
+#include "CsgExpression.hpp"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+#include "quadtree_helper.h"
+
+namespace implicit
+{
+
+TEST_CASE( "CsgExpression_test" )
+{
+    // ((Circle AND Square) OR Bar) MINUS Inner Circle
+    auto expression = csg::makeDifference(
+        csg::makeUnion( csg::makeIntersection( csg::Circle { 0.0, 0.0, 1.06 },
+                                               csg::Rectangle { -1.0, -1.0, 1.0, 1.0 } ),
+                        csg::Rectangle { -0.1, -1.5, 0.1, 1.5 } ),
+        csg::Circle { 0.0, 0.0, 0.65 } );
+
+    auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+    auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+    auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+    auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+    auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+    auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+    Difference geometry( union1, circle2 );
+
+    for( int i = 0; i <= 50; ++i )
+    {
+        for( int j = 0; j <= 50; ++j )
+        {
+            double x = -1.6 + 3.2 * i / 50.0;
+            double y = -1.6 + 3.2 * j / 50.0;
+
+            CHECK( expression.inside( x, y ) == geometry.inside( x, y ) );
+        }
+    }
+
+    Cell2D cutCell { Bounds { -1.2, -0.9 }, Bounds { -0.1, 0.1 } };
+    CHECK( detail::isCutByBoundary( cutCell, expression, 7 ) == detail::isCutByBoundary( cutCell, geometry, 7 ) );
+
+    Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+    detail::QuadTreeNode rootNode( boundingBox, 0 );
+    rootNode.partition( expression, 6 );
+
+    CHECK( rootNode.getLeafCells( ).first.size( ) == 856 );
+
+    // The seed options apply to static geometries as well
+    PartitionOptions options;
+    options.earlyExit = false;
+    options.seedPointsPerLevel = { 3, 3, 5 };
+
+    detail::QuadTreeNode staticNode( boundingBox, 0 );
+    staticNode.partition( expression, 6, options );
+
+    detail::QuadTreeNode dynamicNode( boundingBox, 0 );
+    dynamicNode.partition( geometry, 6, options );
+
+    CHECK( staticNode.getLeafCells( ) == dynamicNode.getLeafCells( ) );
+    CHECK( detail::isCutByBoundary( cutCell, expression, 7, true ) == detail::isCutByBoundary( cutCell, geometry, 7, true ) );
+
+    // The adapter exposes the same expression through the virtual interface
+    csg::Geometry<decltype( expression )> adapter( expression );
+
+    detail::QuadTreeNode adapterNode( boundingBox, 0 );
+    adapterNode.partition( adapter, 6 );
+
+    CHECK( adapterNode.getLeafCells( ).first.size( ) == 856 );
+}
+
+} // implicit
@@ -2,7 +2,16 @@
 #include "Union.hpp"
 #include "Difference.hpp"
 #include "Intersection.hpp"
+#include "NaryUnion.hpp"
+#include "NaryIntersection.hpp"
+#include "IndexedUnion.hpp"
+#include "CompiledGeometry.hpp"
+#include "csg_optimizer.h"
 #include "Circle.hpp"
+#include "Rectangle.hpp"
+
+#include <algorithm>
+#include <random>
 
 namespace implicit
 {
@@ -62,4 +71,233 @@ TEST_CASE( "Intersection_test" )
 }
 
 
+TEST_CASE( "OperationBatch_test" )
+{
+    ImplicitGeometryPtr circle1( new Circle( 0.0, 0.0, 1.0 ) );
+    ImplicitGeometryPtr circle2( new Circle( 1.0, 0.0, 1.0 ) );
+
+    Union u( circle1, circle2 );
+    Difference difference( circle1, circle2 );
+    Intersection intersection( circle1, circle2 );
+
+    double x[] = { 0.5, 0.5, -1.5, -0.2, 0.2, 0.8, 1.2, 2.5 };
+    double y[] = { 1.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+    CHECK( u.insideBatch( x, y, 8 ) == 0b01111000 );
+    CHECK( difference.insideBatch( x, y, 8 ) == 0b00001000 );
+    CHECK( intersection.insideBatch( x, y, 8 ) == 0b00110000 );
+
+    // Short-circuit paths: all points inside / outside the first operand
+    CHECK( u.insideBatch( x + 3, y + 3, 2 ) == 0b11 );
+    CHECK( intersection.insideBatch( x, y, 3 ) == 0 );
+    CHECK( difference.insideBatch( x + 7, y + 7, 1 ) == 0 );
+}
+
+
+TEST_CASE( "OperationClassify_test" )
+{
+    ImplicitGeometryPtr circle1( new Circle( 0.0, 0.0, 1.0 ) );
+    ImplicitGeometryPtr circle2( new Circle( 1.0, 0.0, 1.0 ) );
+
+    Union u( circle1, circle2 );
+    Difference difference( circle1, circle2 );
+    Intersection intersection( circle1, circle2 );
+
+    Cell2D left { Bounds { -0.6, -0.4 }, Bounds { -0.1, 0.1 } };
+    Cell2D middle { Bounds { 0.4, 0.6 }, Bounds { -0.1, 0.1 } };
+    Cell2D outside { Bounds { 2.5, 3.0 }, Bounds { -0.1, 0.1 } };
+    Cell2D cut { Bounds { -1.1, -0.9 }, Bounds { -0.1, 0.1 } };
+
+    CHECK( u.classify( left ) == CellClassification::Inside );
+    CHECK( u.classify( middle ) == CellClassification::Inside );
+    CHECK( u.classify( outside ) == CellClassification::Outside );
+    CHECK( u.classify( cut ) == CellClassification::Cut );
+
+    CHECK( difference.classify( left ) == CellClassification::Inside );
+    CHECK( difference.classify( middle ) == CellClassification::Outside );
+    CHECK( difference.classify( outside ) == CellClassification::Outside );
+    CHECK( difference.classify( cut ) == CellClassification::Cut );
+
+    CHECK( intersection.classify( left ) == CellClassification::Outside );
+    CHECK( intersection.classify( middle ) == CellClassification::Inside );
+    CHECK( intersection.classify( outside ) == CellClassification::Outside );
+    CHECK( intersection.classify( cut ) == CellClassification::Outside );
+}
+
+
+TEST_CASE( "OperationDistance_test" )
+{
+    ImplicitGeometryPtr circle1( new Circle( 0.0, 0.0, 1.0 ) );
+    ImplicitGeometryPtr circle2( new Circle( 1.0, 0.0, 1.0 ) );
+
+    Union u( circle1, circle2 );
+    Difference difference( circle1, circle2 );
+    Intersection intersection( circle1, circle2 );
+
+    CHECK( u.distance( -1.5, 0.0 ) == Approx( 0.5 ) );
+    CHECK( u.distance( 2.5, 0.0 ) == Approx( 0.5 ) );
+    CHECK( u.distance( 0.0, 0.0 ) == Approx( -1.0 ) );
+
+    CHECK( intersection.distance( 0.5, 0.0 ) == Approx( -0.5 ) );
+    CHECK( intersection.distance( -1.5, 0.0 ) == Approx( 1.5 ) );
+
+    CHECK( difference.distance( -0.5, 0.0 ) == Approx( -0.5 ) );
+    CHECK( difference.distance( 0.5, 0.0 ) == Approx( 0.5 ) );
+
+    // The sign always matches the inside test
+    for( int i = 0; i <= 40; ++i )
+    {
+        double x = -1.5 + 4.0 * i / 40.0;
+
+        CHECK( ( u.distance( x, 0.3 ) <= 0.0 ) == u.inside( x, 0.3 ) );
+        CHECK( ( difference.distance( x, 0.3 ) < 0.0 ) == difference.inside( x, 0.3 ) );
+    }
+}
+
+
+TEST_CASE( "OperationBoundingBox_test" )
+{
+    ImplicitGeometryPtr circle1( new Circle( 0.0, 0.0, 1.0 ) );
+    ImplicitGeometryPtr circle2( new Circle( 1.5, 0.0, 1.0 ) );
+    ImplicitGeometryPtr farCircle( new Circle( 5.0, 5.0, 1.0 ) );
+
+    Union u( circle1, circle2 );
+    Difference difference( circle1, circle2 );
+    Intersection intersection( circle1, circle2 );
+
+    CHECK( u.boundingBox( ) == Cell2D { Bounds { -1.0, 2.5 }, Bounds { -1.0, 1.0 } } );
+    CHECK( difference.boundingBox( ) == circle1->boundingBox( ) );
+    CHECK( intersection.boundingBox( ) == Cell2D { Bounds { 0.5, 1.0 }, Bounds { -1.0, 1.0 } } );
+
+    // Disjoint operands have an empty intersection, which does not enlarge a union
+    auto empty = std::make_shared<Intersection>( circle1, farCircle );
+    Union unionWithEmpty( empty, circle2 );
+
+    CHECK( unionWithEmpty.boundingBox( ) == circle2->boundingBox( ) );
+}
+
+
+TEST_CASE( "NaryOperation_test" )
+{
+    ImplicitGeometryPtr circle1( new Circle( 0.0, 0.0, 1.0 ) );
+    ImplicitGeometryPtr circle2( new Circle( 1.0, 0.0, 1.0 ) );
+    ImplicitGeometryPtr circle3( new Circle( 0.5, 0.5, 1.0 ) );
+
+    NaryUnion naryUnion( { circle1, circle2, circle3 } );
+    NaryIntersection naryIntersection( { circle1, circle2, circle3 } );
+
+    Union binaryUnion( std::make_shared<Union>( circle1, circle2 ), circle3 );
+    Intersection binaryIntersection( std::make_shared<Intersection>( circle1, circle2 ), circle3 );
+
+    double x[64], y[64];
+    for( int i = 0; i < 64; ++i )
+    {
+        x[i] = -1.5 + 3.5 * ( i % 8 ) / 7.0;
+        y[i] = -1.5 + 3.5 * ( i / 8 ) / 7.0;
+
+        CHECK( naryUnion.inside( x[i], y[i] ) == binaryUnion.inside( x[i], y[i] ) );
+        CHECK( naryIntersection.inside( x[i], y[i] ) == binaryIntersection.inside( x[i], y[i] ) );
+        CHECK( naryUnion.distance( x[i], y[i] ) == binaryUnion.distance( x[i], y[i] ) );
+        CHECK( naryIntersection.distance( x[i], y[i] ) == binaryIntersection.distance( x[i], y[i] ) );
+    }
+
+    CHECK( naryUnion.insideBatch( x, y, 64 ) == binaryUnion.insideBatch( x, y, 64 ) );
+    CHECK( naryIntersection.insideBatch( x, y, 64 ) == binaryIntersection.insideBatch( x, y, 64 ) );
+
+    Cell2D middle { Bounds { 0.4, 0.6 }, Bounds { -0.1, 0.1 } };
+    Cell2D outside { Bounds { 2.5, 3.0 }, Bounds { -0.1, 0.1 } };
+    Cell2D cut { Bounds { -1.1, -0.9 }, Bounds { -0.1, 0.1 } };
+
+    for( const auto& cell : { middle, outside, cut } )
+    {
+        CHECK( naryUnion.classify( cell ) == binaryUnion.classify( cell ) );
+        CHECK( naryIntersection.classify( cell ) == binaryIntersection.classify( cell ) );
+    }
+
+    CHECK( naryUnion.boundingBox( ) == binaryUnion.boundingBox( ) );
+    CHECK( naryIntersection.boundingBox( ) == binaryIntersection.boundingBox( ) );
+
+    CHECK( naryUnion.operands( ).size( ) == 3 );
+    CHECK_THROWS_AS( NaryUnion( { } ), std::invalid_argument );
+    CHECK_THROWS_AS( NaryIntersection( { circle1, nullptr } ), std::invalid_argument );
+}
+
+TEST_CASE( "IndexedUnion_test" )
+{
+    std::mt19937 generator( 42 );
+    std::uniform_real_distribution<double> position( -1.0, 1.0 );
+    std::uniform_real_distribution<double> radius( 0.005, 0.05 );
+
+    std::vector<ImplicitGeometryPtr> operands;
+    for( int i = 0; i < 2000; ++i )
+    {
+        operands.push_back( std::make_shared<Circle>( position( generator ), position( generator ), radius( generator ) ) );
+    }
+
+    // A large operand that is visited by every query
+    operands.push_back( std::make_shared<Rectangle>( -1.2, -1.2, 1.2, -0.9 ) );
+
+    NaryUnion reference( operands );
+    IndexedUnion indexed( operands );
+
+    CHECK( indexed.gridSize( )[0] * indexed.gridSize( )[1] > 1000 );
+    REQUIRE( indexed.unindexedOperands( ).size( ) == 1 );
+    CHECK( indexed.unindexedOperands( )[0] == 2000 );
+    CHECK( indexed.boundingBox( ) == reference.boundingBox( ) );
+
+    double x[64], y[64];
+    for( int i = 0; i < 200; ++i )
+    {
+        for( int j = 0; j < 64; ++j )
+        {
+            x[j] = 1.3 * position( generator );
+            y[j] = 1.3 * position( generator );
+
+            CHECK( indexed.inside( x[j], y[j] ) == reference.inside( x[j], y[j] ) );
+            CHECK( indexed.distance( x[j], y[j] ) == Approx( reference.distance( x[j], y[j] ) ).margin( 1e-12 ) );
+        }
+
+        CHECK( indexed.insideBatch( x, y, 64 ) == reference.insideBatch( x, y, 64 ) );
+
+        // Spread batches are looked up point by point, also in single precision
+        float xf[64], yf[64];
+        std::copy( x, x + 64, xf );
+        std::copy( y, y + 64, yf );
+
+        CHECK( indexed.insideBatch( xf, yf, 64 ) == reference.insideBatch( xf, yf, 64 ) );
+
+        // Batch confined to a small region, as for the seed points of a fine cell
+        double x0 = position( generator ), y0 = position( generator );
+        for( int j = 0; j < 64; ++j )
+        {
+            x[j] = x0 + 0.01 * ( j % 8 );
+            y[j] = y0 + 0.01 * ( j / 8 );
+        }
+
+        CHECK( indexed.insideBatch( x, y, 64 ) == reference.insideBatch( x, y, 64 ) );
+
+        double size = 0.2 * std::abs( position( generator ) );
+        Cell2D cell { Bounds { x0, x0 + size }, Bounds { y0, y0 + size } };
+        CHECK( indexed.classify( cell ) == reference.classify( cell ) );
+    }
+
+    // Kept as one node by the compiler and the optimizer
+    auto shared = std::make_shared<IndexedUnion>( operands );
+    CompiledGeometry compiled( shared );
+    CHECK( compiled.stackDepth( ) == 1 );
+    CHECK( optimizeGeometry( shared ) == shared );
+
+    for( int j = 0; j < 64; ++j )
+    {
+        CHECK( compiled.inside( x[j], y[j] ) == reference.inside( x[j], y[j] ) );
+    }
+
+    // Operands in a line give a grid with a single row
+    IndexedUnion line( { std::make_shared<Rectangle>( 0.0, 0.0, 1.0, 0.0 ), std::make_shared<Rectangle>( 2.0, 0.0, 3.0, 0.0 ) } );
+    CHECK( line.gridSize( )[1] == 1 );
+    CHECK( line.inside( 2.5, 0.0 ) );
+    CHECK( !line.inside( 1.5, 0.0 ) );
+    CHECK( line.distance( 1.5, 0.0 ) == Approx( 0.5 ) );
+}
+
 } // implicit
@@ -45,4 +45,51 @@ TEST_CASE( "Rectangle_test" )
     CHECK( !rectangle.inside( 1.2 + eps, 5.0 ) );    
 }
 
+TEST_CASE( "RectangleBatch_test" )
+{
+    Rectangle rectangle( -6.5, 5.0, 1.2, 7.5 );
+
+    double eps = 1e-8;
+
+    double x[] = { 0.0, 0.0, -6.5 - eps, -6.5 + eps, -2.65, -2.65, 1.2 - eps, 1.2 + eps, -6.5, 1.2 };
+    double y[] = { 7.0, 0.0, 6.5, 6.5, 7.5 + eps, 5.0 + eps, 5.0 - eps, 5.0, 5.0, 7.5 };
+
+    PointMask mask = rectangle.insideBatch( x, y, 10 );
+
+    for( std::size_t i = 0; i < 10; ++i )
+    {
+        CHECK( ( ( mask >> i ) & 1 ) == rectangle.inside( x[i], y[i] ) );
+    }
+}
+
+TEST_CASE( "RectangleClassify_test" )
+{
+    Rectangle rectangle( -6.5, 5.0, 1.2, 7.5 );
+
+    CHECK( rectangle.classify( Cell2D { Bounds { -6.5, 1.2 }, Bounds { 5.0, 7.5 } } ) == CellClassification::Inside );
+    CHECK( rectangle.classify( Cell2D { Bounds { 1.3, 2.0 }, Bounds { 5.0, 7.5 } } ) == CellClassification::Outside );
+    CHECK( rectangle.classify( Cell2D { Bounds { -7.0, -6.0 }, Bounds { 6.0, 6.5 } } ) == CellClassification::Cut );
+
+    // Cell enclosing the rectangle
+    CHECK( rectangle.classify( Cell2D { Bounds { -10.0, 10.0 }, Bounds { 0.0, 10.0 } } ) == CellClassification::Cut );
+}
+
+TEST_CASE( "RectangleDistance_test" )
+{
+    Rectangle rectangle( -6.5, 5.0, 1.2, 7.5 );
+
+    CHECK( rectangle.distance( 0.0, 7.0 ) == Approx( -0.5 ) );
+    CHECK( rectangle.distance( -6.0, 6.0 ) == Approx( -0.5 ) );
+    CHECK( rectangle.distance( 0.0, 0.0 ) == Approx( 5.0 ) );
+    CHECK( rectangle.distance( 4.2, 11.5 ) == Approx( 5.0 ) );
+    CHECK( rectangle.distance( 1.2, 6.0 ) == Approx( 0.0 ).margin( 1e-12 ) );
+}
+
+TEST_CASE( "RectangleBoundingBox_test" )
+{
+    Rectangle rectangle( -6.5, 5.0, 1.2, 7.5 );
+
+    CHECK( rectangle.boundingBox( ) == Cell2D { Bounds { -6.5, 1.2 }, Bounds { 5.0, 7.5 } } );
+}
+
 } // implicit
@@ -0,0 +1,195 @@
+#include "catch.hpp"
+#include "csg_optimizer.h"
+#include "CompiledGeometry.hpp"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+#include "NaryUnion.hpp"
+#include "NaryIntersection.hpp"
+
+#include <vector>
+
+namespace implicit
+{
+    namespace
+    {
+        void checkSameInside( const AbsImplicitGeometry& reference, const AbsImplicitGeometry& optimized )
+        {
+            double x[maxBatchSize], y[maxBatchSize];
+
+            for( int i = 0; i < 32; ++i )
+            {
+                for( std::size_t j = 0; j < maxBatchSize; ++j )
+                {
+                    x[j] = -1.6 + 3.2 * j / ( maxBatchSize - 1.0 );
+                    y[j] = -1.6 + 3.2 * i / 31.0;
+
+                    CHECK( optimized.inside( x[j], y[j] ) == reference.inside( x[j], y[j] ) );
+                }
+
+                CHECK( optimized.insideBatch( x, y, maxBatchSize ) == reference.insideBatch( x, y, maxBatchSize ) );
+            }
+        }
+    }
+
+    TEST_CASE( "optimizeFlatten_test" )
+    {
+        // Left-deep chain of 1000 unions
+        ImplicitGeometryPtr chain = std::make_shared<Circle>( -1.5, 0.0, 0.05 );
+        for( int i = 1; i < 1000; ++i )
+        {
+            auto circle = std::make_shared<Circle>( -1.5 + 0.003 * i, 0.5 * ( i % 5 ) - 1.0, 0.05 );
+            chain = std::make_shared<Union>( chain, circle );
+        }
+
+        auto optimized = optimizeGeometry( chain );
+
+        auto naryUnion = std::dynamic_pointer_cast<NaryUnion>( optimized );
+        REQUIRE( naryUnion != nullptr );
+        CHECK( naryUnion->operands( ).size( ) == 1000 );
+        CHECK( optimized->boundingBox( ) == chain->boundingBox( ) );
+
+        checkSameInside( *chain, *optimized );
+
+        // The flat node needs a single stack slot per operand
+        CompiledGeometry compiled( optimized );
+        CHECK( compiled.stackDepth( ) == 2 );
+        checkSameInside( *chain, compiled );
+    }
+
+    TEST_CASE( "optimizeDeduplicate_test" )
+    {
+        auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.0 );
+        auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 1.0 );
+        auto bar = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+
+        // Identical primitives and commuted operands are recognized
+        auto union1 = std::make_shared<Union>( circle1, bar );
+        auto union2 = std::make_shared<Union>( bar, circle2 );
+        auto hole = std::make_shared<Circle>( 0.3, 0.0, 0.2 );
+        ImplicitGeometryPtr geometry = std::make_shared<Intersection>(
+            std::make_shared<Difference>( union1, hole ), std::make_shared<Difference>( union2, hole ) );
+
+        auto optimized = optimizeGeometry( geometry );
+
+        auto difference = std::dynamic_pointer_cast<Difference>( optimized );
+        REQUIRE( difference != nullptr );
+        CHECK( std::dynamic_pointer_cast<NaryUnion>( difference->operand1( ) )->operands( ).size( ) == 2 );
+
+        checkSameInside( *geometry, *optimized );
+
+        OptimizerOptions options;
+        options.deduplicate = false;
+
+        auto duplicated = optimizeGeometry( geometry, options );
+        CHECK( std::dynamic_pointer_cast<NaryIntersection>( duplicated ) != nullptr );
+        checkSameInside( *geometry, *duplicated );
+
+        // Shared input subtrees stay shared
+        auto shared = std::make_shared<Difference>( union1, hole );
+        ImplicitGeometryPtr twice = std::make_shared<Union>(
+            std::make_shared<Intersection>( shared, std::make_shared<Rectangle>( -2.0, -2.0, 0.0, 2.0 ) ),
+            std::make_shared<Intersection>( shared, std::make_shared<Rectangle>( 0.0, -2.0, 2.0, 2.0 ) ) );
+
+        auto optimizedTwice = std::dynamic_pointer_cast<NaryUnion>( optimizeGeometry( twice ) );
+        REQUIRE( optimizedTwice != nullptr );
+
+        auto half1 = std::dynamic_pointer_cast<NaryIntersection>( optimizedTwice->operands( )[0] );
+        auto half2 = std::dynamic_pointer_cast<NaryIntersection>( optimizedTwice->operands( )[1] );
+        REQUIRE( half1 != nullptr );
+        REQUIRE( half2 != nullptr );
+
+        auto subtree1 = std::find_if( half1->operands( ).begin( ), half1->operands( ).end( ),
+                                      []( const ImplicitGeometryPtr& operand ) { return std::dynamic_pointer_cast<Difference>( operand ) != nullptr; } );
+        auto subtree2 = std::find_if( half2->operands( ).begin( ), half2->operands( ).end( ),
+                                      []( const ImplicitGeometryPtr& operand ) { return std::dynamic_pointer_cast<Difference>( operand ) != nullptr; } );
+        REQUIRE( subtree1 != half1->operands( ).end( ) );
+        REQUIRE( subtree2 != half2->operands( ).end( ) );
+        CHECK( *subtree1 == *subtree2 );
+    }
+
+    TEST_CASE( "optimizeDifferenceChain_test" )
+    {
+        ImplicitGeometryPtr geometry = std::make_shared<Rectangle>( -1.5, -1.5, 1.5, 1.5 );
+        for( int i = 0; i < 50; ++i )
+        {
+            geometry = std::make_shared<Difference>( geometry, std::make_shared<Circle>( -1.2 + 0.05 * i, 0.0, 0.02 ) );
+        }
+
+        auto optimized = optimizeGeometry( geometry );
+
+        // (a \\ b) \\ c becomes a \\ (b ∪ c)
+        auto difference = std::dynamic_pointer_cast<Difference>( optimized );
+        REQUIRE( difference != nullptr );
+        CHECK( std::dynamic_pointer_cast<Rectangle>( difference->operand1( ) ) != nullptr );
+
+        auto holes = std::dynamic_pointer_cast<NaryUnion>( difference->operand2( ) );
+        REQUIRE( holes != nullptr );
+        CHECK( holes->operands( ).size( ) == 50 );
+
+        checkSameInside( *geometry, *optimized );
+    }
+
+    TEST_CASE( "optimizeLongChains_test" )
+    {
+        // Generated chains must be optimized in (near) linear time and without deep recursion.
+        // The chains stay short enough for their recursive destruction under sanitizers.
+        ImplicitGeometryPtr differences = std::make_shared<Rectangle>( -1.5, -1.5, 1.5, 1.5 );
+        ImplicitGeometryPtr unions = std::make_shared<Circle>( -1.5, 0.0, 0.01 );
+        for( int i = 0; i < 3000; ++i )
+        {
+            auto circle = std::make_shared<Circle>( -1.5 + 1e-3 * i, 0.1, 0.01 );
+            differences = std::make_shared<Difference>( differences, circle );
+            unions = std::make_shared<Union>( unions, circle );
+        }
+
+        auto optimizedDifferences = std::dynamic_pointer_cast<Difference>( optimizeGeometry( differences ) );
+        REQUIRE( optimizedDifferences != nullptr );
+
+        auto holes = std::dynamic_pointer_cast<NaryUnion>( optimizedDifferences->operand2( ) );
+        REQUIRE( holes != nullptr );
+        CHECK( holes->operands( ).size( ) == 3000 );
+
+        auto optimizedUnions = std::dynamic_pointer_cast<NaryUnion>( optimizeGeometry( unions ) );
+        REQUIRE( optimizedUnions != nullptr );
+        CHECK( optimizedUnions->operands( ).size( ) == 3001 );
+    }
+
+    TEST_CASE( "optimizeReorder_test" )
+    {
+        auto small = std::make_shared<Rectangle>( 0.0, 0.0, 0.1, 0.1 );
+        auto large = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto medium = std::make_shared<Circle>( 0.0, 0.0, 0.5 );
+
+        // Intersections test the operand most likely to exclude a point first
+        ImplicitGeometryPtr intersection = std::make_shared<Intersection>( std::make_shared<Intersection>( large, medium ), small );
+        auto optimizedIntersection = std::dynamic_pointer_cast<NaryIntersection>( optimizeGeometry( intersection ) );
+        REQUIRE( optimizedIntersection != nullptr );
+        CHECK( optimizedIntersection->operands( ) == std::vector<ImplicitGeometryPtr> { small, medium, large } );
+
+        // Unions test the operand most likely to contain a point first
+        ImplicitGeometryPtr union1 = std::make_shared<Union>( std::make_shared<Union>( small, medium ), large );
+        auto optimizedUnion = std::dynamic_pointer_cast<NaryUnion>( optimizeGeometry( union1 ) );
+        REQUIRE( optimizedUnion != nullptr );
+        CHECK( optimizedUnion->operands( ).front( ) == large );
+
+        // Cheap operands go first among operands of equal extent
+        auto expensive = std::make_shared<Difference>( std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 ),
+                                                       std::make_shared<Circle>( 5.0, 5.0, 0.1 ) );
+        ImplicitGeometryPtr mixed = std::make_shared<Union>( expensive, large );
+
+        OptimizerOptions options;
+        options.deduplicate = false;
+
+        auto optimizedMixed = std::dynamic_pointer_cast<NaryUnion>( optimizeGeometry( mixed, options ) );
+        REQUIRE( optimizedMixed != nullptr );
+        CHECK( optimizedMixed->operands( ).front( ) == large );
+
+        options.reorder = false;
+        auto unordered = std::dynamic_pointer_cast<NaryIntersection>( optimizeGeometry( intersection, options ) );
+        REQUIRE( unordered != nullptr );
+        CHECK( unordered->operands( ) == std::vector<ImplicitGeometryPtr> { large, medium, small } );
+    }
+} // namespace implicit
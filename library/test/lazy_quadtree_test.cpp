@@ -0,0 +1,110 @@
+#include "catch.hpp"
+#include "lazy_quadtree.h"
+#include "bounding_box_helper.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+
+namespace implicit
+{
+    namespace
+    {
+        std::shared_ptr<AbsImplicitGeometry> createLazyTestGeometry( )
+        {
+            auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+            auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+            auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+            auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+            auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+            auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+            return std::make_shared<Difference>( union1, circle2 );
+        }
+
+        detail::CellsAndLevels overlappingLeaves( const detail::CellsAndLevels& leaves, const Cell2D& window )
+        {
+            detail::CellsAndLevels result;
+            for( std::size_t i = 0; i < leaves.first.size( ); ++i )
+            {
+                if( detail::boxesOverlap( leaves.first[i], window ) )
+                {
+                    result.first.push_back( leaves.first[i] );
+                    result.second.push_back( leaves.second[i] );
+                }
+            }
+            return result;
+        }
+    }
+
+    TEST_CASE( "LazyQuadTree_test" )
+    {
+        auto geometry = createLazyTestGeometry( );
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::QuadTreeNode rootNode( boundingBox, 0 );
+        rootNode.partition( *geometry, 8 );
+        auto eagerLeaves = rootNode.getLeafCells( );
+
+        detail::LazyQuadTree tree( *geometry, boundingBox, 8 );
+        CHECK( tree.numberOfNodes( ) == 1 );
+        CHECK( tree.numberOfEvaluations( ) == 0 );
+
+        Cell2D window { Bounds { 0.5, 0.7 }, Bounds { -0.2, 0.1 } };
+        auto windowLeaves = tree.query( window );
+
+        CHECK( windowLeaves == overlappingLeaves( eagerLeaves, window ) );
+        CHECK( tree.numberOfEvaluations( ) < eagerLeaves.first.size( ) / 4 );
+
+        // Cached subtrees are not evaluated again
+        std::size_t evaluations = tree.numberOfEvaluations( );
+        CHECK( tree.query( window ) == windowLeaves );
+        CHECK( tree.numberOfEvaluations( ) == evaluations );
+
+        CHECK( tree.query( boundingBox ) == eagerLeaves );
+
+        Cell2D cell;
+        unsigned int level;
+        REQUIRE( tree.locate( 0.3, -0.9, cell, level ) );
+
+        const auto *leaf = rootNode.findLeaf( 0.3, -0.9 );
+        CHECK( cell == leaf->cell( ) );
+        CHECK( level == static_cast<unsigned int>( leaf->level( ) ) );
+        CHECK_FALSE( tree.locate( 2.0, 0.0, cell, level ) );
+    }
+
+    TEST_CASE( "LazyQuadTreeEviction_test" )
+    {
+        auto geometry = createLazyTestGeometry( );
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        Cell2D windows[] = { Cell2D { Bounds { 0.5, 0.9 }, Bounds { -0.2, 0.2 } },
+                             Cell2D { Bounds { -0.9, -0.5 }, Bounds { -0.2, 0.2 } },
+                             Cell2D { Bounds { -0.2, 0.2 }, Bounds { 0.5, 0.9 } },
+                             Cell2D { Bounds { -0.2, 0.2 }, Bounds { -0.9, -0.5 } } };
+
+        detail::LazyQuadTree unlimited( *geometry, boundingBox, 9 );
+        unlimited.query( windows[0] );
+        std::size_t budget = 2 * unlimited.memoryUsage( );
+
+        detail::LazyQuadTree tree( *geometry, boundingBox, 9, { }, budget );
+        auto firstLeaves = tree.query( windows[0] );
+
+        for( const auto& window : windows )
+        {
+            auto leaves = tree.query( window );
+            CHECK( tree.memoryUsage( ) <= budget );
+            CHECK( !leaves.first.empty( ) );
+        }
+
+        // Evicted subtrees are rebuilt identically
+        CHECK( tree.query( windows[0] ) == firstLeaves );
+
+        for( const auto& window : windows )
+        {
+            tree.query( window );
+            unlimited.query( window );
+        }
+        CHECK( tree.memoryUsage( ) < unlimited.memoryUsage( ) );
+    }
+} // namespace implicit
@@ -0,0 +1,142 @@
+#include "catch.hpp"
+#include "leaf_sink.h"
+#include "quadtree_helper.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace implicit
+{
+    namespace
+    {
+        std::shared_ptr<AbsImplicitGeometry> createStreamTestGeometry( )
+        {
+            auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+            auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+            auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+            auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+            auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+            auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+            return std::make_shared<Difference>( union1, circle2 );
+        }
+
+        std::vector<std::string> readTokens( const std::string& filename )
+        {
+            std::ifstream file( filename );
+            return { std::istream_iterator<std::string>( file ), std::istream_iterator<std::string>( ) };
+        }
+    }
+
+    TEST_CASE( "streamQuadTree_test" )
+    {
+        auto geometry = createStreamTestGeometry( );
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::QuadTreeNode rootNode( boundingBox, 0 );
+        rootNode.partition( *geometry, 6 );
+        auto expected = rootNode.getLeafCells( );
+
+        LeafBuffer buffer;
+        streamQuadTree( *geometry, boundingBox, 6, buffer );
+
+        CHECK( buffer.cells( ).size( ) == 856 );
+        CHECK( buffer.cells( ) == expected.first );
+        CHECK( buffer.levels( ) == expected.second );
+
+        // Streaming ignores the seed point cache
+        PartitionOptions options;
+        options.cacheSeedPoints = true;
+
+        LeafBuffer cachedBuffer;
+        streamQuadTree( *geometry, boundingBox, 6, cachedBuffer, options );
+
+        CHECK( cachedBuffer.cells( ) == expected.first );
+    }
+
+    TEST_CASE( "LeafCallback_test" )
+    {
+        auto geometry = createStreamTestGeometry( );
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        std::size_t numberOfLeaves = 0, numberOfChunks = 0, largestChunk = 0;
+        LeafCallback callback( [&]( const Cell2D*, const unsigned int*, std::size_t n )
+        {
+            numberOfLeaves += n;
+            numberOfChunks += 1;
+            largestChunk = std::max( largestChunk, n );
+        } );
+
+        streamQuadTree( *geometry, boundingBox, 10, callback );
+
+        CHECK( numberOfLeaves == 14740 );
+        CHECK( largestChunk == leafChunkSize );
+        CHECK( numberOfChunks == ( 14740 + leafChunkSize - 1 ) / leafChunkSize );
+    }
+
+    TEST_CASE( "VtkStreamWriter_test" )
+    {
+        auto geometry = createStreamTestGeometry( );
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::QuadTreeNode rootNode( boundingBox, 0 );
+        rootNode.partition( *geometry, 6 );
+
+        std::string expectedFile = "stream_writer_expected.vtk";
+        std::string streamedFile = "stream_writer_streamed.vtk";
+
+        detail::writeCellsToVtkFile( rootNode.getLeafCells( ), expectedFile );
+
+        {
+            VtkStreamWriter writer( streamedFile );
+            streamQuadTree( *geometry, boundingBox, 6, writer );
+            CHECK( writer.numberOfCells( ) == 856 );
+        }
+
+        // Only the padding of the patched point count differs
+        CHECK( readTokens( streamedFile ) == readTokens( expectedFile ) );
+
+        std::string binaryFile = "stream_writer_binary.vtk";
+        {
+            VtkStreamWriter writer( binaryFile, VtkFormat::Binary );
+            streamQuadTree( *geometry, boundingBox, 6, writer );
+        }
+
+        std::ifstream file( binaryFile, std::ios::binary );
+        std::string line;
+        for( int i = 0; i < 5; ++i )
+        {
+            std::getline( file, line );
+        }
+        CHECK( line.substr( 0, 7 ) == "POINTS " );
+        CHECK( std::stoul( line.substr( 7 ) ) == 4 * 856 );
+
+        file.seekg( 4 * 856 * 3 * sizeof( double ) + 1, std::ios::cur );
+        std::getline( file, line );
+        CHECK( line == "CELLS 856 4280" );
+        file.close( );
+
+        CHECK_THROWS( VtkStreamWriter( "nonexistent_directory/out.vtk" ) );
+
+        // Streamed and tree-based output report an unwritable file alike
+        std::string unwritable = "nonexistent_directory/out.vtk";
+        PartitionOptions twoThreads;
+        twoThreads.numberOfThreads = 2;
+
+        CHECK_THROWS_AS( generateQuadTree( *geometry, boundingBox, 3, unwritable ), std::runtime_error );
+        CHECK_THROWS_AS( generateQuadTree( *geometry, boundingBox, 3, unwritable, twoThreads ), std::runtime_error );
+        CHECK_THROWS_AS( generateQuadTree( *geometry, boundingBox, 3, unwritable, { }, VtkFormat::Binary ), std::runtime_error );
+
+        std::remove( expectedFile.c_str( ) );
+        std::remove( streamedFile.c_str( ) );
+        std::remove( binaryFile.c_str( ) );
+    }
+} // namespace implicit
@@ -0,0 +1,244 @@
+#include "catch.hpp"
+#include "linear_quadtree.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace implicit
+{
+    TEST_CASE( "Morton_test" )
+    {
+        auto code = detail::encodeMorton( 0x12345u, 0x6789Au );
+
+        CHECK( detail::mortonX( code ) == 0x12345u );
+        CHECK( detail::mortonY( code ) == 0x6789Au );
+
+        // Children follow the order of subdivideCell: (x0, y0), (x0, y1), (x1, y0), (x1, y1)
+        CHECK( detail::mortonY( detail::childCode( 0, 0, 1 ) ) == detail::cellExtent( 1 ) );
+        CHECK( detail::mortonX( detail::childCode( 0, 0, 2 ) ) == detail::cellExtent( 1 ) );
+        CHECK( detail::childIndex( detail::childCode( 0, 0, 3 ), 1 ) == 3 );
+
+        auto offset = detail::encodeMorton( 7u, 300u );
+        auto sum = detail::addMorton( code, offset );
+
+        CHECK( detail::mortonX( sum ) == 0x12345u + 7u );
+        CHECK( detail::mortonY( sum ) == 0x6789Au + 300u );
+        CHECK( detail::subtractMorton( sum, offset ) == code );
+    }
+
+    TEST_CASE( "LinearQuadTree_test" )
+    {
+        auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+        auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+        auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+        auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+        auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+        auto geometry = std::make_shared<Difference>( union1, circle2 );
+
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::QuadTreeNode rootNode( boundingBox, 0 );
+        rootNode.partition( *geometry, 6 );
+
+        detail::LinearQuadTree tree( boundingBox );
+        CHECK( tree.size( ) == 1 );
+
+        tree.partition( *geometry, 6 );
+
+        CHECK( tree.size( ) == 856 );
+        CHECK( tree.getLeafCells( ) == rootNode.getLeafCells( ) );
+        CHECK( std::is_sorted( tree.codes( ).begin( ), tree.codes( ).end( ) ) );
+
+        PartitionOptions options;
+        options.numberOfThreads = 3;
+        options.taskGranularity = 2;
+
+        detail::LinearQuadTree parallelTree( boundingBox );
+        parallelTree.partition( *geometry, 6, options );
+
+        CHECK( parallelTree.codes( ) == tree.codes( ) );
+        CHECK( parallelTree.levels( ) == tree.levels( ) );
+    }
+
+    TEST_CASE( "PointLocation_test" )
+    {
+        auto circle = std::make_shared<Circle>( 0.1, 0.2, 0.9 );
+        auto bar = std::make_shared<Rectangle>( -0.05, -1.0, 0.05, 1.0 );
+        Union geometry( circle, bar );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::QuadTreeNode rootNode( boundingBox, 0 );
+        rootNode.partition( geometry, 7 );
+
+        detail::LinearQuadTree tree( boundingBox );
+        tree.partition( geometry, 7 );
+
+        std::vector<double> x, y;
+        for( int i = 0; i < 101; ++i )
+        {
+            for( int j = 0; j < 101; ++j )
+            {
+                x.push_back( -1.0 + 0.0199 * i + 0.0001 );
+                y.push_back( -1.0 + 0.0199 * j + 0.0003 );
+            }
+        }
+        x.push_back( 1.0 ); y.push_back( 1.0 );
+        x.push_back( 1.5 ); y.push_back( 0.0 );
+
+        auto indices = tree.locate( x.data( ), y.data( ), x.size( ) );
+        auto parallelIndices = tree.locate( x.data( ), y.data( ), x.size( ), 4 );
+
+        CHECK( parallelIndices == indices );
+
+        for( std::size_t i = 0; i + 1 < x.size( ); ++i )
+        {
+            const auto *leaf = rootNode.findLeaf( x[i], y[i] );
+            REQUIRE( leaf != nullptr );
+            REQUIRE( leaf->isLeaf( ) );
+
+            CHECK( indices[i] == tree.locate( x[i], y[i] ) );
+            REQUIRE( indices[i] != detail::LinearQuadTree::npos );
+            CHECK( tree.cell( indices[i] ) == leaf->cell( ) );
+            CHECK( tree.level( indices[i] ) == static_cast<unsigned int>( leaf->level( ) ) );
+        }
+
+        CHECK( rootNode.findLeaf( 1.5, 0.0 ) == nullptr );
+        CHECK( indices.back( ) == detail::LinearQuadTree::npos );
+    }
+
+    TEST_CASE( "LeafStates_test" )
+    {
+        Circle circle( 0.1, 0.2, 0.6 );
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        PartitionOptions options;
+        options.numberOfThreads = 2;
+
+        detail::LinearQuadTree tree( boundingBox );
+        tree.partition( circle, 6, options );
+
+        CHECK_FALSE( tree.hasStates( ) );
+        tree.classifyLeaves( circle, options );
+        REQUIRE( tree.hasStates( ) );
+
+        std::size_t numberOfCutLeaves = 0;
+        for( std::size_t i = 0; i < tree.size( ); ++i )
+        {
+            auto state = tree.state( i );
+            if( state == CellClassification::Cut )
+            {
+                ++numberOfCutLeaves;
+                CHECK( tree.level( i ) == 6 );
+            }
+            else if( circle.classify( tree.cell( i ) ) != CellClassification::Cut )
+            {
+                CHECK( circle.classify( tree.cell( i ) ) == state );
+            }
+        }
+
+        CHECK( numberOfCutLeaves > 0 );
+        CHECK( tree.state( tree.locate( 0.1, 0.2 ) ) == CellClassification::Inside );
+        CHECK( tree.state( tree.locate( -0.95, 0.95 ) ) == CellClassification::Outside );
+    }
+
+    TEST_CASE( "BudgetedRefinement_test" )
+    {
+        auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+        auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+        auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+        auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+        auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+        auto geometry = std::make_shared<Difference>( union1, circle2 );
+
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::LinearQuadTree depthTree( boundingBox );
+        depthTree.partition( *geometry, 8 );
+
+        RefinementBudget budget;
+        budget.maxDepth = 8;
+
+        // Without limits, the best-first order does not change the result
+        for( auto priority : { RefinementPriority::CellSize, RefinementPriority::BoundaryLength } )
+        {
+            budget.priority = priority;
+
+            detail::LinearQuadTree tree( boundingBox );
+            tree.refine( *geometry, budget );
+
+            CHECK( tree.size( ) == 3640 );
+            CHECK( tree.codes( ) == depthTree.codes( ) );
+            CHECK( tree.levels( ) == depthTree.levels( ) );
+            CHECK_FALSE( tree.truncated( ) );
+        }
+
+        budget.maxLeaves = 1000;
+
+        for( auto priority : { RefinementPriority::CellSize, RefinementPriority::BoundaryLength } )
+        {
+            budget.priority = priority;
+
+            detail::LinearQuadTree tree( boundingBox );
+            tree.refine( *geometry, budget );
+
+            CHECK( tree.size( ) <= 1000 );
+            CHECK( tree.size( ) > 1000 - 3 );
+            CHECK( tree.truncated( ) );
+            CHECK( std::is_sorted( tree.codes( ).begin( ), tree.codes( ).end( ) ) );
+
+            // The leaves still tile the domain
+            double area = 0.0;
+            for( auto level : tree.levels( ) )
+            {
+                area += std::ldexp( 1.0, -2 * level );
+            }
+            CHECK( area == 1.0 );
+
+            // The bounded seed point cache does not change the leaves
+            PartitionOptions options;
+            options.cacheSeedPoints = true;
+
+            detail::LinearQuadTree cachedTree( boundingBox );
+            cachedTree.refine( *geometry, budget, options );
+
+            CHECK( cachedTree.codes( ) == tree.codes( ) );
+
+            if( priority == RefinementPriority::CellSize )
+            {
+                // Cut cells are split level by level
+                tree.classifyLeaves( *geometry );
+
+                unsigned int coarsestCut = 8, finestCut = 0;
+                for( std::size_t i = 0; i < tree.size( ); ++i )
+                {
+                    if( tree.state( i ) == CellClassification::Cut )
+                    {
+                        coarsestCut = std::min( coarsestCut, tree.level( i ) );
+                        finestCut = std::max( finestCut, tree.level( i ) );
+                    }
+                }
+
+                CHECK( finestCut - coarsestCut <= 1 );
+                CHECK( finestCut < 8 );
+            }
+        }
+
+        budget.maxLeaves = 0;
+        budget.maxSeconds = 1e-9;
+
+        detail::LinearQuadTree timedTree( boundingBox );
+        timedTree.refine( *geometry, budget );
+
+        CHECK( timedTree.truncated( ) );
+        CHECK( timedTree.size( ) < depthTree.size( ) );
+    }
+} // namespace implicit
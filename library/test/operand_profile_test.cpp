@@ -0,0 +1,222 @@
+#include "catch.hpp"
+#include "operand_profile.h"
+#include "quadtree_helper.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+#include "NaryUnion.hpp"
+
+#include <memory>
+#include <thread>
+
+namespace implicit
+{
+    namespace
+    {
+        // Union of a chain of circles, so evaluating it visits many operations
+        ImplicitGeometryPtr circleChain( int numberOfCircles )
+        {
+            ImplicitGeometryPtr chain = std::make_shared<Circle>( -0.8, 0.0, 0.1 );
+
+            for( int i = 1; i < numberOfCircles; ++i )
+            {
+                auto circle = std::make_shared<Circle>( -0.8 + 1.6 * i / ( numberOfCircles - 1.0 ), 0.0, 0.1 );
+                chain = std::make_shared<Union>( chain, circle );
+            }
+
+            return chain;
+        }
+
+        void checkSameInside( const AbsImplicitGeometry& geometry, const AbsImplicitGeometry& reference )
+        {
+            for( int i = 0; i <= 40; ++i )
+            {
+                for( int j = 0; j <= 40; ++j )
+                {
+                    double x = -1.0 + 0.05 * i;
+                    double y = -1.0 + 0.05 * j;
+                    CHECK( geometry.inside( x, y ) == reference.inside( x, y ) );
+                }
+            }
+        }
+    }
+
+    TEST_CASE( "setOperand2First_test" )
+    {
+        auto circle = std::make_shared<Circle>( 0.0, 0.0, 1.0 );
+        auto rectangle = std::make_shared<Rectangle>( 0.0, -2.0, 2.0, 2.0 );
+
+        Difference difference( circle, rectangle );
+        Difference reference( circle, rectangle );
+
+        CHECK( difference.operand2First( ) == false );
+
+        difference.setOperand2First( true );
+        CHECK( difference.operand2First( ) == true );
+
+        checkSameInside( difference, reference );
+
+        double x[] = { -0.5, 0.5, -1.5, 0.0 };
+        double y[] = { 0.0, 0.0, 0.0, 0.9 };
+
+        CHECK( difference.insideBatch( x, y, 4 ) == PointMask( 1 ) );
+    }
+
+    TEST_CASE( "operandProfiler_test" )
+    {
+        auto chain = circleChain( 16 );
+        auto window = std::make_shared<Rectangle>( 0.2, -0.3, 0.5, 0.3 );
+        auto cover = std::make_shared<Rectangle>( -2.0, -2.0, 2.0, -0.1 );
+
+        // The cheap window decides most queries of the intersection, the cheap cover most of the union
+        auto intersection = std::make_shared<Intersection>( chain, window );
+        Union geometry( intersection, cover );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::QuadTreeNode reference( boundingBox, 0 );
+        reference.partition( geometry, 6 );
+
+        {
+            detail::OperandProfiler profiler( geometry );
+            detail::QuadTreeNode node( boundingBox, 0 );
+            node.partition( geometry, 4 );
+
+            auto counters = profiler.finish( );
+
+            REQUIRE( counters.size( ) == 17 );
+            CHECK( counters[0].evaluations[0] > 0 );
+            CHECK( counters[0].evaluations[1] > 0 );
+            CHECK( counters[0].cost[0] > counters[0].cost[1] );
+        }
+
+        CHECK( geometry.operand2First( ) == true );
+        CHECK( intersection->operand2First( ) == true );
+
+        Union unordered( std::make_shared<Intersection>( chain, window ), cover );
+        checkSameInside( geometry, unordered );
+
+        detail::QuadTreeNode node( boundingBox, 0 );
+        node.partition( geometry, 6 );
+
+        CHECK( node.getLeafCells( ) == reference.getLeafCells( ) );
+
+        // Profiling is detached after finish, so later evaluations are not recorded
+        detail::OperandProfiler profiler( geometry );
+        auto counters = profiler.finish( );
+
+        CHECK( counters[0].evaluations[0] == 0 );
+        CHECK( counters[0].evaluations[1] == 0 );
+    }
+
+    TEST_CASE( "profileDepth_test" )
+    {
+        auto chain = circleChain( 16 );
+        auto window = std::make_shared<Rectangle>( 0.2, -0.3, 0.5, 0.3 );
+        auto geometry = std::make_shared<Intersection>( chain, window );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::QuadTreeNode reference( boundingBox, 0 );
+        reference.partition( *geometry, 7 );
+
+        PartitionOptions options;
+        options.profileDepth = 4;
+        options.numberOfThreads = 4;
+        options.taskGranularity = 2;
+
+        detail::QuadTreeNode node( boundingBox, 0 );
+        node.partition( *geometry, 7, options );
+
+        CHECK( geometry->operand2First( ) == true );
+        CHECK( node.getLeafCells( ) == reference.getLeafCells( ) );
+
+        // Without profiling the order is left alone
+        geometry->setOperand2First( false );
+        options.profileDepth = 0;
+
+        detail::QuadTreeNode unprofiledNode( boundingBox, 0 );
+        unprofiledNode.partition( *geometry, 7, options );
+
+        CHECK( geometry->operand2First( ) == false );
+        CHECK( unprofiledNode.getLeafCells( ) == reference.getLeafCells( ) );
+    }
+
+    TEST_CASE( "operandProfilerCost_test" )
+    {
+        // The pores decide more often than the wide window, but a query may visit all 64 of them
+        std::vector<ImplicitGeometryPtr> pores;
+        for( int i = 0; i < 8; ++i )
+        {
+            for( int j = 0; j < 8; ++j )
+            {
+                pores.push_back( std::make_shared<Circle>( -0.9 + 0.25 * i, -0.9 + 0.25 * j, 0.1 ) );
+            }
+        }
+
+        auto porosity = std::make_shared<NaryUnion>( pores );
+        auto window = std::make_shared<Rectangle>( -1.0, -1.0, 0.8, 1.0 );
+        Intersection geometry( porosity, window );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::OperandProfiler profiler( geometry );
+        detail::QuadTreeNode node( boundingBox, 0 );
+        node.partition( geometry, 4 );
+
+        auto counters = profiler.finish( );
+
+        REQUIRE( counters.size( ) == 1 );
+        CHECK( counters[0].decisions[0] * counters[0].evaluations[1] > counters[0].decisions[1] * counters[0].evaluations[0] );
+        CHECK( counters[0].cost[0] > 10 * counters[0].evaluations[0] );
+        CHECK( counters[0].cost[1] == counters[0].evaluations[1] );
+        CHECK( geometry.operand2First( ) == true );
+    }
+
+    TEST_CASE( "concurrentProfiles_test" )
+    {
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        auto shared = std::make_shared<Intersection>( circleChain( 16 ), std::make_shared<Rectangle>( 0.2, -0.3, 0.5, 0.3 ) );
+
+        detail::QuadTreeNode reference( boundingBox, 0 );
+        reference.partition( *shared, 7 );
+
+        // Profiles of different sizes on the same and on separate geometries must not interfere
+        std::vector<std::thread> threads;
+        for( int t = 0; t < 4; ++t )
+        {
+            threads.emplace_back( [&, t]( )
+            {
+                auto own = std::make_shared<Intersection>( circleChain( 4 + 8 * t ), std::make_shared<Rectangle>( 0.2, -0.3, 0.5, 0.3 ) );
+
+                PartitionOptions options;
+                options.profileDepth = 4;
+
+                for( int repeat = 0; repeat < 5; ++repeat )
+                {
+                    detail::QuadTreeNode ownNode( boundingBox, 0 );
+                    ownNode.partition( *own, 6, options );
+
+                    detail::QuadTreeNode sharedNode( boundingBox, 0 );
+                    sharedNode.partition( *shared, 7, options );
+                }
+            } );
+        }
+
+        for( auto& thread : threads )
+        {
+            thread.join( );
+        }
+
+        CHECK( shared->operand2First( ) == true );
+
+        detail::QuadTreeNode node( boundingBox, 0 );
+        node.partition( *shared, 7 );
+
+        CHECK( node.getLeafCells( ) == reference.getLeafCells( ) );
+    }
+
+} // namespace implicit
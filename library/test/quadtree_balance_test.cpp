@@ -0,0 +1,128 @@
+#include "catch.hpp"
+#include "quadtree_balance.h"
+#include "linear_quadtree.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace implicit
+{
+    namespace
+    {
+        std::shared_ptr<AbsImplicitGeometry> createBalanceTestGeometry( )
+        {
+            auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+            auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+            auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+            auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+            auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+            auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+            return std::make_shared<Difference>( union1, circle2 );
+        }
+
+        // Returns the face of a shared by b, or -1 if they share no edge of positive length
+        int sharedFace( detail::MortonCode a, int levelA, detail::MortonCode b, int levelB )
+        {
+            std::int64_t ax = detail::mortonX( a ), ay = detail::mortonY( a ), ae = detail::cellExtent( levelA );
+            std::int64_t bx = detail::mortonX( b ), by = detail::mortonY( b ), be = detail::cellExtent( levelB );
+
+            bool overlapX = ax < bx + be && bx < ax + ae;
+            bool overlapY = ay < by + be && by < ay + ae;
+
+            if( overlapY && bx + be == ax ) return static_cast<int>( detail::Face::Left );
+            if( overlapY && ax + ae == bx ) return static_cast<int>( detail::Face::Right );
+            if( overlapX && by + be == ay ) return static_cast<int>( detail::Face::Bottom );
+            if( overlapX && ay + ae == by ) return static_cast<int>( detail::Face::Top );
+            return -1;
+        }
+    }
+
+    TEST_CASE( "NeighbourTable_test" )
+    {
+        auto geometry = createBalanceTestGeometry( );
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::LinearQuadTree tree( boundingBox );
+        tree.partition( *geometry, 6 );
+
+        auto table = detail::buildNeighbourTable( tree );
+        const auto& codes = tree.codes( );
+        const auto& levels = tree.levels( );
+
+        REQUIRE( table.offsets.size( ) == tree.size( ) + 1 );
+        REQUIRE( table.neighbours.size( ) == table.faces.size( ) );
+
+        for( std::size_t i = 0; i < tree.size( ); ++i )
+        {
+            std::vector<std::size_t> expected;
+            for( std::size_t j = 0; j < tree.size( ); ++j )
+            {
+                if( sharedFace( codes[i], levels[i], codes[j], levels[j] ) >= 0 )
+                {
+                    expected.push_back( j );
+                }
+            }
+
+            std::vector<std::size_t> found( table.neighbours.begin( ) + table.offsets[i],
+                                            table.neighbours.begin( ) + table.offsets[i + 1] );
+
+            for( std::size_t k = table.offsets[i]; k < table.offsets[i + 1]; ++k )
+            {
+                auto j = table.neighbours[k];
+                CHECK( sharedFace( codes[i], levels[i], codes[j], levels[j] ) == static_cast<int>( table.faces[k] ) );
+            }
+
+            std::sort( found.begin( ), found.end( ) );
+            CHECK( found == expected );
+        }
+    }
+
+    TEST_CASE( "QuadTreeBalance_test" )
+    {
+        auto geometry = createBalanceTestGeometry( );
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::LinearQuadTree original( boundingBox );
+        original.partition( *geometry, 8 );
+
+        detail::LinearQuadTree tree = original;
+        tree.balance( );
+
+        const auto& codes = tree.codes( );
+        const auto& levels = tree.levels( );
+
+        CHECK( tree.size( ) > original.size( ) );
+        CHECK( std::is_sorted( codes.begin( ), codes.end( ) ) );
+
+        // The balanced leaves refine the original ones and still tile the domain
+        detail::MortonCode area = 0;
+        for( std::size_t i = 0; i < tree.size( ); ++i )
+        {
+            area += detail::mortonSpan( levels[i] );
+
+            auto j = original.locate( 0.5 * ( tree.cell( i )[0][0] + tree.cell( i )[0][1] ),
+                                      0.5 * ( tree.cell( i )[1][0] + tree.cell( i )[1][1] ) );
+            CHECK( original.level( j ) <= levels[i] );
+        }
+        CHECK( area == detail::mortonSpan( 0 ) );
+
+        auto table = detail::buildNeighbourTable( tree );
+        for( std::size_t i = 0; i < tree.size( ); ++i )
+        {
+            for( std::size_t k = table.offsets[i]; k < table.offsets[i + 1]; ++k )
+            {
+                CHECK( std::abs( levels[i] - levels[table.neighbours[k]] ) <= 1 );
+            }
+        }
+
+        // Balancing a balanced tree changes nothing
+        auto balancedCodes = tree.codes( );
+        tree.balance( );
+        CHECK( tree.codes( ) == balancedCodes );
+    }
+} // namespace implicit
@@ -0,0 +1,133 @@
+#include "catch.hpp"
+#include "quadtree_file.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace implicit
+{
+    TEST_CASE( "QuadTreeFile_test" )
+    {
+        auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+        auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+        auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+        auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+        auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+        auto geometry = std::make_shared<Difference>( union1, circle2 );
+
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::LinearQuadTree tree( boundingBox );
+        tree.partition( *geometry, 6 );
+
+        std::string filename = "quadtree_file_test.bin";
+        detail::writeQuadTreeFile( tree, filename );
+
+        {
+            detail::MappedQuadTree mapped( filename );
+
+            REQUIRE( mapped.size( ) == 856 );
+            CHECK( mapped.rootCell( ) == boundingBox );
+            CHECK( mapped.maxDepth( ) == 6 );
+            CHECK( !mapped.truncated( ) );
+            CHECK( !mapped.hasStates( ) );
+            CHECK( std::equal( tree.codes( ).begin( ), tree.codes( ).end( ), mapped.codes( ) ) );
+            CHECK( std::equal( tree.levels( ).begin( ), tree.levels( ).end( ), mapped.levels( ) ) );
+            CHECK( mapped.cell( 100 ) == tree.cell( 100 ) );
+            CHECK( mapped.getLeafCells( ) == tree.getLeafCells( ) );
+
+            std::ifstream file( filename, std::ios::binary | std::ios::ate );
+            CHECK( static_cast<std::size_t>( file.tellg( ) ) == 64 + 856 * 8 + 856 );
+        }
+
+        // States and the truncation flag of a budgeted refinement are kept
+        RefinementBudget budget;
+        budget.maxLeaves = 400;
+        budget.maxDepth = 8;
+
+        detail::LinearQuadTree refined( boundingBox );
+        refined.refine( *geometry, budget );
+        refined.classifyLeaves( *geometry );
+        REQUIRE( refined.truncated( ) );
+
+        detail::writeQuadTreeFile( refined, filename );
+
+        {
+            detail::MappedQuadTree mapped( filename );
+
+            REQUIRE( mapped.hasStates( ) );
+            CHECK( mapped.truncated( ) );
+            CHECK( mapped.maxDepth( ) == 8 );
+
+            for( std::size_t i = 0; i < mapped.size( ); ++i )
+            {
+                CHECK( mapped.state( i ) == refined.state( i ) );
+            }
+
+            auto copy = mapped.toLinearQuadTree( );
+
+            CHECK( copy.codes( ) == refined.codes( ) );
+            CHECK( copy.levels( ) == refined.levels( ) );
+            CHECK( copy.hasStates( ) );
+            CHECK( copy.truncated( ) );
+            CHECK( copy.locate( 0.3, -0.2 ) == refined.locate( 0.3, -0.2 ) );
+            CHECK( copy.state( copy.locate( 0.0, 0.0 ) ) == CellClassification::Outside );
+        }
+
+        // Corrupt levels and states are rejected when the file is opened
+        {
+            std::ifstream input( filename, std::ios::binary );
+            std::string content( ( std::istreambuf_iterator<char>( input ) ), std::istreambuf_iterator<char>( ) );
+            input.close( );
+
+            std::size_t n = refined.size( );
+            std::size_t levelOffset = 64 + 8 * n;
+            std::size_t stateOffset = levelOffset + ( n + 7 ) / 8 * 8;
+
+            std::string badLevel = content;
+            badLevel[levelOffset + 3] = 9;
+            std::ofstream( filename, std::ios::binary ).write( badLevel.data( ), static_cast<std::streamsize>( badLevel.size( ) ) );
+
+            CHECK_THROWS_WITH( detail::MappedQuadTree( filename ), Catch::Contains( "level" ) );
+
+            std::string badState = content;
+            badState[stateOffset + n - 1] = 3;
+            std::ofstream( filename, std::ios::binary ).write( badState.data( ), static_cast<std::streamsize>( badState.size( ) ) );
+
+            CHECK_THROWS_WITH( detail::MappedQuadTree( filename ), Catch::Contains( "state" ) );
+
+            std::ofstream( filename, std::ios::binary ).write( content.data( ), static_cast<std::streamsize>( content.size( ) ) );
+            CHECK_NOTHROW( detail::MappedQuadTree( filename ) );
+        }
+
+        // Truncated and foreign files are rejected
+        {
+            std::ifstream input( filename, std::ios::binary );
+            std::string content( ( std::istreambuf_iterator<char>( input ) ), std::istreambuf_iterator<char>( ) );
+
+            std::ofstream output( filename, std::ios::binary );
+            output.write( content.data( ), static_cast<std::streamsize>( content.size( ) - 1 ) );
+        }
+
+        CHECK_THROWS_WITH( detail::MappedQuadTree( filename ), Catch::Contains( "truncated" ) );
+
+        {
+            std::ofstream output( filename );
+            output << "# vtk DataFile Version 3.0\n";
+        }
+
+        CHECK_THROWS_WITH( detail::MappedQuadTree( filename ), Catch::Contains( "not a quadtree file" ) );
+        CHECK_THROWS_AS( detail::MappedQuadTree( "quadtree_file_test.missing" ), std::runtime_error );
+
+        std::remove( filename.c_str( ) );
+    }
+
+} // namespace implicit
@@ -0,0 +1,94 @@
+#include "catch.hpp"
+#include "quadtree_integration.h"
+#include "quadtree_helper.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Difference.hpp"
+
+#include <cmath>
+
+namespace implicit
+{
+    TEST_CASE( "cellMoments_test" )
+    {
+        Cell2D cell { Bounds { 1.0, 3.0 }, Bounds { -1.0, 0.0 } };
+        auto moments = detail::cellMoments( cell );
+
+        CHECK( moments.area == Approx( 2.0 ) );
+        CHECK( moments.centroid( )[0] == Approx( 2.0 ) );
+        CHECK( moments.centroid( )[1] == Approx( -0.5 ) );
+
+        // b h³ / 12 about the centroid
+        auto central = moments.centralSecondMoments( );
+        CHECK( central[0] == Approx( 8.0 / 12.0 ) );
+        CHECK( central[1] == Approx( 0.0 ).margin( 1e-12 ) );
+        CHECK( central[2] == Approx( 2.0 / 12.0 ) );
+    }
+
+    TEST_CASE( "integrateLeaves_test" )
+    {
+        double pi = std::acos( -1.0 );
+        double r = 0.5;
+        Circle circle( 0.1, -0.05, r );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::QuadTreeNode rootNode( boundingBox, 0 );
+        rootNode.partition( circle, 6 );
+        auto cells = rootNode.getLeafCells( ).first;
+
+        auto result = detail::integrateLeaves( circle, cells );
+        REQUIRE( result.leaves.size( ) == cells.size( ) );
+
+        CHECK( result.total.area == Approx( pi * r * r ).epsilon( 1e-3 ) );
+        CHECK( result.total.centroid( )[0] == Approx( 0.1 ).margin( 1e-3 ) );
+        CHECK( result.total.centroid( )[1] == Approx( -0.05 ).margin( 1e-3 ) );
+
+        auto central = result.total.centralSecondMoments( );
+        CHECK( central[0] == Approx( pi * r * r * r * r / 4.0 ).epsilon( 5e-3 ) );
+        CHECK( central[1] == Approx( 0.0 ).margin( 1e-5 ) );
+        CHECK( central[2] == Approx( pi * r * r * r * r / 4.0 ).epsilon( 5e-3 ) );
+
+        for( std::size_t i = 0; i < cells.size( ); ++i )
+        {
+            double fraction = result.areaFraction( cells, i );
+            CHECK( fraction >= 0.0 );
+            CHECK( fraction <= 1.0 );
+
+            if( circle.classify( cells[i] ) == CellClassification::Inside )
+            {
+                CHECK( fraction == 1.0 );
+            }
+        }
+
+        detail::IntegrationOptions options;
+        options.numberOfThreads = 4;
+
+        auto parallelResult = detail::integrateLeaves( circle, cells, options );
+        CHECK( parallelResult.total.area == result.total.area );
+        CHECK( parallelResult.total.xx == result.total.xx );
+    }
+
+    TEST_CASE( "integrateLeavesExact_test" )
+    {
+        // A square hole aligned with the sub-cell grid is integrated exactly
+        auto plate = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto hole = std::make_shared<Rectangle>( 0.0, 0.0, 0.5, 0.5 );
+        Difference geometry( plate, hole );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::QuadTreeNode rootNode( boundingBox, 0 );
+        rootNode.partition( geometry, 4 );
+        auto cells = rootNode.getLeafCells( ).first;
+
+        auto result = detail::integrateLeaves( geometry, cells );
+        auto expected = detail::cellMoments( boundingBox );
+        auto holeMoments = detail::cellMoments( Cell2D { Bounds { 0.0, 0.5 }, Bounds { 0.0, 0.5 } } );
+
+        CHECK( result.total.area == Approx( expected.area - holeMoments.area ) );
+        CHECK( result.total.x == Approx( expected.x - holeMoments.x ).margin( 1e-12 ) );
+        CHECK( result.total.xy == Approx( expected.xy - holeMoments.xy ).margin( 1e-12 ) );
+        CHECK( result.total.yy == Approx( expected.yy - holeMoments.yy ) );
+    }
+} // namespace implicit
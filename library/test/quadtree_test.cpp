@@ -1,11 +1,21 @@
 #include "catch.hpp"
 #include "quadtree_helper.h"
+#include "seed_cache.h"
 #include "Circle.hpp"
 #include "Rectangle.hpp"
 #include "Intersection.hpp"
 #include "Union.hpp"
 #include "Difference.hpp"
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+
 namespace implicit
 {
     TEST_CASE("SubdivideCell_test")
@@ -60,6 +70,585 @@ namespace implicit
         CHECK( detail::isCutByBoundary( outsideCell, circle, 3 ) == false );
     }
 
+    TEST_CASE( "isCutByBoundaryInterval_test" )
+    {
+        // Thin bar lying between the seed points of the cell
+        Rectangle bar( 0.2, -1.0, 0.3, 1.0 );
+
+        Cell2D cell { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        PartitionOptions options;
+        CHECK( detail::isCutByBoundary( cell, bar, options ) == false );
+
+        options.cutCriterion = CutCriterion::Interval;
+        CHECK( detail::isCutByBoundary( cell, bar, options ) == true );
+
+        Cell2D outsideCell { Bounds { 0.4, 1.0 }, Bounds { -1.0, 1.0 } };
+        CHECK( detail::isCutByBoundary( outsideCell, bar, options ) == false );
+    }
+
+    class CountingCircle : public Circle
+    {
+    public:
+        CountingCircle( double x, double y, double radius ) : Circle( x, y, radius ), count( 0 )
+        { }
+
+        bool inside( double x, double y ) const override
+        {
+            ++count;
+            return Circle::inside( x, y );
+        }
+
+        PointMask insideBatch( const double *x, const double *y, std::size_t n ) const override
+        {
+            count += n;
+            return Circle::insideBatch( x, y, n );
+        }
+
+        mutable std::size_t count;
+    };
+
+    TEST_CASE( "estimateBoundaryLength_test" )
+    {
+        Circle circle( 0.1, -0.05, 0.5 );
+        Cell2D cell { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        double pi = std::acos( -1.0 );
+
+        CHECK( detail::estimateBoundaryLength( cell, circle, 65 ) == Approx( pi ).epsilon( 0.05 ) );
+        CHECK( detail::estimateBoundaryLength( cell, circle, 7 ) > 0.0 );
+
+        Cell2D insideCell { Bounds { 0.0, 0.1 }, Bounds { 0.0, 0.1 } };
+        CHECK( detail::estimateBoundaryLength( insideCell, circle, 7 ) == 0.0 );
+
+        // The options overload agrees with the cut test of the same options
+        PartitionOptions options;
+        for( const auto& quadrant : detail::subdivideCell( cell ) )
+        {
+            for( const auto& subCell : detail::subdivideCell( quadrant ) )
+            {
+                CHECK( ( detail::estimateBoundaryLength( subCell, circle, options, 2 ) > 0.0 ) ==
+                       detail::isCutByBoundary( subCell, circle, options, 2 ) );
+            }
+        }
+    }
+
+    TEST_CASE( "distanceCulling_test" )
+    {
+        CountingCircle circle( 0.1, 0.2, 0.9 );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        PartitionOptions options;
+        options.distanceCulling = false;
+
+        detail::QuadTreeNode sampledNode( boundingBox, 0 );
+        sampledNode.partition( circle, 6, options );
+        std::size_t sampledCount = circle.count;
+
+        circle.count = 0;
+        options.distanceCulling = true;
+
+        detail::QuadTreeNode culledNode( boundingBox, 0 );
+        culledNode.partition( circle, 6, options );
+
+        // Culling only skips uniform cells, so the leaves are identical
+        CHECK( culledNode.getLeafCells( ) == sampledNode.getLeafCells( ) );
+        CHECK( circle.count < sampledCount );
+    }
+
+    TEST_CASE( "seedPointCache_test" )
+    {
+        CountingCircle circle( 0.1, 0.2, 0.9 );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        PartitionOptions options;
+        options.distanceCulling = false;
+        options.earlyExit = false;
+
+        detail::QuadTreeNode sampledNode( boundingBox, 0 );
+        sampledNode.partition( circle, 6, options );
+        std::size_t sampledCount = circle.count;
+
+        circle.count = 0;
+        options.cacheSeedPoints = true;
+
+        detail::QuadTreeNode cachedNode( boundingBox, 0 );
+        cachedNode.partition( circle, 6, options );
+
+        // No seed lies exactly on the circle, so rounding of the lattice coordinates is irrelevant
+        CHECK( cachedNode.getLeafCells( ) == sampledNode.getLeafCells( ) );
+        CHECK( circle.count < sampledCount * 2 / 3 );
+
+        // Seeds shared between cells are evaluated exactly once
+        detail::SeedPointCache cache( boundingBox, 1, 3 );
+
+        circle.count = 0;
+        for( const auto& cell : detail::subdivideCell( boundingBox ) )
+        {
+            cache.isCutByBoundary( cell, circle );
+        }
+
+        CHECK( circle.count == 25 );
+        CHECK( cache.size( ) == 25 );
+
+        // A full cache still answers correctly, but stores no further seeds
+        detail::SeedPointCache boundedCache( boundingBox, 1, 3, 9 );
+
+        for( const auto& cell : detail::subdivideCell( boundingBox ) )
+        {
+            CHECK( boundedCache.isCutByBoundary( cell, circle ) == detail::isCutByBoundary( cell, circle, 3 ) );
+        }
+
+        CHECK( boundedCache.size( ) == 9 );
+    }
+
+    TEST_CASE( "earlyExit_test" )
+    {
+        CountingCircle circle( 0.1, 0.2, 0.9 );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        PartitionOptions options;
+        options.distanceCulling = false;
+        options.earlyExit = false;
+
+        detail::QuadTreeNode exhaustiveNode( boundingBox, 0 );
+        exhaustiveNode.partition( circle, 6, options );
+        std::size_t exhaustiveCount = circle.count;
+
+        circle.count = 0;
+        options.earlyExit = true;
+
+        detail::QuadTreeNode earlyNode( boundingBox, 0 );
+        earlyNode.partition( circle, 6, options );
+
+        // Early exit only changes the evaluation order, not the decision
+        CHECK( earlyNode.getLeafCells( ) == exhaustiveNode.getLeafCells( ) );
+        CHECK( circle.count < exhaustiveCount );
+
+        circle.count = 0;
+        options.cacheSeedPoints = true;
+
+        detail::QuadTreeNode cachedNode( boundingBox, 0 );
+        cachedNode.partition( circle, 6, options );
+
+        CHECK( cachedNode.getLeafCells( ) == exhaustiveNode.getLeafCells( ) );
+
+        Cell2D cutCell { Bounds { 0.5, 1.5 }, Bounds { 0.5, 1.5 } };
+        Cell2D insideCell { Bounds { -0.2, 0.2 }, Bounds { -0.2, 0.2 } };
+
+        for( int n : { 2, 3, 4, 7 } )
+        {
+            CHECK( detail::isCutByBoundary( cutCell, circle, n, true ) == true );
+            CHECK( detail::isCutByBoundary( insideCell, circle, n, true ) == false );
+        }
+    }
+
+    TEST_CASE( "seedPointsPerLevel_test" )
+    {
+        // The bar fits between the seeds of a 3 x 3 grid on the root and its children
+        Rectangle bar( 0.3, -0.9, 0.35, 0.9 );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        PartitionOptions options;
+        options.numberOfSeedPoints = 3;
+
+        CHECK( detail::seedPointsAtLevel( options, 0 ) == 3 );
+
+        detail::QuadTreeNode coarseNode( boundingBox, 0 );
+        coarseNode.partition( bar, 6, options );
+
+        CHECK( coarseNode.getLeafCells( ).first.size( ) == 1 );
+
+        options.seedPointsPerLevel = { 33, 17 };
+
+        CHECK( detail::seedPointsAtLevel( options, 1 ) == 17 );
+        CHECK( detail::seedPointsAtLevel( options, 2 ) == 3 );
+
+        detail::QuadTreeNode adaptiveNode( boundingBox, 0 );
+        adaptiveNode.partition( bar, 6, options );
+
+        CHECK( adaptiveNode.getLeafCells( ).first.size( ) > 1 );
+
+        // The cache needs the same seed grid on all levels
+        options.cacheSeedPoints = true;
+        CHECK_FALSE( detail::useSeedPointCache( options, 6 ) );
+
+        options.seedPointsPerLevel.clear( );
+        CHECK( detail::useSeedPointCache( options, 6 ) );
+    }
+
+    class PrecisionCountingCircle : public Circle
+    {
+    public:
+        PrecisionCountingCircle( double x, double y, double radius ) : Circle( x, y, radius )
+        { }
+
+        PointMask insideBatch( const double *x, const double *y, std::size_t n ) const override
+        {
+            ++doubleBatches;
+            return Circle::insideBatch( x, y, n );
+        }
+
+        PointMask insideBatch( const float *x, const float *y, std::size_t n ) const override
+        {
+            ++singleBatches;
+            return Circle::insideBatch( x, y, n );
+        }
+
+        mutable std::size_t doubleBatches = 0;
+        mutable std::size_t singleBatches = 0;
+    };
+
+    TEST_CASE( "singlePrecision_test" )
+    {
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        CHECK( detail::useSinglePrecision( boundingBox, 5 ) );
+        CHECK( detail::useSinglePrecision( Cell2D { Bounds { 0.0, 1e-3 }, Bounds { 0.0, 1e-3 } }, 5 ) );
+        CHECK_FALSE( detail::useSinglePrecision( Cell2D { Bounds { 1000.0, 1000.001 }, Bounds { 0.0, 0.001 } }, 5 ) );
+
+        auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+        auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+        auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+        auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+        auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+        auto geometry = std::make_shared<Difference>( union1, circle2 );
+
+        Cell2D cutCell { Bounds { 0.5, 1.5 }, Bounds { 0.5, 1.5 } };
+        Cell2D insideCell { Bounds { 0.7, 0.9 }, Bounds { -0.2, 0.2 } };
+
+        for( int n : { 2, 5, 9 } )
+        {
+            CHECK( detail::isCutByBoundary<float>( cutCell, *geometry, n, true ) );
+            CHECK_FALSE( detail::isCutByBoundary<float>( insideCell, *geometry, n ) );
+        }
+
+        PartitionOptions options;
+        options.singlePrecision = true;
+
+        detail::QuadTreeNode singleNode( boundingBox, 0 );
+        singleNode.partition( *geometry, 6, options );
+
+        detail::QuadTreeNode doubleNode( boundingBox, 0 );
+        doubleNode.partition( *geometry, 6 );
+
+        CHECK( singleNode.getLeafCells( ) == doubleNode.getLeafCells( ) );
+
+        // Far from the origin, the fine levels fall back to double precision
+        PrecisionCountingCircle farCircle( 1000.3, 0.2, 0.5 );
+        Cell2D farBox { Bounds { 999.0, 1001.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::QuadTreeNode farNode( farBox, 0 );
+        farNode.partition( farCircle, 10, options );
+
+        CHECK( farCircle.singleBatches > 0 );
+        CHECK( farCircle.doubleBatches > farCircle.singleBatches );
+
+        options.singlePrecision = false;
+        detail::QuadTreeNode farDoubleNode( farBox, 0 );
+        farDoubleNode.partition( farCircle, 10, options );
+
+        CHECK( farNode.getLeafCells( ) == farDoubleNode.getLeafCells( ) );
+    }
+
+    TEST_CASE( "parallelPartition_test" )
+    {
+        auto circle = std::make_shared<implicit::Circle>( 0.1, 0.2, 0.9 );
+        auto bar = std::make_shared<implicit::Rectangle>( -0.05, -1.0, 0.05, 1.0 );
+        implicit::Union geometry( circle, bar );
+
+        Cell2D boundingBox { Bounds { -1.0, 1.0 }, Bounds { -1.0, 1.0 } };
+
+        detail::QuadTreeNode serialNode( boundingBox, 0 );
+        serialNode.partition( geometry, 8 );
+
+        PartitionOptions options;
+        options.numberOfThreads = 4;
+        options.taskGranularity = 3;
+
+        detail::QuadTreeNode parallelNode( boundingBox, 0 );
+        parallelNode.partition( geometry, 8, options );
+
+        CHECK( parallelNode.getLeafCells( ) == serialNode.getLeafCells( ) );
+
+        options.cacheSeedPoints = true;
+
+        detail::QuadTreeNode cachedNode( boundingBox, 0 );
+        cachedNode.partition( geometry, 8, options );
+
+        // Cached seeds may be rounded differently, but none falls exactly on this boundary
+        CHECK( cachedNode.getLeafCells( ) == serialNode.getLeafCells( ) );
+    }
+
+    TEST_CASE( "incrementalUpdate_test" )
+    {
+        auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+        auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+        auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+        auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+
+        auto before = std::make_shared<CountingCircle>( 0.0, 0.0, 0.65 );
+        auto after = std::make_shared<CountingCircle>( 0.3, 0.2, 0.4 );
+        Difference oldGeometry( union1, before );
+        Difference newGeometry( union1, after );
+
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        detail::QuadTreeNode freshNode( boundingBox, 0 );
+        freshNode.partition( newGeometry, 8 );
+        std::size_t freshCount = after->count;
+
+        detail::QuadTreeNode node( boundingBox, 0 );
+        node.partition( oldGeometry, 8 );
+
+        after->count = 0;
+        node.update( newGeometry, detail::changedRegion( *before, *after ), 8 );
+
+        CHECK( node.getLeafCells( ) == freshNode.getLeafCells( ) );
+        CHECK( after->count < freshCount );
+
+        // Moving the circle back restores the original tree
+        detail::QuadTreeNode oldNode( boundingBox, 0 );
+        oldNode.partition( oldGeometry, 8 );
+
+        node.update( oldGeometry, detail::changedRegion( *after, *before ), 8 );
+
+        CHECK( node.getLeafCells( ) == oldNode.getLeafCells( ) );
+
+        // A dirty region outside the domain leaves the tree untouched
+        after->count = 0;
+        node.update( newGeometry, Cell2D { Bounds { 5.0, 6.0 }, Bounds { 5.0, 6.0 } }, 8 );
+
+        CHECK( node.getLeafCells( ) == oldNode.getLeafCells( ) );
+        CHECK( after->count == 0 );
+    }
+
+    TEST_CASE( "quadTreeStats_test" )
+    {
+        auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+        auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+        auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+        auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+        auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+        auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+        Difference geometry( union1, circle2 );
+
+        Cell2D boundingBox { Bounds { -1.58, 1.58 }, Bounds { -1.58, 1.58 } };
+
+        QuadTreeStats stats;
+        PartitionOptions options;
+        options.stats = &stats;
+
+        std::string filename = "stats_test.vtk";
+
+        for( auto format : { VtkFormat::Ascii, VtkFormat::Binary } )
+        {
+            stats.reset( );
+            generateQuadTree( geometry, boundingBox, 6, filename, options, format );
+
+#ifdef IMPLICIT_ENABLE_STATS
+            CHECK( stats.cellsPerLevel[0] == 1 );
+            CHECK( stats.cutRatio( 0 ) == 1.0 );
+            CHECK( stats.cellsPerLevel[6] == 0 );
+
+            // Every cut cell replaces one leaf by four
+            std::size_t cutCells = 0;
+            for( const auto& count : stats.cutCellsPerLevel )
+            {
+                cutCells += count;
+            }
+            CHECK( 1 + 3 * cutCells == 856 );
+
+            REQUIRE( stats.geometryNodes.size( ) == 7 );
+            CHECK( stats.geometryNodes[0].type == "Difference" );
+            CHECK( stats.geometryNodes[0].geometry == &geometry );
+            CHECK( stats.geometryNodes[0].pointEvaluations > 0 );
+            CHECK( stats.geometryNodes[6].type == "Circle" );
+            CHECK( stats.geometryNodes[6].depth == 1 );
+
+            CHECK( stats.partitionSeconds > 0.0 );
+            CHECK( stats.writeSeconds > 0.0 );
+#else
+            CHECK( stats.cellsPerLevel[0] == 0 );
+            CHECK( stats.geometryNodes.empty( ) );
+            CHECK( stats.partitionSeconds == 0.0 );
+#endif
+        }
+
+        std::remove( filename.c_str( ) );
+    }
+
+    std::string readHeaderLine( std::ifstream& file, const std::string& keyword )
+    {
+        std::string line;
+        while( std::getline( file, line ) )
+        {
+            if( line.compare( 0, keyword.size( ), keyword ) == 0 )
+            {
+                return line;
+            }
+        }
+        return "";
+    }
+
+    template<typename T>
+    T readBigEndian( std::ifstream& file )
+    {
+        unsigned char bytes[sizeof( T )];
+        file.read( reinterpret_cast<char*>( bytes ), sizeof( T ) );
+
+        std::uint64_t bits = 0;
+        for( auto byte : bytes )
+        {
+            bits = bits << 8 | byte;
+        }
+
+        T value;
+        if constexpr( sizeof( T ) == 8 )
+        {
+            std::memcpy( &value, &bits, sizeof( T ) );
+        }
+        else
+        {
+            auto narrow = static_cast<std::uint32_t>( bits );
+            std::memcpy( &value, &narrow, sizeof( T ) );
+        }
+        return value;
+    }
+
+    // Reads a binary VTK file back and checks that it reproduces the cells and their levels
+    void checkBinaryVtkRoundTrip( const detail::CellsAndLevels& data, const std::string& filename )
+    {
+        std::ifstream file( filename, std::ios::binary );
+        REQUIRE( file.is_open( ) );
+
+        CHECK( readHeaderLine( file, "BINARY" ) == "BINARY" );
+
+        std::string pointsLine = readHeaderLine( file, "POINTS" );
+        REQUIRE( pointsLine.substr( 0, 7 ) == "POINTS " );
+        std::size_t numberOfPoints = std::stoul( pointsLine.substr( 7 ) );
+
+        std::vector<std::array<double, 2>> points( numberOfPoints );
+        for( auto& point : points )
+        {
+            point[0] = readBigEndian<double>( file );
+            point[1] = readBigEndian<double>( file );
+            CHECK( readBigEndian<double>( file ) == 0.0 );
+        }
+
+        // Every corner is written exactly once
+        std::set<std::array<double, 2>> corners;
+        for( const auto& cell : data.first )
+        {
+            corners.insert( { cell[0][0], cell[1][0] } );
+            corners.insert( { cell[0][1], cell[1][0] } );
+            corners.insert( { cell[0][1], cell[1][1] } );
+            corners.insert( { cell[0][0], cell[1][1] } );
+        }
+        CHECK( numberOfPoints == corners.size( ) );
+        CHECK( std::set<std::array<double, 2>>( points.begin( ), points.end( ) ) == corners );
+
+        std::size_t n = data.first.size( );
+        CHECK( readHeaderLine( file, "CELLS" ) == "CELLS " + std::to_string( n ) + " " + std::to_string( 5 * n ) );
+
+        for( const auto& cell : data.first )
+        {
+            REQUIRE( readBigEndian<std::int32_t>( file ) == 4 );
+
+            std::int32_t indices[4];
+            for( auto& index : indices )
+            {
+                index = readBigEndian<std::int32_t>( file );
+                REQUIRE( index >= 0 );
+                REQUIRE( static_cast<std::size_t>( index ) < numberOfPoints );
+            }
+
+            CHECK( points[indices[0]] == std::array<double, 2> { cell[0][0], cell[1][0] } );
+            CHECK( points[indices[1]] == std::array<double, 2> { cell[0][1], cell[1][0] } );
+            CHECK( points[indices[2]] == std::array<double, 2> { cell[0][1], cell[1][1] } );
+            CHECK( points[indices[3]] == std::array<double, 2> { cell[0][0], cell[1][1] } );
+        }
+
+        CHECK( readHeaderLine( file, "CELL_TYPES" ) == "CELL_TYPES " + std::to_string( n ) );
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            CHECK( readBigEndian<std::int32_t>( file ) == 9 );
+        }
+
+        CHECK( readHeaderLine( file, "CELL_DATA" ) == "CELL_DATA " + std::to_string( n ) );
+        CHECK( readHeaderLine( file, "LOOKUP_TABLE" ) == "LOOKUP_TABLE default" );
+        for( auto level : data.second )
+        {
+            CHECK( readBigEndian<std::int32_t>( file ) == static_cast<std::int32_t>( level ) );
+        }
+    }
+
+    TEST_CASE( "writeCellsToBinaryVtkFile_test" )
+    {
+        // Two by two grid of cells plus one refined quadrant
+        Cell2D root { Bounds { 0.0, 1.0 }, Bounds { 0.0, 1.0 } };
+        auto quadrants = detail::subdivideCell( root );
+        auto refined = detail::subdivideCell( quadrants[3] );
+
+        detail::CellsAndLevels data;
+        for( int i = 0; i < 3; ++i )
+        {
+            data.first.push_back( quadrants[i] );
+            data.second.push_back( 1 );
+        }
+        for( const auto& cell : refined )
+        {
+            data.first.push_back( cell );
+            data.second.push_back( 2 );
+        }
+
+        std::string filename = "binary_writer_test.vtk";
+        detail::writeCellsToBinaryVtkFile( data, filename );
+
+        {
+            std::ifstream file( filename, std::ios::binary );
+
+            // 9 corners of the coarse grid plus 5 new corners of the refined quadrant
+            CHECK( readHeaderLine( file, "POINTS" ) == "POINTS 14 double" );
+        }
+
+        checkBinaryVtkRoundTrip( data, filename );
+
+        // Refining one corner down to level 40, whose lattice does not fit into a single 64-bit key
+        detail::CellsAndLevels deepData;
+        Cell2D cell = root;
+        for( unsigned int level = 1; level <= 40; ++level )
+        {
+            auto children = detail::subdivideCell( cell );
+            for( int i = 1; i < 4; ++i )
+            {
+                deepData.first.push_back( children[i] );
+                deepData.second.push_back( level );
+            }
+            cell = children[0];
+
+            if( level == 40 )
+            {
+                deepData.first.push_back( cell );
+                deepData.second.push_back( level );
+            }
+        }
+
+        detail::writeCellsToBinaryVtkFile( deepData, filename );
+        checkBinaryVtkRoundTrip( deepData, filename );
+
+        deepData.second.back( ) = 63;
+        CHECK_THROWS_AS( detail::writeCellsToBinaryVtkFile( deepData, filename ), std::invalid_argument );
+
+        std::remove( filename.c_str( ) );
+    }
+
     TEST_CASE( "quadtree_test" )
     {
         auto circle1 = std::make_shared<implicit::Circle>(0.0, 0.0, 1.06);
@@ -81,5 +670,23 @@ namespace implicit
         CHECK(leaves.first.size() == 856);
         CHECK(leaves.second.size() == 856);
 
+        // Interval classification never leaves a cut cell above the maximum depth
+        PartitionOptions options;
+        options.cutCriterion = CutCriterion::Interval;
+
+        detail::QuadTreeNode intervalNode(boundingBox, 0);
+        intervalNode.partition(*geometry, 6, options);
+
+        auto intervalLeaves = intervalNode.getLeafCells();
+
+        CHECK(intervalLeaves.first.size() >= 856);
+        for (size_t i = 0; i < intervalLeaves.first.size(); ++i)
+        {
+            if (intervalLeaves.second[i] < 6)
+            {
+                CHECK(geometry->classify(intervalLeaves.first[i]) != CellClassification::Cut);
+            }
+        }
+
     }
 } // namespace implciit
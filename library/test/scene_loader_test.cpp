@@ -0,0 +1,146 @@
+#include "catch.hpp"
+#include "scene_loader.h"
+#include "Circle.hpp"
+#include "Rectangle.hpp"
+#include "Intersection.hpp"
+#include "Union.hpp"
+#include "Difference.hpp"
+#include "IndexedUnion.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace implicit
+{
+    namespace
+    {
+        const char* demoScene = "# (circle and rectangle + bar) minus inner circle\n"
+                                "circle 0 0 1.06\n"
+                                "rectangle -1 -1 1 1   intersection\n"
+                                "rectangle -0.1 -1.5 0.1 1.5\r\n"
+                                "union # comment after a keyword\n"
+                                "circle 0.0 0.0 6.5e-1\n"
+                                "difference\n";
+
+        ImplicitGeometryPtr demoGeometry( )
+        {
+            auto circle1 = std::make_shared<Circle>( 0.0, 0.0, 1.06 );
+            auto rectangle1 = std::make_shared<Rectangle>( -1.0, -1.0, 1.0, 1.0 );
+            auto intersection = std::make_shared<Intersection>( circle1, rectangle1 );
+            auto rectangle2 = std::make_shared<Rectangle>( -0.1, -1.5, 0.1, 1.5 );
+            auto union1 = std::make_shared<Union>( intersection, rectangle2 );
+            auto circle2 = std::make_shared<Circle>( 0.0, 0.0, 0.65 );
+            return std::make_shared<Difference>( union1, circle2 );
+        }
+
+        void checkSameGeometry( const AbsImplicitGeometry& geometry, const AbsImplicitGeometry& reference )
+        {
+            for( int i = 0; i <= 40; ++i )
+            {
+                for( int j = 0; j <= 40; ++j )
+                {
+                    double x = -1.6 + 0.08 * i;
+                    double y = -1.6 + 0.08 * j;
+                    CHECK( geometry.inside( x, y ) == reference.inside( x, y ) );
+                    CHECK( geometry.distance( x, y ) == Approx( reference.distance( x, y ) ) );
+                }
+            }
+
+            CHECK( geometry.boundingBox( ) == reference.boundingBox( ) );
+        }
+    }
+
+    TEST_CASE( "parseScene_test" )
+    {
+        auto reference = demoGeometry( );
+        auto scene = parseScene( demoScene );
+
+        checkSameGeometry( *scene, *reference );
+        CHECK( scene->instructions( ).size( ) == 7 );
+        CHECK( scene->parameters( ).size( ) == 14 );
+        CHECK( scene->stackDepth( ) == 2 );
+
+        // A long chain is parsed into a single program
+        std::string chain = "circle 0 0 0.5\n";
+        for( int i = 1; i < 10000; ++i )
+        {
+            chain += "circle " + std::to_string( 0.001 * i ) + " 0 0.5 union\n";
+        }
+
+        auto chainScene = parseScene( chain );
+        CHECK( chainScene->instructions( ).size( ) == 19999 );
+        CHECK( chainScene->inside( 10.4, 0.0 ) );
+        CHECK( !chainScene->inside( 10.6, 0.0 ) );
+        CHECK( chainScene->boundingBox( )[0][1] == Approx( 10.499 ) );
+    }
+
+    TEST_CASE( "parseSceneErrors_test" )
+    {
+        CHECK_THROWS_WITH( parseScene( "circle 0 0 1\nsphere 0 0 1\n" ), Catch::Contains( "line 2" ) &&
+                                                                          Catch::Contains( "sphere" ) );
+        CHECK_THROWS_WITH( parseScene( "circle 0 0 1\n\nunion\n" ), Catch::Contains( "line 3" ) );
+        CHECK_THROWS_WITH( parseScene( "rectangle 0 0 1 x\n" ), Catch::Contains( "expected a number" ) );
+        CHECK_THROWS_WITH( parseScene( "circle 0 0" ), Catch::Contains( "unexpected end" ) );
+        CHECK_THROWS_WITH( parseScene( "circle 0 0 1 circle 1 1 1\n" ), Catch::Contains( "uncombined" ) );
+        CHECK_THROWS_WITH( parseScene( "# nothing\n" ), Catch::Contains( "empty" ) );
+
+        std::string deep;
+        for( std::size_t i = 0; i <= CompiledGeometry::maxStackDepth; ++i )
+        {
+            deep += "circle 0 0 1\n";
+        }
+
+        CHECK_THROWS_AS( parseScene( deep ), std::runtime_error );
+    }
+
+    TEST_CASE( "binaryScene_test" )
+    {
+        auto reference = demoGeometry( );
+        CompiledGeometry compiled( reference );
+
+        std::string binaryFilename = "scene_loader_test.bin";
+        writeBinaryScene( compiled, binaryFilename );
+
+        auto scene = loadScene( binaryFilename );
+
+        CHECK( scene->instructions( ) == compiled.instructions( ) );
+        CHECK( scene->parameters( ) == compiled.parameters( ) );
+        CHECK( scene->stackDepth( ) == compiled.stackDepth( ) );
+        checkSameGeometry( *scene, *reference );
+
+        // Text scenes are detected by the missing magic bytes
+        std::string textFilename = "scene_loader_test.scene";
+        {
+            std::ofstream file( textFilename );
+            file << demoScene;
+        }
+
+        checkSameGeometry( *loadScene( textFilename ), *reference );
+
+        // Truncated binary files are rejected
+        {
+            std::ifstream input( binaryFilename, std::ios::binary );
+            std::string content( ( std::istreambuf_iterator<char>( input ) ), std::istreambuf_iterator<char>( ) );
+
+            std::ofstream output( binaryFilename, std::ios::binary );
+            output.write( content.data( ), static_cast<std::streamsize>( content.size( ) - 8 ) );
+        }
+
+        CHECK_THROWS_WITH( loadScene( binaryFilename ), Catch::Contains( "truncated" ) );
+        CHECK_THROWS_AS( loadScene( "scene_loader_test.missing" ), std::runtime_error );
+
+        std::remove( binaryFilename.c_str( ) );
+        std::remove( textFilename.c_str( ) );
+
+        // Programs with external geometries cannot be stored
+        CompiledGeometry external( std::make_shared<IndexedUnion>( std::vector<ImplicitGeometryPtr> { reference } ) );
+        CHECK_THROWS_AS( writeBinaryScene( external, binaryFilename ), std::invalid_argument );
+
+        CHECK_THROWS_AS( CompiledGeometry( { CompiledGeometry::OpCode::External }, { } ), std::invalid_argument );
+        CHECK_THROWS_AS( CompiledGeometry( { CompiledGeometry::OpCode::Circle }, { 0.0, 0.0 } ), std::invalid_argument );
+        CHECK_THROWS_AS( CompiledGeometry( { CompiledGeometry::OpCode::Circle, CompiledGeometry::OpCode::Union },
+                                           { 0.0, 0.0, 1.0 } ), std::invalid_argument );
+    }
+
+} // namespace implicit
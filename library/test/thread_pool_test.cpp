@@ -0,0 +1,67 @@
+#include "catch.hpp"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace implicit
+{
+
+long long parallelSum( detail::ThreadPool& pool, long long begin, long long end )
+{
+    if( end - begin <= 16 )
+    {
+        long long sum = 0;
+        for( long long i = begin; i < end; ++i )
+        {
+            sum += i;
+        }
+        return sum;
+    }
+
+    long long middle = ( begin + end ) / 2;
+    long long left = 0, right = 0;
+
+    detail::TaskGroup group;
+    pool.spawn( group, [&]( ) { left = parallelSum( pool, begin, middle ); } );
+    pool.spawn( group, [&]( ) { right = parallelSum( pool, middle, end ); } );
+    pool.wait( group );
+
+    return left + right;
+}
+
+TEST_CASE( "ThreadPool_test" )
+{
+    detail::ThreadPool pool( 4 );
+
+    CHECK( pool.size( ) == 4 );
+    CHECK( parallelSum( pool, 0, 100000 ) == 4999950000LL );
+
+    // Exceptions are forwarded to the waiting thread
+    detail::TaskGroup group;
+    pool.spawn( group, [ ]( ) { throw std::runtime_error( "task failed" ); } );
+    CHECK_THROWS_AS( pool.wait( group ), std::runtime_error );
+
+    // The waiting thread sleeps once the deques are empty and is woken by the last task
+    for( int round = 0; round < 20; ++round )
+    {
+        std::atomic<int> finished { 0 };
+
+        detail::TaskGroup sleepers;
+        for( int i = 0; i < 8; ++i )
+        {
+            pool.spawn( sleepers, [&finished, i]( )
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( 100 * i ) );
+                finished.fetch_add( 1 );
+            } );
+        }
+        pool.wait( sleepers );
+
+        CHECK( finished.load( ) == 8 );
+    }
+}
+
+} // implicit